@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ast_c.h"
+
+int show_stats = 0;
+
+// Lo que hace el código propio de una función, sin contar lo que hacen las que llama.
+typedef struct {
+    FunctionEntry* f;
+    Effect effect;
+    const char* reason;
+    int may_fail;
+} EffectScan;
+
+static void raise_effect(EffectScan* scan, Effect effect, const char* reason) {
+    if (effect <= scan->effect) return;
+    scan->effect = effect;
+    scan->reason = reason;
+}
+
+static void add_callee(FunctionEntry* f, FunctionEntry* callee) {
+    for (int i = 0; i < f->callee_count; ++i)
+        if (f->callees[i] == callee) return;
+    f->callees = realloc(f->callees, (f->callee_count + 1) * sizeof(FunctionEntry*));
+    f->callees[f->callee_count++] = callee;
+}
+
+// Las cadenas viven en búferes compartidos y en la región del runtime: una función que solo
+// las usa por dentro lee esa memoria y libera lo que escribe en ella antes de volver.
+static int uses_chain(ASTNode* node) {
+    switch (node->type) {
+        case NODE_STRING:
+            return 1;
+        case NODE_ID:
+        case NODE_BINOP:
+        case NODE_FUNCCALL:
+            return node->data_type == NODE_STRING;
+        case NODE_DECL:
+            return node->decl.decl_type == NODE_STRING ||
+                   (node->decl.is_map && node->decl.key_type == NODE_STRING);
+        default:
+            return 0;
+    }
+}
+
+static void scan_node(ASTNode* node, EffectScan* scan) {
+    if (!node) return;
+    if (uses_chain(node)) raise_effect(scan, EFFECT_READ_ONLY, "cadenas");
+    switch (node->type) {
+        case NODE_BINOP:
+            // Una división sin comprobar puede terminar el programa con un error.
+            if ((strcmp(node->binop.op, "/") == 0 || strcmp(node->binop.op, "%") == 0) &&
+                !node->binop.nonzero_divisor)
+                scan->may_fail = 1;
+            scan_node(node->binop.left, scan);
+            scan_node(node->binop.right, scan);
+            break;
+        case NODE_ASSIGN:
+            scan_node(node->assign.value, scan);
+            break;
+        case NODE_PRINT:
+            raise_effect(scan, EFFECT_WRITES, "print");
+            scan_node(node->print.value, scan);
+            break;
+        case NODE_READ:
+            raise_effect(scan, EFFECT_WRITES, "write");
+            break;
+        case NODE_SYNC:
+            raise_effect(scan, EFFECT_WRITES, "tareas");
+            break;
+        case NODE_DECL:
+            if (node->decl.is_channel) raise_effect(scan, EFFECT_WRITES, "channels");
+            break;
+        case NODE_IF:
+            scan_node(node->ifstmt.cond, scan);
+            scan_node(node->ifstmt.then_branch, scan);
+            scan_node(node->ifstmt.else_branch, scan);
+            break;
+        case NODE_WHILE:
+            scan_node(node->whilestmt.cond, scan);
+            scan_node(node->whilestmt.body, scan);
+            break;
+        case NODE_FOR:
+            if (node->forstmt.parallel) raise_effect(scan, EFFECT_WRITES, "tareas");
+            scan_node(node->forstmt.init, scan);
+            scan_node(node->forstmt.cond, scan);
+            scan_node(node->forstmt.update, scan);
+            scan_node(node->forstmt.body, scan);
+            break;
+        case NODE_FOR_IN:
+            scan_node(node->forin.call, scan);
+            scan_node(node->forin.body, scan);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                scan_node(node->block.stmts[i], scan);
+            break;
+        case NODE_YIELD:
+            scan_node(node->yieldstmt.value, scan);
+            break;
+        case NODE_RETURN:
+            scan_node(node->returnstmt.value, scan);
+            break;
+        case NODE_FUNCCALL: {
+            const Builtin* builtin = get_builtin(node->funccall.id);
+            if (node->funccall.spawn) {
+                raise_effect(scan, EFFECT_WRITES, "tareas");
+            } else if (builtin && node->funccall.args[0]->data_type == NODE_CHANNEL) {
+                raise_effect(scan, EFFECT_WRITES, "channels");
+            } else if (builtin && node->funccall.args[0]->data_type == NODE_VECTOR) {
+                // pop, fill, min y max terminan el programa si el vector no alcanza.
+                static const char* const failing[] = { "pop", "fill", "min", "max" };
+                for (size_t i = 0; i < sizeof(failing) / sizeof(failing[0]); ++i)
+                    if (strcmp(node->funccall.id, failing[i]) == 0) scan->may_fail = 1;
+            }
+            if (!builtin) {
+                FunctionEntry* callee = get_function_entry(node->funccall.id);
+                if (callee) add_callee(scan->f, callee);
+            }
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                scan_node(node->funccall.args[i], scan);
+            break;
+        }
+        case NODE_INLINED:
+            // El cuerpo expandido es código propio de la función que lo contiene.
+            scan_node(node->inlined.body, scan);
+            scan_node(node->inlined.result, scan);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            if (node->index.index && !node->index.in_bounds) scan->may_fail = 1;
+            scan_node(node->index.index, scan);
+            scan_node(node->index.value, scan);
+            break;
+        default:
+            break;
+    }
+}
+
+static void scan_function(FunctionEntry* f) {
+    EffectScan scan = { f, EFFECT_PURE, NULL, 0 };
+    f->callees = NULL;
+    f->callee_count = 0;
+    // Una chain se pasa con su dueño: la función la libera al salir y escribe así en el
+    // búfer de quien llama. Lo mismo pasa con la que devuelve.
+    for (int i = 0; i < f->param_count; ++i) {
+        if (f->params[i]->decl.is_channel) raise_effect(&scan, EFFECT_WRITES, "channels");
+        else if (f->params[i]->decl.decl_type == NODE_STRING)
+            raise_effect(&scan, EFFECT_WRITES, "recibe chains");
+    }
+    if (f->return_expr && f->return_expr->data_type == NODE_STRING)
+        raise_effect(&scan, EFFECT_WRITES, "devuelve una chain");
+    scan_node(f->body, &scan);
+    scan_node(f->return_expr, &scan);
+    f->effect = scan.effect;
+    f->effect_reason = scan.reason;
+    f->may_fail = scan.may_fail;
+}
+
+// Propaga por el grafo de llamadas hasta un punto fijo: una función tiene al menos los
+// efectos de las que llama y puede fallar si alguna de ellas puede.
+static void propagate_effects(void) {
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (FunctionEntry* f = function_table; f; f = f->next) {
+            for (int i = 0; i < f->callee_count; ++i) {
+                FunctionEntry* callee = f->callees[i];
+                if (callee->effect > f->effect) {
+                    char* reason = malloc(strlen(callee->id) + 9);
+                    sprintf(reason, "llama a %s", callee->id);
+                    f->effect = callee->effect;
+                    f->effect_reason = reason;
+                    changed = 1;
+                }
+                if (callee->may_fail && !f->may_fail) {
+                    f->may_fail = 1;
+                    changed = 1;
+                }
+            }
+        }
+    }
+}
+
+const char* effect_attribute(FunctionEntry* f) {
+    if (f->generator || f->may_fail) return NULL;
+    if (f->effect == EFFECT_PURE) return "const";
+    if (f->effect == EFFECT_READ_ONLY) return "pure";
+    return NULL;
+}
+
+static void print_effects(FunctionEntry* f) {
+    // La tabla guarda las funciones de la última a la primera.
+    if (!f) return;
+    print_effects(f->next);
+    static const char* const names[] = { "pura", "solo lectura", "con efectos" };
+    const char* attribute = effect_attribute(f);
+    printf("Efectos: %s %s", f->id, names[f->effect]);
+    if (f->effect != EFFECT_PURE) printf(" (%s)", f->effect_reason);
+    if (f->may_fail) printf(", puede fallar");
+    if (f->generator) printf(", generador");
+    if (attribute) printf(" [%s]", attribute);
+    if (f->callee_count > 0) {
+        printf("; llama a");
+        for (int i = 0; i < f->callee_count; ++i)
+            printf("%s %s", i > 0 ? "," : "", f->callees[i]->id);
+    }
+    printf("\n");
+}
+
+void analyze_effects(void) {
+    for (FunctionEntry* f = function_table; f; f = f->next)
+        scan_function(f);
+    propagate_effects();
+    if (!show_stats) return;
+
+    int counts[3] = { 0, 0, 0 };
+    for (FunctionEntry* f = function_table; f; f = f->next)
+        counts[f->effect]++;
+    print_effects(function_table);
+    printf("Efectos: %d pura(s), %d de solo lectura, %d con efectos\n",
+           counts[EFFECT_PURE], counts[EFFECT_READ_ONLY], counts[EFFECT_WRITES]);
+}
@@ -0,0 +1,815 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ast_c.h"
+
+#define MAX_REDUCTIONS 8
+
+// Conjunto de nombres de variables.
+typedef struct {
+    const char** ids;
+    int count;
+} IdSet;
+
+// Estado de la revisión de un parallel for. Las variables declaradas dentro del cuerpo
+// son locales de cada iteración; las de afuera se capturan y solo se pueden leer (los
+// arreglos se comparten y sí se pueden escribir, cada iteración en sus posiciones), salvo
+// los acumuladores de las reducciones. En un ciclo que el compilador eligió por su cuenta
+// (automatic) nada de eso es un error: el ciclo queda secuencial.
+typedef struct {
+    ASTNode* loop;
+    const char* var;
+    int automatic;
+    int failed;
+    IdSet locals;
+    IdSet captured;
+    IdSet accumulators;
+} ParallelLoop;
+
+// Funciones que usan print, write o cadenas, directamente o a través de otra llamada.
+static IdSet unsafe_functions = { NULL, 0 };
+
+static int id_set_has(IdSet* set, const char* id) {
+    for (int i = 0; i < set->count; ++i)
+        if (strcmp(set->ids[i], id) == 0) return 1;
+    return 0;
+}
+
+static void id_set_add(IdSet* set, const char* id) {
+    if (id_set_has(set, id)) return;
+    set->ids = realloc(set->ids, sizeof(char*) * (set->count + 1));
+    set->ids[set->count++] = id;
+}
+
+// Llama a visit con cada nodo del subárbol, en preorden.
+static void walk(ASTNode* node, void (*visit)(ASTNode*, void*), void* data) {
+    if (!node) return;
+    visit(node, data);
+    switch (node->type) {
+        case NODE_BINOP:
+            walk(node->binop.left, visit, data);
+            walk(node->binop.right, visit, data);
+            break;
+        case NODE_ASSIGN:
+            walk(node->assign.value, visit, data);
+            break;
+        case NODE_PRINT:
+            walk(node->print.value, visit, data);
+            break;
+        case NODE_IF:
+            walk(node->ifstmt.cond, visit, data);
+            walk(node->ifstmt.then_branch, visit, data);
+            walk(node->ifstmt.else_branch, visit, data);
+            break;
+        case NODE_WHILE:
+            walk(node->whilestmt.cond, visit, data);
+            walk(node->whilestmt.body, visit, data);
+            break;
+        case NODE_FOR:
+            walk(node->forstmt.init, visit, data);
+            walk(node->forstmt.cond, visit, data);
+            walk(node->forstmt.update, visit, data);
+            walk(node->forstmt.body, visit, data);
+            break;
+        case NODE_FOR_IN:
+            walk(node->forin.call, visit, data);
+            walk(node->forin.body, visit, data);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                walk(node->block.stmts[i], visit, data);
+            break;
+        case NODE_YIELD:
+            walk(node->yieldstmt.value, visit, data);
+            break;
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                walk(node->funccall.args[i], visit, data);
+            break;
+        case NODE_RETURN:
+            walk(node->returnstmt.value, visit, data);
+            break;
+        case NODE_INLINED:
+            walk(node->inlined.body, visit, data);
+            walk(node->inlined.result, visit, data);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            walk(node->index.index, visit, data);
+            walk(node->index.value, visit, data);
+            break;
+        default:
+            break;
+    }
+}
+
+// Lo que no puede correr en varios hilos a la vez: el búfer de salida, la entrada y las
+// cadenas (contadores de referencias y región sin sincronizar).
+static const char* thread_unsafe(ASTNode* node) {
+    if (node->type == NODE_PRINT) return "print no se puede usar dentro del ciclo.";
+    if (node->type == NODE_READ) return "write no se puede usar dentro del ciclo.";
+    if (node->data_type == NODE_STRING ||
+        (node->type == NODE_DECL && node->decl.decl_type == NODE_STRING))
+        return "no se admiten cadenas dentro del ciclo.";
+    return NULL;
+}
+
+typedef struct {
+    int unsafe;
+} SafetyScan;
+
+static void scan_function_node(ASTNode* node, void* data) {
+    SafetyScan* scan = data;
+    if (thread_unsafe(node)) scan->unsafe = 1;
+    if (node->type == NODE_FUNCCALL && id_set_has(&unsafe_functions, node->funccall.id))
+        scan->unsafe = 1;
+}
+
+// Una función solo ve sus parámetros y locales, que son de cada llamada: es segura si no
+// usa nada de lo que thread_unsafe rechaza ni llama a una función que lo use. Se itera
+// hasta que el conjunto de inseguras no cambia, así la recursión mutua queda cubierta.
+static void compute_unsafe_functions(void) {
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (FunctionEntry* f = function_table; f; f = f->next) {
+            if (id_set_has(&unsafe_functions, f->id)) continue;
+            SafetyScan scan = { 0 };
+            for (int i = 0; i < f->param_count; ++i)
+                if (f->params[i]->decl.decl_type == NODE_STRING) scan.unsafe = 1;
+            walk(f->body, scan_function_node, &scan);
+            walk(f->return_expr, scan_function_node, &scan);
+            if (scan.unsafe) {
+                id_set_add(&unsafe_functions, f->id);
+                changed = 1;
+            }
+        }
+    }
+}
+
+typedef struct {
+    const char* id;
+    int count;
+} UseCount;
+
+static void count_use(ASTNode* node, void* data) {
+    UseCount* u = data;
+    const char* id = NULL;
+    switch (node->type) {
+        case NODE_ID: id = node->sval; break;
+        case NODE_ASSIGN: id = node->assign.id; break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN: id = node->index.id; break;
+        case NODE_FOR_IN:
+            if (node->forin.map && strcmp(node->forin.map, u->id) == 0) u->count++;
+            id = node->forin.key;
+            break;
+        case NODE_READ:
+            for (int i = 0; i < node->read.id_count; ++i)
+                if (strcmp(node->read.ids[i], u->id) == 0) u->count++;
+            break;
+        default: break;
+    }
+    if (id && strcmp(id, u->id) == 0) u->count++;
+}
+
+// Apariciones de la variable id en el subárbol, como lectura o como escritura.
+static int count_uses(ASTNode* node, const char* id) {
+    UseCount u = { id, 0 };
+    walk(node, count_use, &u);
+    return u.count;
+}
+
+static void find_call(ASTNode* node, void* data) {
+    if (node->type == NODE_FUNCCALL || node->type == NODE_INLINED) *(int*)data = 1;
+}
+
+static int has_calls(ASTNode* node) {
+    int found = 0;
+    walk(node, find_call, &found);
+    return found;
+}
+
+static void find_heavy(ASTNode* node, void* data) {
+    if ((node->type == NODE_FUNCCALL && !get_builtin(node->funccall.id)) ||
+        node->type == NODE_INLINED || node->type == NODE_WHILE || node->type == NODE_FOR)
+        *(int*)data = 1;
+}
+
+// Solo vale la pena repartir entre hilos un cuerpo que llama a funciones o tiene ciclos.
+static int is_heavy(ASTNode* node) {
+    int found = 0;
+    walk(node, find_heavy, &found);
+    return found;
+}
+
+static int is_id(ASTNode* node, const char* id) {
+    return node && node->type == NODE_ID && strcmp(node->sval, id) == 0;
+}
+
+// i = i + 1
+static int is_increment(ASTNode* node, const char* var) {
+    return node && node->type == NODE_ASSIGN && strcmp(node->assign.id, var) == 0 &&
+           node->assign.value->type == NODE_BINOP && strcmp(node->assign.value->binop.op, "+") == 0 &&
+           is_id(node->assign.value->binop.left, var) &&
+           node->assign.value->binop.right->type == NODE_INT && node->assign.value->binop.right->ival == 1;
+}
+
+// i < b o i <= b
+static int is_counted_cond(ASTNode* cond, const char* var) {
+    return cond && cond->type == NODE_BINOP &&
+           (strcmp(cond->binop.op, "<") == 0 || strcmp(cond->binop.op, "<=") == 0) &&
+           is_id(cond->binop.left, var);
+}
+
+// (i = a; i < b; i = i + 1) con i integer: el tramo [a, b) se conoce antes de empezar.
+int is_counted_loop(ASTNode* init, ASTNode* cond, ASTNode* update) {
+    if (!init || init->type != NODE_ASSIGN || init->data_type != NODE_INT) return 0;
+    return is_counted_cond(cond, init->assign.id) && is_increment(update, init->assign.id);
+}
+
+static int same_expr(ASTNode* a, ASTNode* b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type) return 0;
+    switch (a->type) {
+        case NODE_INT: return a->ival == b->ival;
+        case NODE_ID: return strcmp(a->sval, b->sval) == 0;
+        case NODE_BINOP:
+            return strcmp(a->binop.op, b->binop.op) == 0 &&
+                   same_expr(a->binop.left, b->binop.left) && same_expr(a->binop.right, b->binop.right);
+        case NODE_INDEX:
+            return strcmp(a->index.id, b->index.id) == 0 &&
+                   (a->index.field ? b->index.field && strcmp(a->index.field, b->index.field) == 0
+                                   : !b->index.field) &&
+                   same_expr(a->index.index, b->index.index);
+        case NODE_FUNCCALL:
+            if (strcmp(a->funccall.id, b->funccall.id) != 0 || a->funccall.arg_count != b->funccall.arg_count)
+                return 0;
+            for (int i = 0; i < a->funccall.arg_count; ++i)
+                if (!same_expr(a->funccall.args[i], b->funccall.args[i])) return 0;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// acc está en value bajo una cadena de operaciones op: acc op e1 op e2, e1 op acc, ...
+static int under_chain(ASTNode* value, const char* acc, const char* op) {
+    if (is_id(value, acc)) return 1;
+    if (value->type != NODE_BINOP || strcmp(value->binop.op, op) != 0) return 0;
+    return under_chain(value->binop.left, acc, op) || under_chain(value->binop.right, acc, op);
+}
+
+static int is_int_scalar(const char* id) {
+    Symbol* s = get_symbol(id);
+    return s && s->type == NODE_INT && !s->array_size && !s->is_vector && !s->is_map && !s->record;
+}
+
+// acc = acc + e, acc = e * acc, ... o if (e < acc) acc = e; (y sus variantes de mínimo y
+// máximo). El acumulador no puede aparecer en ningún otro lugar de la sentencia.
+static int match_reduction(ASTNode* stmt, Reduction* r) {
+    if (stmt->type == NODE_ASSIGN) {
+        const char* acc = stmt->assign.id;
+        ASTNode* value = stmt->assign.value;
+        if (!is_int_scalar(acc) || value->type != NODE_BINOP || count_uses(value, acc) != 1) return 0;
+        const char* op = value->binop.op;
+        if ((strcmp(op, "+") != 0 && strcmp(op, "*") != 0) || !under_chain(value, acc, op)) return 0;
+        r->acc = stmt->assign.id;
+        r->op = op[0];
+        r->expr = value;
+        return 1;
+    }
+    if (stmt->type != NODE_IF || stmt->ifstmt.else_branch) return 0;
+    ASTNode* then = stmt->ifstmt.then_branch;
+    if (then->type == NODE_BLOCK && then->block.stmt_count == 1) then = then->block.stmts[0];
+    ASTNode* cond = stmt->ifstmt.cond;
+    if (then->type != NODE_ASSIGN || cond->type != NODE_BINOP) return 0;
+    const char* acc = then->assign.id;
+    const char* op = cond->binop.op;
+    int less = strcmp(op, "<") == 0 || strcmp(op, "<=") == 0;
+    int greater = strcmp(op, ">") == 0 || strcmp(op, ">=") == 0;
+    if (!is_int_scalar(acc) || (!less && !greater)) return 0;
+    ASTNode* value = then->assign.value;
+    int acc_right = is_id(cond->binop.right, acc) && same_expr(cond->binop.left, value);
+    int acc_left = is_id(cond->binop.left, acc) && same_expr(cond->binop.right, value);
+    if ((!acc_right && !acc_left) || count_uses(value, acc) != 0) return 0;
+    r->acc = then->assign.id;
+    // e < acc guarda el menor; acc < e, el mayor.
+    r->op = (less == acc_right) ? '<' : '>';
+    r->expr = value;
+    return 1;
+}
+
+static void reject(ParallelLoop* p, const char* message, const char* id) {
+    if (p->automatic) {
+        p->failed = 1;
+        return;
+    }
+    fprintf(stderr, "Error en la línea %d: parallel for: ", p->loop->line);
+    fprintf(stderr, message, id);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+// Las funciones integradas que modifican el contenedor de su primer argumento.
+static int mutates_container(const char* id) {
+    return strcmp(id, "push") == 0 || strcmp(id, "pop") == 0 || strcmp(id, "fill") == 0 ||
+           strcmp(id, "copy") == 0 || strcmp(id, "put") == 0;
+}
+
+static void collect_local(ASTNode* node, void* data) {
+    ParallelLoop* p = data;
+    if (node->type == NODE_DECL) id_set_add(&p->locals, node->decl.id);
+}
+
+static void use_variable(ParallelLoop* p, const char* id) {
+    if (strcmp(id, p->var) == 0 || id_set_has(&p->locals, id) || id_set_has(&p->accumulators, id)) return;
+    id_set_add(&p->captured, id);
+}
+
+static void write_variable(ParallelLoop* p, const char* id) {
+    if (strcmp(id, p->var) == 0)
+        reject(p, "el cuerpo no puede modificar la variable del ciclo '%s'.", id);
+    else if (!id_set_has(&p->locals, id) && !id_set_has(&p->accumulators, id))
+        reject(p, "el cuerpo escribe '%s', declarada fuera del ciclo; "
+                  "declárela dentro del cuerpo para que cada iteración tenga la suya.", id);
+}
+
+static void check_body_node(ASTNode* node, void* data) {
+    ParallelLoop* p = data;
+    const char* unsafe = thread_unsafe(node);
+    if (unsafe) reject(p, unsafe, NULL);
+    if (node->type == NODE_SYNC || (node->type == NODE_FUNCCALL && node->funccall.spawn))
+        reject(p, "spawn y sync no se pueden usar dentro del ciclo; llame a una función que los use.", NULL);
+    if (node->data_type == NODE_CHANNEL || (node->type == NODE_DECL && node->decl.is_channel))
+        reject(p, "los channels no se pueden usar dentro del ciclo.", NULL);
+    switch (node->type) {
+        case NODE_ID:
+            use_variable(p, node->sval);
+            break;
+        case NODE_ASSIGN:
+            write_variable(p, node->assign.id);
+            break;
+        case NODE_INDEX:
+            use_variable(p, node->index.id);
+            break;
+        case NODE_INDEX_ASSIGN:
+            // El campo de un record suelto es un escalar más. Un arreglo de afuera solo se
+            // escribe en un parallel for explícito: ahí el programador garantiza que cada
+            // iteración usa sus posiciones.
+            if (!node->index.index || p->automatic) write_variable(p, node->index.id);
+            use_variable(p, node->index.id);
+            break;
+        case NODE_FOR_IN:
+            write_variable(p, node->forin.key);
+            if (node->forin.map) use_variable(p, node->forin.map);
+            break;
+        case NODE_FUNCCALL:
+            if (!get_builtin(node->funccall.id)) {
+                if (id_set_has(&unsafe_functions, node->funccall.id))
+                    reject(p, "la función '%s' usa print, write o cadenas.", node->funccall.id);
+            } else if (mutates_container(node->funccall.id)) {
+                const char* target = node->funccall.args[0]->sval;
+                if (!id_set_has(&p->locals, target))
+                    reject(p, "el cuerpo modifica '%s', declarado fuera del ciclo.", target);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Busca reducciones entre las sentencias del nivel superior del cuerpo. Un acumulador no
+// puede aparecer en ninguna otra parte del cuerpo.
+static int find_reductions(ASTNode* body, const char* var, Reduction* out) {
+    int count = 0;
+    ASTNode** stmts = body->type == NODE_BLOCK ? body->block.stmts : &body;
+    int n = body->type == NODE_BLOCK ? body->block.stmt_count : 1;
+    for (int i = 0; i < n && count < MAX_REDUCTIONS; ++i) {
+        Reduction r;
+        if (!stmts[i] || !match_reduction(stmts[i], &r) || strcmp(r.acc, var) == 0) continue;
+        int in_stmt = count_uses(stmts[i], r.acc);
+        int repeated = 0;
+        for (int j = 0; j < count; ++j)
+            if (strcmp(out[j].acc, r.acc) == 0) repeated = 1;
+        if (repeated || count_uses(body, r.acc) != in_stmt) continue;
+        out[count++] = r;
+    }
+    return count;
+}
+
+// Revisa el cuerpo y, si se puede repartir, anota capturas y reducciones en el ciclo.
+static int check_loop(ASTNode* loop, const char* var, int automatic, Reduction* reductions, int count) {
+    ParallelLoop p = { loop, var, automatic, 0, { NULL, 0 }, { NULL, 0 }, { NULL, 0 } };
+    for (int i = 0; i < count; ++i) id_set_add(&p.accumulators, reductions[i].acc);
+    walk(loop->forstmt.body, collect_local, &p);
+    for (int i = 0; i < count; ++i)
+        if (id_set_has(&p.locals, reductions[i].acc)) p.failed = 1;
+    walk(loop->forstmt.body, check_body_node, &p);
+
+    if (!p.failed) {
+        loop->forstmt.capture_count = p.captured.count;
+        loop->forstmt.captures = malloc(sizeof(Symbol*) * (p.captured.count + 1));
+        for (int i = 0; i < p.captured.count; ++i)
+            loop->forstmt.captures[i] = get_symbol(p.captured.ids[i]);
+        loop->forstmt.reduction_count = count;
+        loop->forstmt.reductions = malloc(sizeof(Reduction) * (count + 1));
+        memcpy(loop->forstmt.reductions, reductions, sizeof(Reduction) * count);
+    }
+    free(p.locals.ids);
+    free(p.captured.ids);
+    free(p.accumulators.ids);
+    return !p.failed;
+}
+
+// Una expresión que se puede evaluar de a 4 iteraciones con vectores de enteros: +, - y *
+// sobre constantes, la variable del ciclo, escalares que el ciclo no escribe y elementos
+// v[i] de arreglos (o columnas soa) indexados por la variable del ciclo.
+static int simd_expr(ASTNode* node, const char* var) {
+    switch (node->type) {
+        case NODE_INT:
+            return 1;
+        case NODE_ID:
+            return node->data_type == NODE_INT;
+        case NODE_BINOP:
+            return node->data_type == NODE_INT &&
+                   (strcmp(node->binop.op, "+") == 0 || strcmp(node->binop.op, "-") == 0 ||
+                    strcmp(node->binop.op, "*") == 0) &&
+                   simd_expr(node->binop.left, var) && simd_expr(node->binop.right, var);
+        case NODE_INDEX: {
+            if (node->data_type != NODE_INT) return 0;
+            if (!node->index.index) return 1;
+            Symbol* s = get_symbol(node->index.id);
+            if (!s || !s->array_size || (s->record && !s->soa)) return 0;
+            return is_id(node->index.index, var);
+        }
+        default:
+            return 0;
+    }
+}
+
+static int is_simd_body(ASTNode* body, const char* var, Reduction* reductions, int count) {
+    int n = body->type == NODE_BLOCK ? body->block.stmt_count : 1;
+    if (n != count) return 0;
+    for (int i = 0; i < count; ++i)
+        if (!simd_expr(reductions[i].expr, var)) return 0;
+    return 1;
+}
+
+// while (i < b) { ...; i = i + 1; } pasa a ser for (i = i; i < b; i = i + 1) { ... }.
+static void while_to_for(ASTNode* loop) {
+    ASTNode* cond = loop->whilestmt.cond;
+    ASTNode* body = loop->whilestmt.body;
+    const char* var = cond->binop.left->sval;
+    ASTNode* update = body->block.stmts[body->block.stmt_count - 1];
+    body->block.stmt_count--;
+    ASTNode* init = make_assign_node(var, make_id_node(var));
+    init->line = cond->line;
+    loop->type = NODE_FOR;
+    loop->line = cond->line;
+    memset(&loop->forstmt, 0, sizeof(loop->forstmt));
+    loop->forstmt.init = init;
+    loop->forstmt.cond = cond;
+    loop->forstmt.update = update;
+    loop->forstmt.body = body;
+}
+
+// Un for contado, o un while (i < b) cuyo cuerpo termina en i = i + 1 y no vuelve a
+// escribir i, con reducciones enteras y nada más que escriba fuera del cuerpo. Si todo el
+// cuerpo son reducciones vectorizables se genera con SIMD; si tiene llamadas o ciclos, como
+// un parallel for con un acumulador parcial por tramo.
+static void try_reduction(ASTNode* loop) {
+    const char* var;
+    ASTNode* cond;
+    ASTNode* body;
+    if (loop->type == NODE_FOR) {
+        if (!is_counted_loop(loop->forstmt.init, loop->forstmt.cond, loop->forstmt.update)) return;
+        var = loop->forstmt.init->assign.id;
+        cond = loop->forstmt.cond;
+        body = loop->forstmt.body;
+    } else {
+        cond = loop->whilestmt.cond;
+        body = loop->whilestmt.body;
+        if (!cond || cond->type != NODE_BINOP || cond->binop.left->type != NODE_ID) return;
+        var = cond->binop.left->sval;
+        if (!is_int_scalar(var) || !is_counted_cond(cond, var)) return;
+        if (!body || body->type != NODE_BLOCK || body->block.stmt_count < 2) return;
+        if (!is_increment(body->block.stmts[body->block.stmt_count - 1], var)) return;
+    }
+
+    ASTNode* bound = cond->binop.right;
+    if (count_uses(bound, var) || has_calls(bound)) return;
+
+    // El cuerpo sin el incremento final del while.
+    ASTNode shadow = *body;
+    if (loop->type == NODE_WHILE) shadow.block.stmt_count--;
+    Reduction reductions[MAX_REDUCTIONS];
+    int count = find_reductions(&shadow, var, reductions);
+    if (count == 0) return;
+    for (int i = 0; i < count; ++i)
+        if (count_uses(bound, reductions[i].acc)) return;
+
+    int simd = is_simd_body(&shadow, var, reductions, count);
+    if (!simd && !is_heavy(&shadow)) return;
+
+    ASTNode saved = *loop;
+    if (loop->type == NODE_WHILE) while_to_for(loop);
+    if (!check_loop(loop, var, 1, reductions, count)) {
+        *loop = saved;
+        if (saved.type == NODE_WHILE) body->block.stmt_count++;
+        return;
+    }
+    // Como en make_parallel_for_node: la línea del encabezado, no la del final del cuerpo.
+    loop->line = loop->forstmt.init->line;
+    if (simd)
+        loop->forstmt.simd = 1;
+    else
+        loop->forstmt.parallel = 1;
+    printf("Reducciones: ciclo de la línea %d, %d acumulador(es), %s\n",
+           loop->line, count, simd ? "SIMD" : "en paralelo");
+}
+
+static void find_loops(ASTNode* node, void* data) {
+    (void)data;
+    // Un ciclo ya revisado (el cuerpo de una función expandida puede aparecer dos veces).
+    if (node->type == NODE_FOR && node->forstmt.reductions) return;
+    if (node->type == NODE_FOR && node->forstmt.parallel) {
+        const char* var = node->forstmt.init->assign.id;
+        Reduction reductions[MAX_REDUCTIONS];
+        int count = find_reductions(node->forstmt.body, var, reductions);
+        check_loop(node, var, 0, reductions, count);
+        printf("Paralelo: ciclo de la línea %d, %d variable(s) capturada(s), %d reducción(es)\n",
+               node->line, node->forstmt.capture_count, count);
+    } else if (node->type == NODE_FOR || node->type == NODE_WHILE) {
+        try_reduction(node);
+    }
+}
+
+static void check_spawn(ASTNode* node, void* data) {
+    if (node->type != NODE_FUNCCALL || !node->funccall.spawn) return;
+    const char* id = node->funccall.id;
+    if (!get_function_entry(id)) {
+        fprintf(stderr, "Error en la línea %d: spawn: la función '%s' no existe.\n", node->line, id);
+        exit(1);
+    }
+    if (id_set_has(&unsafe_functions, id)) {
+        fprintf(stderr, "Error en la línea %d: spawn: la función '%s' usa print, write o cadenas.\n",
+                node->line, id);
+        exit(1);
+    }
+    (*(int*)data)++;
+}
+
+// Si después de ejecutar node puede quedar alguna tarea sin esperar, sabiendo si quedaba
+// antes (pending). Un ciclo puede ejecutar su cuerpo ninguna, una o varias veces.
+static int leaves_tasks(ASTNode* node, int pending) {
+    if (!node) return pending;
+    switch (node->type) {
+        case NODE_SYNC:
+            return 0;
+        case NODE_FUNCCALL:
+            return pending || node->funccall.spawn;
+        case NODE_ASSIGN:
+            return leaves_tasks(node->assign.value, pending);
+        case NODE_IF:
+            return leaves_tasks(node->ifstmt.then_branch, pending) ||
+                   leaves_tasks(node->ifstmt.else_branch, pending);
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                pending = leaves_tasks(node->block.stmts[i], pending);
+            return pending;
+        case NODE_WHILE:
+        case NODE_FOR:
+        case NODE_FOR_IN: {
+            ASTNode* body = node->type == NODE_WHILE ? node->whilestmt.body :
+                            node->type == NODE_FOR ? node->forstmt.body : node->forin.body;
+            int once = leaves_tasks(body, pending);
+            return pending || once || leaves_tasks(body, pending || once);
+        }
+        default:
+            return pending;
+    }
+}
+
+// Las tareas escriben sus resultados en locales de la función que las lanzó, así que esa
+// función las espera antes de terminar: si puede llegar al final con tareas pendientes, su
+// cuerpo cierra con un sync. No se agrega cuando cada spawn ya tiene su sync, porque la
+// espera al final de cada llamada le impide a gcc optimizar el camino que no lanza tareas.
+static void close_spawns(ASTNode* body, const char* owner) {
+    int count = 0;
+    walk(body, check_spawn, &count);
+    if (count == 0 || !body || body->type != NODE_BLOCK) return;
+    printf("Spawn: %d llamada(s) lanzada(s) como tarea en %s\n", count, owner);
+    if (!leaves_tasks(body, 0)) return;
+    body->block.stmts = realloc(body->block.stmts, sizeof(ASTNode*) * (body->block.stmt_count + 1));
+    body->block.stmts[body->block.stmt_count++] = make_sync_node();
+}
+
+// Cuántas tareas pueden enviar (o recibir) por un channel: 0, 1 o 2 (varias). self es la
+// tarea que lo tiene, con lo que hacen las funciones que llama sin spawn; others cuenta las
+// tareas lanzadas con spawn que lo recibieron.
+typedef struct {
+    int self;
+    int others;
+} ChannelUse;
+
+// Por cada función, el uso que hace de cada parámetro channel (incluidas sus llamadas).
+typedef struct {
+    FunctionEntry* f;
+    ChannelUse* sends;
+    ChannelUse* recvs;
+} ChannelSummary;
+
+static ChannelSummary* channel_summaries = NULL;
+static int channel_summary_count = 0;
+
+static ChannelSummary* channel_summary(const char* id) {
+    for (int i = 0; i < channel_summary_count; ++i)
+        if (strcmp(channel_summaries[i].f->id, id) == 0) return &channel_summaries[i];
+    return NULL;
+}
+
+static int at_most_many(int n) {
+    return n > 2 ? 2 : n;
+}
+
+// Agrega a *use lo que hace una llamada con el channel: si es un spawn, todas las tareas de
+// la función llamada son otras; si no, la propia sigue siendo la misma. times es 2 dentro
+// de un ciclo, donde la llamada se puede repetir.
+static void add_call_use(ChannelUse* use, ChannelUse callee, int spawn, int times) {
+    if (spawn) {
+        use->others = at_most_many(use->others + times * (callee.self + callee.others));
+    } else {
+        use->self |= callee.self;
+        use->others = at_most_many(use->others + times * callee.others);
+    }
+}
+
+static void channel_uses(ASTNode* node, const char* id, int times, ChannelUse* send, ChannelUse* recv) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_FUNCCALL: {
+            ASTNode** args = node->funccall.args;
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                channel_uses(args[i], id, times, send, recv);
+            if (get_builtin(node->funccall.id)) {
+                if (node->funccall.arg_count > 0 && args[0]->data_type == NODE_CHANNEL &&
+                    strcmp(args[0]->sval, id) == 0)
+                    (strcmp(node->funccall.id, "send") == 0 ? send : recv)->self = 1;
+                break;
+            }
+            ChannelSummary* callee = channel_summary(node->funccall.id);
+            if (!callee) break;
+            for (int i = 0; i < node->funccall.arg_count && i < callee->f->param_count; ++i) {
+                if (args[i]->data_type != NODE_CHANNEL || strcmp(args[i]->sval, id) != 0) continue;
+                add_call_use(send, callee->sends[i], node->funccall.spawn, times);
+                add_call_use(recv, callee->recvs[i], node->funccall.spawn, times);
+            }
+            break;
+        }
+        case NODE_BINOP:
+            channel_uses(node->binop.left, id, times, send, recv);
+            channel_uses(node->binop.right, id, times, send, recv);
+            break;
+        case NODE_ASSIGN:
+            channel_uses(node->assign.value, id, times, send, recv);
+            break;
+        case NODE_PRINT:
+            channel_uses(node->print.value, id, times, send, recv);
+            break;
+        case NODE_RETURN:
+            channel_uses(node->returnstmt.value, id, times, send, recv);
+            break;
+        case NODE_IF:
+            channel_uses(node->ifstmt.cond, id, times, send, recv);
+            channel_uses(node->ifstmt.then_branch, id, times, send, recv);
+            channel_uses(node->ifstmt.else_branch, id, times, send, recv);
+            break;
+        case NODE_WHILE:
+            channel_uses(node->whilestmt.cond, id, 2, send, recv);
+            channel_uses(node->whilestmt.body, id, 2, send, recv);
+            break;
+        case NODE_FOR:
+            channel_uses(node->forstmt.init, id, times, send, recv);
+            channel_uses(node->forstmt.cond, id, 2, send, recv);
+            channel_uses(node->forstmt.update, id, 2, send, recv);
+            channel_uses(node->forstmt.body, id, 2, send, recv);
+            break;
+        case NODE_FOR_IN:
+            channel_uses(node->forin.body, id, 2, send, recv);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                channel_uses(node->block.stmts[i], id, times, send, recv);
+            break;
+        case NODE_INLINED:
+            channel_uses(node->inlined.body, id, times, send, recv);
+            channel_uses(node->inlined.result, id, times, send, recv);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            channel_uses(node->index.index, id, times, send, recv);
+            channel_uses(node->index.value, id, times, send, recv);
+            break;
+        default:
+            break;
+    }
+}
+
+// Los argumentos channel tienen que ir a parámetros channel del mismo tipo, y al revés.
+static void check_channel_args(ASTNode* node, void* data) {
+    (void)data;
+    if (node->type != NODE_FUNCCALL || get_builtin(node->funccall.id)) return;
+    FunctionEntry* f = get_function_entry(node->funccall.id);
+    if (!f) return;
+    for (int i = 0; i < node->funccall.arg_count && i < f->param_count; ++i) {
+        ASTNode* arg = node->funccall.args[i];
+        ASTNode* param = f->params[i];
+        int is_channel = arg->data_type == NODE_CHANNEL;
+        if (is_channel == param->decl.is_channel &&
+            (!is_channel || get_symbol(arg->sval)->type == param->decl.decl_type))
+            continue;
+        if (param->decl.is_channel)
+            fprintf(stderr, "Error en la línea %d: el argumento %d de '%s' debe ser un channel de %s.\n",
+                    node->line, i + 1, f->id, param->decl.decl_type == NODE_FLOAT ? "floating" : "integer");
+        else
+            fprintf(stderr, "Error en la línea %d: el argumento %d de '%s' no puede ser un channel.\n",
+                    node->line, i + 1, f->id);
+        exit(1);
+    }
+}
+
+// El uso de los parámetros channel de cada función, iterando hasta que no cambia: los
+// contadores solo crecen y están acotados, así que la recursión termina.
+static void compute_channel_summaries(void) {
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        channel_summaries = realloc(channel_summaries, sizeof(ChannelSummary) * (channel_summary_count + 1));
+        ChannelSummary* summary = &channel_summaries[channel_summary_count++];
+        summary->f = f;
+        summary->sends = calloc(f->param_count + 1, sizeof(ChannelUse));
+        summary->recvs = calloc(f->param_count + 1, sizeof(ChannelUse));
+    }
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int k = 0; k < channel_summary_count; ++k) {
+            ChannelSummary* summary = &channel_summaries[k];
+            FunctionEntry* f = summary->f;
+            for (int i = 0; i < f->param_count; ++i) {
+                if (!f->params[i]->decl.is_channel) continue;
+                ChannelUse send = { 0, 0 }, recv = { 0, 0 };
+                channel_uses(f->body, f->params[i]->decl.id, 1, &send, &recv);
+                channel_uses(f->return_expr, f->params[i]->decl.id, 1, &send, &recv);
+                if (memcmp(&send, &summary->sends[i], sizeof(send)) != 0 ||
+                    memcmp(&recv, &summary->recvs[i], sizeof(recv)) != 0) {
+                    summary->sends[i] = send;
+                    summary->recvs[i] = recv;
+                    changed = 1;
+                }
+            }
+        }
+    }
+}
+
+// Un channel es spsc si, desde su declaración hasta el final del bloque, a lo sumo una
+// tarea envía y a lo sumo una recibe. Además el channel se libera al salir del bloque, así
+// que el bloque espera antes a las tareas que lanzó.
+static void mark_channels(ASTNode* node, void* data) {
+    (void)data;
+    if (node->type != NODE_BLOCK) return;
+    int declares = 0;
+    for (int i = 0; i < node->block.stmt_count; ++i) {
+        ASTNode* decl = node->block.stmts[i];
+        if (!decl || decl->type != NODE_DECL || !decl->decl.is_channel) continue;
+        declares = 1;
+        ChannelUse send = { 0, 0 }, recv = { 0, 0 };
+        for (int j = i + 1; j < node->block.stmt_count; ++j)
+            channel_uses(node->block.stmts[j], decl->decl.id, 1, &send, &recv);
+        decl->decl.spsc = send.self + send.others <= 1 && recv.self + recv.others <= 1;
+        printf("Channel: '%s' (línea %d), %s\n", decl->decl.id, decl->line, decl->decl.spsc ? "spsc" : "mpmc");
+    }
+    if (declares && leaves_tasks(node, 0)) {
+        node->block.stmts = realloc(node->block.stmts, sizeof(ASTNode*) * (node->block.stmt_count + 1));
+        node->block.stmts[node->block.stmt_count++] = make_sync_node();
+    }
+}
+
+void analyze_parallel(ASTNode* root) {
+    compute_unsafe_functions();
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        close_spawns(f->body, f->id);
+        walk(f->body, find_loops, NULL);
+        walk(f->return_expr, find_loops, NULL);
+    }
+    close_spawns(root, "main");
+    walk(root, find_loops, NULL);
+
+    compute_channel_summaries();
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        walk(f->body, check_channel_args, NULL);
+        walk(f->return_expr, check_channel_args, NULL);
+        walk(f->body, mark_channels, NULL);
+    }
+    walk(root, check_channel_args, NULL);
+    walk(root, mark_channels, NULL);
+}
@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "ast_c.h"
+
+#define MAX_WIDEN_ITERATIONS 32
+
+// Intervalo [lo, hi] de una variable entera; nonzero permite excluir el 0 del interior.
+typedef struct {
+    long long lo;
+    long long hi;
+    int nonzero;
+} Range;
+
+typedef struct {
+    const char* id;
+    Range range;
+} RangeVar;
+
+typedef struct {
+    RangeVar* vars;
+    int count;
+    int unreachable;
+} RangeEnv;
+
+static int division_count = 0;
+static int checks_removed = 0;
+static int index_count = 0;
+static int bounds_removed = 0;
+
+static Range range_top(void) {
+    Range r = { INT_MIN, INT_MAX, 0 };
+    return r;
+}
+
+static Range range_const(long long v) {
+    Range r = { v, v, v != 0 };
+    return r;
+}
+
+static Range range_normalize(Range r) {
+    if (r.lo < INT_MIN || r.hi > INT_MAX) return range_top();
+    if (r.lo > 0 || r.hi < 0) r.nonzero = 1;
+    if (r.nonzero && r.lo == 0) r.lo = 1;
+    if (r.nonzero && r.hi == 0) r.hi = -1;
+    return r;
+}
+
+static int range_empty(Range r) {
+    return r.lo > r.hi;
+}
+
+static Range range_join(Range a, Range b) {
+    Range r;
+    r.lo = a.lo < b.lo ? a.lo : b.lo;
+    r.hi = a.hi > b.hi ? a.hi : b.hi;
+    r.nonzero = a.nonzero && b.nonzero;
+    return range_normalize(r);
+}
+
+static RangeEnv env_copy(RangeEnv* env) {
+    RangeEnv copy;
+    copy.count = env->count;
+    copy.unreachable = env->unreachable;
+    copy.vars = malloc(sizeof(RangeVar) * (env->count ? env->count : 1));
+    memcpy(copy.vars, env->vars, sizeof(RangeVar) * env->count);
+    return copy;
+}
+
+static void env_free(RangeEnv* env) {
+    free(env->vars);
+    env->vars = NULL;
+    env->count = 0;
+}
+
+static RangeVar* env_find(RangeEnv* env, const char* id) {
+    for (int i = 0; i < env->count; ++i)
+        if (strcmp(env->vars[i].id, id) == 0)
+            return &env->vars[i];
+    return NULL;
+}
+
+static Range env_get(RangeEnv* env, const char* id) {
+    RangeVar* v = env_find(env, id);
+    return v ? v->range : range_top();
+}
+
+static void env_set(RangeEnv* env, const char* id, Range r) {
+    RangeVar* v = env_find(env, id);
+    if (!v) {
+        env->vars = realloc(env->vars, sizeof(RangeVar) * (env->count + 1));
+        v = &env->vars[env->count++];
+        v->id = id;
+    }
+    v->range = r;
+}
+
+// Une dos entornos; las variables ausentes en uno de ellos se consideran desconocidas.
+static RangeEnv env_join(RangeEnv* a, RangeEnv* b) {
+    if (a->unreachable) return env_copy(b);
+    if (b->unreachable) return env_copy(a);
+    RangeEnv r = { NULL, 0, 0 };
+    for (int i = 0; i < a->count; ++i) {
+        RangeVar* other = env_find(b, a->vars[i].id);
+        env_set(&r, a->vars[i].id, other ? range_join(a->vars[i].range, other->range) : range_top());
+    }
+    for (int i = 0; i < b->count; ++i)
+        if (!env_find(a, b->vars[i].id))
+            env_set(&r, b->vars[i].id, range_top());
+    return r;
+}
+
+// Ensanchamiento: las cotas que siguen creciendo saltan al extremo del tipo.
+static void env_widen(RangeEnv* old, RangeEnv* next) {
+    if (old->unreachable) return;
+    for (int i = 0; i < next->count; ++i) {
+        RangeVar* prev = env_find(old, next->vars[i].id);
+        Range* r = &next->vars[i].range;
+        if (!prev) { *r = range_top(); continue; }
+        if (r->lo < prev->range.lo) r->lo = INT_MIN;
+        if (r->hi > prev->range.hi) r->hi = INT_MAX;
+        r->nonzero = r->nonzero && prev->range.nonzero;
+        *r = range_normalize(*r);
+    }
+}
+
+static int env_equal(RangeEnv* a, RangeEnv* b) {
+    if (a->unreachable != b->unreachable || a->count != b->count) return 0;
+    for (int i = 0; i < a->count; ++i) {
+        RangeVar* other = env_find(b, a->vars[i].id);
+        if (!other) return 0;
+        if (other->range.lo != a->vars[i].range.lo || other->range.hi != a->vars[i].range.hi ||
+            other->range.nonzero != a->vars[i].range.nonzero)
+            return 0;
+    }
+    return 1;
+}
+
+static int is_int_var(ASTNode* node) {
+    return node && node->type == NODE_ID && node->data_type == NODE_INT;
+}
+
+static Range eval_range(ASTNode* node, RangeEnv* env, int record);
+static void analyze_stmt(ASTNode* node, RangeEnv* env, int record);
+
+static Range eval_arith(const char* op, Range a, Range b) {
+    if (strcmp(op, "+") == 0) {
+        Range r = { a.lo + b.lo, a.hi + b.hi, 0 };
+        return range_normalize(r);
+    }
+    if (strcmp(op, "-") == 0) {
+        Range r = { a.lo - b.hi, a.hi - b.lo, 0 };
+        return range_normalize(r);
+    }
+    if (strcmp(op, "*") == 0) {
+        long long c[4] = { a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi };
+        Range r = { c[0], c[0], a.nonzero && b.nonzero };
+        for (int i = 1; i < 4; ++i) {
+            if (c[i] < r.lo) r.lo = c[i];
+            if (c[i] > r.hi) r.hi = c[i];
+        }
+        return range_normalize(r);
+    }
+    if (strcmp(op, "/") == 0) {
+        if (b.lo <= 0 && b.hi >= 0) return range_top();
+        long long c[4] = { a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi };
+        Range r = { c[0], c[0], 0 };
+        for (int i = 1; i < 4; ++i) {
+            if (c[i] < r.lo) r.lo = c[i];
+            if (c[i] > r.hi) r.hi = c[i];
+        }
+        return range_normalize(r);
+    }
+    if (strcmp(op, "%") == 0) {
+        if (!b.nonzero) return range_top();
+        long long m = b.hi > -b.lo ? b.hi : -b.lo;
+        Range r = { a.lo >= 0 ? 0 : -(m - 1), a.hi <= 0 ? 0 : m - 1, 0 };
+        return range_normalize(r);
+    }
+    // Comparaciones
+    Range r = { 0, 1, 0 };
+    return r;
+}
+
+static Range eval_range(ASTNode* node, RangeEnv* env, int record) {
+    if (!node) return range_top();
+    switch (node->type) {
+        case NODE_INT:
+            return range_const(node->ival);
+
+        case NODE_ID:
+            return node->data_type == NODE_INT ? env_get(env, node->sval) : range_top();
+
+        case NODE_ASSIGN: {
+            Range r = eval_range(node->assign.value, env, record);
+            if (node->data_type == NODE_INT)
+                env_set(env, node->assign.id, r);
+            return r;
+        }
+
+        case NODE_BINOP: {
+            Range l = eval_range(node->binop.left, env, record);
+            Range r = eval_range(node->binop.right, env, record);
+            int is_div = strcmp(node->binop.op, "/") == 0 || strcmp(node->binop.op, "%") == 0;
+            if (is_div && record) {
+                division_count++;
+                if (node->binop.right->data_type == NODE_INT && r.nonzero && !env->unreachable) {
+                    node->binop.nonzero_divisor = 1;
+                    checks_removed++;
+                }
+            }
+            if (node->data_type != NODE_INT) return range_top();
+            return eval_arith(node->binop.op, l, r);
+        }
+
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN: {
+            Range i = eval_range(node->index.index, env, record);
+            Range value = eval_range(node->index.value, env, record);
+            if (record && node->index.index) {
+                index_count++;
+                if (i.lo >= 0 && i.hi < node->index.size && !env->unreachable) {
+                    node->index.in_bounds = 1;
+                    bounds_removed++;
+                }
+            }
+            return node->type == NODE_INDEX_ASSIGN && node->data_type == NODE_INT ? value : range_top();
+        }
+
+        case NODE_READ: {
+            for (int i = 0; i < node->read.id_count; ++i)
+                if (get_symbol_type(node->read.ids[i]) == NODE_INT)
+                    env_set(env, node->read.ids[i], range_top());
+            Range status = { 0, 1, 0 };
+            return status;
+        }
+
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                eval_range(node->funccall.args[i], env, record);
+            return range_top();
+
+        case NODE_INLINED: {
+            analyze_stmt(node->inlined.body, env, record);
+            return eval_range(node->inlined.result, env, record);
+        }
+
+        default:
+            return range_top();
+    }
+}
+
+// Refina el entorno suponiendo que la comparación `id op bound` vale.
+static void refine_var(RangeEnv* env, const char* id, const char* op, Range bound) {
+    Range r = env_get(env, id);
+    if (strcmp(op, "<") == 0) {
+        if (bound.hi - 1 < r.hi) r.hi = bound.hi - 1;
+    } else if (strcmp(op, "<=") == 0) {
+        if (bound.hi < r.hi) r.hi = bound.hi;
+    } else if (strcmp(op, ">") == 0) {
+        if (bound.lo + 1 > r.lo) r.lo = bound.lo + 1;
+    } else if (strcmp(op, ">=") == 0) {
+        if (bound.lo > r.lo) r.lo = bound.lo;
+    } else if (strcmp(op, "==") == 0) {
+        if (bound.lo > r.lo) r.lo = bound.lo;
+        if (bound.hi < r.hi) r.hi = bound.hi;
+        if (bound.nonzero) r.nonzero = 1;
+    } else if (strcmp(op, "!=") == 0) {
+        if (bound.lo == 0 && bound.hi == 0) r.nonzero = 1;
+    }
+    if (range_empty(r)) {
+        env->unreachable = 1;
+        return;
+    }
+    env_set(env, id, range_normalize(r));
+}
+
+static const char* negate_op(const char* op) {
+    if (strcmp(op, "<") == 0) return ">=";
+    if (strcmp(op, "<=") == 0) return ">";
+    if (strcmp(op, ">") == 0) return "<=";
+    if (strcmp(op, ">=") == 0) return "<";
+    if (strcmp(op, "==") == 0) return "!=";
+    if (strcmp(op, "!=") == 0) return "==";
+    return NULL;
+}
+
+static const char* mirror_op(const char* op) {
+    if (strcmp(op, "<") == 0) return ">";
+    if (strcmp(op, "<=") == 0) return ">=";
+    if (strcmp(op, ">") == 0) return "<";
+    if (strcmp(op, ">=") == 0) return "<=";
+    return op;
+}
+
+static void refine_cond(ASTNode* cond, RangeEnv* env, int truth) {
+    if (!cond || env->unreachable) return;
+
+    if (is_int_var(cond)) {
+        Range zero = range_const(0);
+        refine_var(env, cond->sval, truth ? "!=" : "==", zero);
+        return;
+    }
+    if (cond->type != NODE_BINOP) return;
+
+    const char* op = truth ? cond->binop.op : negate_op(cond->binop.op);
+    if (!op) return;
+    ASTNode* l = cond->binop.left;
+    ASTNode* r = cond->binop.right;
+    if (l->data_type != NODE_INT || r->data_type != NODE_INT) return;
+
+    Range lr = eval_range(l, env, 0);
+    Range rr = eval_range(r, env, 0);
+    if (is_int_var(l)) refine_var(env, l->sval, op, rr);
+    if (is_int_var(r)) refine_var(env, r->sval, mirror_op(op), lr);
+}
+
+static void analyze_loop(ASTNode* cond, ASTNode* body, ASTNode* update, RangeEnv* env, int record) {
+    RangeEnv entry = env_copy(env);
+    for (int iter = 0; iter < MAX_WIDEN_ITERATIONS; ++iter) {
+        RangeEnv body_env = env_copy(&entry);
+        eval_range(cond, &body_env, 0);
+        refine_cond(cond, &body_env, 1);
+        analyze_stmt(body, &body_env, 0);
+        eval_range(update, &body_env, 0);
+
+        RangeEnv next = env_join(env, &body_env);
+        if (iter >= 2) env_widen(&entry, &next);
+        env_free(&body_env);
+
+        int stable = env_equal(&next, &entry);
+        env_free(&entry);
+        entry = next;
+        if (stable) break;
+        if (iter == MAX_WIDEN_ITERATIONS - 1) {
+            for (int i = 0; i < entry.count; ++i) entry.vars[i].range = range_top();
+        }
+    }
+
+    // Pasada final con el invariante estable: solo aquí se marcan las divisiones.
+    RangeEnv body_env = env_copy(&entry);
+    eval_range(cond, &body_env, record);
+    refine_cond(cond, &body_env, 1);
+    analyze_stmt(body, &body_env, record);
+    eval_range(update, &body_env, record);
+    env_free(&body_env);
+
+    env_free(env);
+    *env = entry;
+    refine_cond(cond, env, 0);
+}
+
+static void analyze_stmt(ASTNode* node, RangeEnv* env, int record) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_DECL:
+            if (node->decl.decl_type == NODE_INT)
+                env_set(env, node->decl.id, range_top());
+            break;
+
+        case NODE_ASSIGN:
+        case NODE_INDEX_ASSIGN:
+        case NODE_READ:
+        case NODE_FUNCCALL:
+        case NODE_INLINED:
+            eval_range(node, env, record);
+            break;
+
+        case NODE_PRINT:
+            eval_range(node->print.value, env, record);
+            break;
+
+        case NODE_RETURN:
+            eval_range(node->returnstmt.value, env, record);
+            break;
+
+        case NODE_IF: {
+            eval_range(node->ifstmt.cond, env, record);
+            RangeEnv then_env = env_copy(env);
+            RangeEnv else_env = env_copy(env);
+            refine_cond(node->ifstmt.cond, &then_env, 1);
+            refine_cond(node->ifstmt.cond, &else_env, 0);
+            analyze_stmt(node->ifstmt.then_branch, &then_env, record);
+            analyze_stmt(node->ifstmt.else_branch, &else_env, record);
+            env_free(env);
+            *env = env_join(&then_env, &else_env);
+            env_free(&then_env);
+            env_free(&else_env);
+            break;
+        }
+
+        case NODE_WHILE:
+            analyze_loop(node->whilestmt.cond, node->whilestmt.body, NULL, env, record);
+            break;
+
+        case NODE_FOR:
+            eval_range(node->forstmt.init, env, record);
+            analyze_loop(node->forstmt.cond, node->forstmt.body, node->forstmt.update, env, record);
+            break;
+
+        case NODE_YIELD:
+            eval_range(node->yieldstmt.value, env, record);
+            break;
+
+        case NODE_FOR_IN:
+            // La clave de cada vuelta es cualquiera de las guardadas en el map o de las que
+            // entrega el generador.
+            eval_range(node->forin.call, env, record);
+            if (get_symbol_type(node->forin.key) == NODE_INT)
+                env_set(env, node->forin.key, range_top());
+            analyze_loop(NULL, node->forin.body, NULL, env, record);
+            break;
+
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                analyze_stmt(node->block.stmts[i], env, record);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void analyze_ranges(ASTNode* root) {
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        RangeEnv env = { NULL, 0, 0 };
+        analyze_stmt(f->body, &env, 1);
+        analyze_stmt(f->return_expr, &env, 1);
+        env_free(&env);
+    }
+
+    RangeEnv env = { NULL, 0, 0 };
+    analyze_stmt(root, &env, 1);
+    env_free(&env);
+
+    if (division_count > 0)
+        printf("Rangos: %d de %d comprobación(es) de división por cero eliminada(s)\n",
+               checks_removed, division_count);
+    if (index_count > 0)
+        printf("Rangos: %d de %d comprobación(es) de límites eliminada(s)\n",
+               bounds_removed, index_count);
+}
@@ -1,16 +1,138 @@
 #include "ast_c.h"
 
+extern int yylineno;
+
 Symbol* symbol_table = NULL;
 
+static const char* type_word(NodeType type) {
+    switch (type) {
+        case NODE_INT: return "integer";
+        case NODE_FLOAT: return "floating";
+        case NODE_STRING: return "chain";
+        default: return "record";
+    }
+}
+
+static void describe_symbol(char* buf, size_t size, const Symbol* s) {
+    const char* type = s->record ? s->record->id : type_word(s->type);
+    if (s->is_vector) snprintf(buf, size, "vector %s", type);
+    else if (s->is_map) snprintf(buf, size, "map %s %s", type_word(s->key_type), type);
+    else if (s->is_channel) snprintf(buf, size, "channel %s", type);
+    else if (s->array_size) snprintf(buf, size, "%s[%d]", type, s->array_size);
+    else snprintf(buf, size, "%s", type);
+}
+
+// La tabla de símbolos es plana: un nombre vale para todo el programa, así que solo se puede
+// volver a declarar igual. Si no, el tipo, el tamaño (y con él la comprobación de límites) o
+// la clase de contenedor de todos sus usos saldrían de la primera declaración. Devuelve 1 si
+// el nombre ya estaba declarado así.
+static int redeclared(const char* id, const Symbol* decl) {
+    Symbol* old = get_symbol(id);
+    if (!old) return 0;
+    if (old->type == decl->type && old->array_size == decl->array_size && old->is_vector == decl->is_vector &&
+        old->is_map == decl->is_map && old->key_type == decl->key_type && old->record == decl->record &&
+        old->is_channel == decl->is_channel)
+        return 1;
+    char before[128], now[128];
+    describe_symbol(before, sizeof(before), old);
+    describe_symbol(now, sizeof(now), decl);
+    fprintf(stderr, "Error en la línea %d: '%s' ya se declaró como %s; no se puede volver a declarar como %s "
+                    "(los nombres valen para todo el programa).\n", yylineno, id, before, now);
+    exit(1);
+}
+
 void add_symbol(const char* id, NodeType type) {
-    if (get_symbol(id)) return;
+    Symbol decl = { .type = type, .key_type = NODE_INT };
+    if (redeclared(id, &decl)) return;
     Symbol* sym = malloc(sizeof(Symbol));
     sym->id = strdup(id);
     sym->type = type;
+    sym->array_size = 0;
+    sym->is_vector = 0;
+    sym->is_map = 0;
+    sym->key_type = NODE_INT;
+    sym->record = NULL;
+    sym->soa = 0;
+    sym->is_channel = 0;
     sym->next = symbol_table;
     symbol_table = sym;
 }
 
+void add_array_symbol(const char* id, NodeType elem_type, int size) {
+    if (elem_type == NODE_STRING) {
+        fprintf(stderr, "Error: no se admiten arreglos de chain ('%s').\n", id);
+        exit(1);
+    }
+    if (size <= 0) {
+        fprintf(stderr, "Error: el tamaño del arreglo '%s' debe ser positivo.\n", id);
+        exit(1);
+    }
+    Symbol decl = { .type = elem_type, .array_size = size, .key_type = NODE_INT };
+    if (redeclared(id, &decl)) return;
+    add_symbol(id, elem_type);
+    symbol_table->array_size = size;
+}
+
+void add_vector_symbol(const char* id, NodeType elem_type) {
+    if (elem_type == NODE_STRING) {
+        fprintf(stderr, "Error: no se admiten vectores de chain ('%s').\n", id);
+        exit(1);
+    }
+    Symbol decl = { .type = elem_type, .is_vector = 1, .key_type = NODE_INT };
+    if (redeclared(id, &decl)) return;
+    add_symbol(id, elem_type);
+    symbol_table->is_vector = 1;
+}
+
+void add_channel_symbol(const char* id, NodeType elem_type) {
+    if (elem_type == NODE_STRING) {
+        fprintf(stderr, "Error: los mensajes del channel '%s' deben ser integer o floating.\n", id);
+        exit(1);
+    }
+    Symbol decl = { .type = elem_type, .is_channel = 1, .key_type = NODE_INT };
+    if (redeclared(id, &decl)) return;
+    add_symbol(id, elem_type);
+    symbol_table->is_channel = 1;
+}
+
+void add_map_symbol(const char* id, NodeType key_type, NodeType value_type) {
+    if (key_type == NODE_FLOAT) {
+        fprintf(stderr, "Error: las claves del map '%s' deben ser integer o chain.\n", id);
+        exit(1);
+    }
+    if (value_type == NODE_STRING) {
+        fprintf(stderr, "Error: los valores del map '%s' deben ser integer o floating.\n", id);
+        exit(1);
+    }
+    Symbol decl = { .type = value_type, .is_map = 1, .key_type = key_type };
+    if (redeclared(id, &decl)) return;
+    add_symbol(id, value_type);
+    symbol_table->is_map = 1;
+    symbol_table->key_type = key_type;
+}
+
+void add_record_symbol(const char* id, const char* record, int size, const char* layout) {
+    RecordType* rec = get_record(record);
+    if (!rec) {
+        fprintf(stderr, "Error: tipo '%s' desconocido.\n", record);
+        exit(1);
+    }
+    if (layout && strcmp(layout, "soa") != 0 && strcmp(layout, "aos") != 0) {
+        fprintf(stderr, "Error: layout '%s' desconocido para '%s'; use aos o soa.\n", layout, id);
+        exit(1);
+    }
+    if (size < 0 || (layout && size == 0)) {
+        fprintf(stderr, "Error: el tamaño del arreglo '%s' debe ser positivo.\n", id);
+        exit(1);
+    }
+    Symbol decl = { .type = NODE_RECORD, .array_size = size, .key_type = NODE_INT, .record = rec };
+    if (redeclared(id, &decl)) return;
+    add_symbol(id, NODE_RECORD);
+    symbol_table->array_size = size;
+    symbol_table->record = rec;
+    symbol_table->soa = layout && strcmp(layout, "soa") == 0;
+}
+
 Symbol* get_symbol(const char* id) {
     for (Symbol* s = symbol_table; s; s = s->next)
         if (strcmp(s->id, id) == 0)
@@ -27,10 +149,62 @@ NodeType get_symbol_type(const char* id) {
     return s->type;
 }
 
+// Tabla de records
+RecordType* record_table = NULL;
+
+void add_record(const char* id, ASTNode** fields, int field_count) {
+    if (get_record(id)) {
+        fprintf(stderr, "Error: el record '%s' ya está declarado.\n", id);
+        exit(1);
+    }
+    for (int i = 0; i < field_count; ++i) {
+        if (fields[i]->decl.decl_type == NODE_STRING) {
+            fprintf(stderr, "Error: el campo '%s' de '%s' debe ser integer o floating.\n",
+                    fields[i]->decl.id, id);
+            exit(1);
+        }
+        for (int j = 0; j < i; ++j) {
+            if (strcmp(fields[i]->decl.id, fields[j]->decl.id) == 0) {
+                fprintf(stderr, "Error: campo '%s' repetido en '%s'.\n", fields[i]->decl.id, id);
+                exit(1);
+            }
+        }
+    }
+    RecordType* rec = malloc(sizeof(RecordType));
+    rec->id = strdup(id);
+    rec->fields = fields;
+    rec->field_count = field_count;
+    rec->next = record_table;
+    record_table = rec;
+}
+
+RecordType* get_record(const char* id) {
+    for (RecordType* r = record_table; r; r = r->next)
+        if (strcmp(r->id, id) == 0)
+            return r;
+    return NULL;
+}
+
+static int is_comparison(const char* op) {
+    return strcmp(op, "==") == 0 || strcmp(op, "!=") == 0 ||
+           strcmp(op, "<") == 0 || strcmp(op, "<=") == 0 ||
+           strcmp(op, ">") == 0 || strcmp(op, ">=") == 0;
+}
+
 void check_binop_types(const char* op, NodeType left, NodeType right) {
-    if (strcmp(op, "==") == 0 || strcmp(op, "!=") == 0 ||
-        strcmp(op, "<") == 0 || strcmp(op, "<=") == 0 ||
-        strcmp(op, ">") == 0 || strcmp(op, ">=") == 0) {
+    if (left == NODE_VECTOR || right == NODE_VECTOR) {
+        fprintf(stderr, "Error: operación '%s' no permitida con vectores.\n", op);
+        exit(1);
+    }
+    if (left == NODE_MAP || right == NODE_MAP) {
+        fprintf(stderr, "Error: operación '%s' no permitida con maps.\n", op);
+        exit(1);
+    }
+    if (left == NODE_CHANNEL || right == NODE_CHANNEL) {
+        fprintf(stderr, "Error: operación '%s' no permitida con channels; use send y recv.\n", op);
+        exit(1);
+    }
+    if (is_comparison(op)) {
 
         if (left != right) {
             fprintf(stderr, "Error: comparación entre tipos diferentes (%d vs %d).\n", left, right);
@@ -53,25 +227,29 @@ void check_binop_types(const char* op, NodeType left, NodeType right) {
     }
 }
 
+static ASTNode* new_node(NodeType type) {
+    ASTNode* node = calloc(1, sizeof(ASTNode));
+    node->type = type;
+    node->line = yylineno;
+    return node;
+}
+
 ASTNode* make_int_node(int val) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_INT;
+    ASTNode* node = new_node(NODE_INT);
     node->ival = val;
     node->data_type = NODE_INT;
     return node;
 }
 
 ASTNode* make_float_node(float value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_FLOAT;
+    ASTNode* node = new_node(NODE_FLOAT);
     node->fval = value;
     node->data_type = NODE_FLOAT;
     return node;
 }
 
 ASTNode* make_string_node(const char* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_STRING;
+    ASTNode* node = new_node(NODE_STRING);
     node->sval = strdup(value);
     node->data_type = NODE_STRING;
     return node;
@@ -83,23 +261,143 @@ ASTNode* make_id_node(const char* name) {
         fprintf(stderr, "Error: variable '%s' no declarada.\n", name);
         exit(1);
     }
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_ID;
+    if (sym->record) {
+        fprintf(stderr, "Error: '%s' es un record; use %s%s.campo.\n", name, name, sym->array_size ? "[i]" : "");
+        exit(1);
+    }
+    if (sym->array_size) {
+        fprintf(stderr, "Error: '%s' es un arreglo; falta el índice.\n", name);
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_ID);
     node->sval = strdup(name);
+    node->data_type = sym->is_vector ? NODE_VECTOR : sym->is_map ? NODE_MAP
+                    : sym->is_channel ? NODE_CHANNEL : sym->type;
+    return node;
+}
+
+static Symbol* get_array_symbol(const char* id, ASTNode* index) {
+    Symbol* sym = get_symbol(id);
+    if (!sym) {
+        fprintf(stderr, "Error: variable '%s' no declarada.\n", id);
+        exit(1);
+    }
+    if (sym->is_map) {
+        fprintf(stderr, "Error: '%s' es un map; use get(%s, clave).\n", id, id);
+        exit(1);
+    }
+    if (sym->is_channel) {
+        fprintf(stderr, "Error: '%s' es un channel; use recv(%s).\n", id, id);
+        exit(1);
+    }
+    if (!sym->array_size && !sym->is_vector) {
+        fprintf(stderr, "Error: '%s' no es un arreglo.\n", id);
+        exit(1);
+    }
+    if (sym->record) {
+        fprintf(stderr, "Error: '%s' es un arreglo de records; falta el campo.\n", id);
+        exit(1);
+    }
+    if (index->data_type != NODE_INT) {
+        fprintf(stderr, "Error: el índice de '%s' debe ser integer.\n", id);
+        exit(1);
+    }
+    return sym;
+}
+
+ASTNode* make_index_node(const char* id, ASTNode* index) {
+    Symbol* sym = get_array_symbol(id, index);
+    ASTNode* node = new_node(NODE_INDEX);
+    node->index.id = strdup(id);
+    node->index.index = index;
+    node->index.size = sym->array_size;
     node->data_type = sym->type;
     return node;
 }
 
+ASTNode* make_index_assign_node(const char* id, ASTNode* index, ASTNode* value) {
+    Symbol* sym = get_array_symbol(id, index);
+    if (value->data_type != sym->type) {
+        fprintf(stderr, "Error: tipo incompatible en asignación a '%s[]'.\n", id);
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_INDEX_ASSIGN);
+    node->index.id = strdup(id);
+    node->index.index = index;
+    node->index.value = value;
+    node->index.size = sym->array_size;
+    node->data_type = sym->type;
+    return node;
+}
+
+// r.campo (index NULL) o v[i].campo: devuelve el símbolo y deja en *type el tipo del campo.
+static Symbol* get_field_symbol(const char* id, ASTNode* index, const char* field, NodeType* type) {
+    Symbol* sym = get_symbol(id);
+    if (!sym) {
+        fprintf(stderr, "Error: variable '%s' no declarada.\n", id);
+        exit(1);
+    }
+    if (!sym->record) {
+        fprintf(stderr, "Error: '%s' no es un record.\n", id);
+        exit(1);
+    }
+    if (!index && sym->array_size) {
+        fprintf(stderr, "Error: '%s' es un arreglo de records; falta el índice.\n", id);
+        exit(1);
+    }
+    if (index && !sym->array_size) {
+        fprintf(stderr, "Error: '%s' no es un arreglo.\n", id);
+        exit(1);
+    }
+    if (index && index->data_type != NODE_INT) {
+        fprintf(stderr, "Error: el índice de '%s' debe ser integer.\n", id);
+        exit(1);
+    }
+    for (int i = 0; i < sym->record->field_count; ++i) {
+        if (strcmp(sym->record->fields[i]->decl.id, field) == 0) {
+            *type = sym->record->fields[i]->decl.decl_type;
+            return sym;
+        }
+    }
+    fprintf(stderr, "Error: el record '%s' no tiene el campo '%s'.\n", sym->record->id, field);
+    exit(1);
+}
+
+ASTNode* make_field_node(const char* id, ASTNode* index, const char* field) {
+    NodeType type;
+    Symbol* sym = get_field_symbol(id, index, field, &type);
+    ASTNode* node = new_node(NODE_INDEX);
+    node->index.id = strdup(id);
+    node->index.index = index;
+    node->index.size = sym->array_size;
+    node->index.field = strdup(field);
+    node->index.soa = sym->soa;
+    node->data_type = type;
+    return node;
+}
+
+ASTNode* make_field_assign_node(const char* id, ASTNode* index, const char* field, ASTNode* value) {
+    ASTNode* node = make_field_node(id, index, field);
+    if (value->data_type != node->data_type) {
+        fprintf(stderr, "Error: tipo incompatible en asignación a '%s.%s'.\n", id, field);
+        exit(1);
+    }
+    node->type = NODE_INDEX_ASSIGN;
+    node->index.value = value;
+    return node;
+}
+
 ASTNode* make_binop_node(const char* op, ASTNode* left, ASTNode* right) {
     check_binop_types(op, left->data_type, right->data_type);
 
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_BINOP;
+    ASTNode* node = new_node(NODE_BINOP);
     node->binop.op = strdup(op);
     node->binop.left = left;
     node->binop.right = right;
 
-    if (left->data_type == NODE_STRING && right->data_type == NODE_STRING)
+    if (is_comparison(op))
+        node->data_type = NODE_INT;
+    else if (left->data_type == NODE_STRING && right->data_type == NODE_STRING)
         node->data_type = NODE_STRING;
     else if (left->data_type == NODE_FLOAT || right->data_type == NODE_FLOAT)
         node->data_type = NODE_FLOAT;
@@ -111,14 +409,33 @@ ASTNode* make_binop_node(const char* op, ASTNode* left, ASTNode* right) {
 
 ASTNode* make_assign_node(const char* id, ASTNode* expr) {
     NodeType declared_type = get_symbol_type(id);
+    if (get_symbol(id)->array_size) {
+        fprintf(stderr, "Error: no se puede asignar el arreglo '%s' completo.\n", id);
+        exit(1);
+    }
+    if (get_symbol(id)->is_vector) {
+        fprintf(stderr, "Error: no se puede asignar el vector '%s'; use copy(%s, origen).\n", id, id);
+        exit(1);
+    }
+    if (get_symbol(id)->is_map) {
+        fprintf(stderr, "Error: no se puede asignar el map '%s'; use put(%s, clave, valor).\n", id, id);
+        exit(1);
+    }
+    if (get_symbol(id)->record) {
+        fprintf(stderr, "Error: no se puede asignar el record '%s' completo; asigne sus campos.\n", id);
+        exit(1);
+    }
+    if (get_symbol(id)->is_channel) {
+        fprintf(stderr, "Error: no se puede asignar el channel '%s'; use send(%s, valor).\n", id, id);
+        exit(1);
+    }
 
     if (declared_type != expr->data_type) {
         fprintf(stderr, "Error: tipo incompatible en asignación a '%s'.\n", id);
         exit(1);
     }
 
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_ASSIGN;
+    ASTNode* node = new_node(NODE_ASSIGN);
     node->assign.id = strdup(id);
     node->assign.value = expr;
     node->data_type = declared_type;
@@ -126,43 +443,168 @@ ASTNode* make_assign_node(const char* id, ASTNode* expr) {
 }
 
 ASTNode* make_print_node(ASTNode* expr) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_PRINT;
+    if (expr->data_type == NODE_VECTOR || expr->data_type == NODE_MAP || expr->data_type == NODE_CHANNEL) {
+        fprintf(stderr, "Error: no se puede imprimir un %s completo.\n",
+                expr->data_type == NODE_MAP ? "map" : expr->data_type == NODE_CHANNEL ? "channel" : "vector");
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_PRINT);
     node->data_type = expr->data_type;
     node->print.value = expr;
     return node;
 }
 
-ASTNode* make_read_node(const char* id, int dummy) {
+ASTNode* make_read_node(char** ids, int id_count, int returns_status) {
+    for (int i = 0; i < id_count; ++i) {
+        Symbol* sym = get_symbol(ids[i]);
+        if (!sym) {
+            fprintf(stderr, "Error: variable '%s' no declarada (lectura).\n", ids[i]);
+            exit(1);
+        }
+
+        if (sym->array_size || sym->is_vector || sym->is_map || sym->record || sym->is_channel ||
+            (sym->type != NODE_INT && sym->type != NODE_FLOAT && sym->type != NODE_STRING)) {
+            fprintf(stderr, "Error: tipo de variable '%s' no válido para lectura con write.\n", ids[i]);
+            exit(1);
+        }
+    }
+
+    ASTNode* node = new_node(NODE_READ);
+    node->read.ids = ids;
+    node->read.id_count = id_count;
+    node->read.returns_status = returns_status;
+    node->data_type = NODE_INT;
+    return node;
+}
+
+
+ASTNode* make_decl_node(const char* id, NodeType decl_type) {
+    ASTNode* node = new_node(NODE_DECL);
+    node->decl.id = strdup(id);
+    node->decl.decl_type = decl_type;
+    return node;
+}
+
+ASTNode* make_array_decl_node(const char* id, NodeType elem_type, int size) {
+    ASTNode* node = make_decl_node(id, elem_type);
+    node->decl.array_size = size;
+    return node;
+}
+
+ASTNode* make_vector_decl_node(const char* id, NodeType elem_type) {
+    ASTNode* node = make_decl_node(id, elem_type);
+    node->decl.is_vector = 1;
+    return node;
+}
+
+ASTNode* make_map_decl_node(const char* id, NodeType key_type, NodeType value_type) {
+    ASTNode* node = make_decl_node(id, value_type);
+    node->decl.is_map = 1;
+    node->decl.key_type = key_type;
+    return node;
+}
+
+ASTNode* make_record_decl_node(const char* id) {
     Symbol* sym = get_symbol(id);
-    if (!sym) {
-        fprintf(stderr, "Error: variable '%s' no declarada (lectura).\n", id);
+    if (!sym->record) {
+        fprintf(stderr, "Error: '%s' ya está declarada con otro tipo.\n", id);
         exit(1);
     }
+    ASTNode* node = make_decl_node(id, NODE_RECORD);
+    node->decl.array_size = sym->array_size;
+    node->decl.record = sym->record;
+    node->decl.soa = sym->soa;
+    return node;
+}
 
-    if (sym->type != NODE_INT && sym->type != NODE_FLOAT && sym->type != NODE_STRING) {
-        fprintf(stderr, "Error: tipo de variable '%s' no válido para lectura con write.\n", id);
+ASTNode* make_channel_decl_node(const char* id, NodeType elem_type, int capacity) {
+    if (capacity <= 0) {
+        fprintf(stderr, "Error: la capacidad del channel '%s' debe ser positiva.\n", id);
         exit(1);
     }
+    if (!get_symbol(id)->is_channel) {
+        fprintf(stderr, "Error: '%s' ya está declarada con otro tipo.\n", id);
+        exit(1);
+    }
+    ASTNode* node = make_decl_node(id, elem_type);
+    node->decl.is_channel = 1;
+    node->decl.array_size = capacity;
+    return node;
+}
 
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_READ;
-    node->data_type = sym->type;  
+// Un channel como parámetro: la función recibe el mismo channel que le pasan.
+ASTNode* make_channel_param_node(const char* id, NodeType elem_type) {
+    add_channel_symbol(id, elem_type);
+    ASTNode* node = make_channel_decl_node(id, elem_type, 1);
+    node->decl.array_size = 0;
     return node;
 }
 
+ASTNode* make_for_in_node(const char* key, const char* map, ASTNode* body) {
+    Symbol* m = get_symbol(map);
+    if (!m || !m->is_map) {
+        fprintf(stderr, "Error: '%s' no es un map.\n", map);
+        exit(1);
+    }
+    Symbol* k = get_symbol(key);
+    if (!k || k->array_size || k->is_vector || k->is_map || k->record || k->is_channel ||
+        k->type != m->key_type) {
+        fprintf(stderr, "Error: '%s' debe ser una variable %s para recorrer '%s'.\n",
+                key, m->key_type == NODE_STRING ? "chain" : "integer", map);
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_FOR_IN);
+    node->forin.key = strdup(key);
+    node->forin.map = strdup(map);
+    node->forin.body = body;
+    return node;
+}
 
-ASTNode* make_decl_node(const char* id, NodeType decl_type) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_DECL;
-    node->decl.id = strdup(id);
-    node->decl.decl_type = decl_type;
+// for (key in g(...)) body: la llamada no pasa por make_funccall_node_with_args, que
+// rechaza los generadores fuera de este for.
+ASTNode* make_for_generator_node(const char* key, const char* id, ASTNode** args, int arg_count, ASTNode* body) {
+    static int iter_count = 0;
+    FunctionEntry* f = get_function_entry(id);
+    if (!f || !f->generator) {
+        fprintf(stderr, "Error: '%s' no es un generador declarado antes de recorrerlo.\n", id);
+        exit(1);
+    }
+    if (arg_count != f->param_count) {
+        fprintf(stderr, "Error: '%s' espera %d argumento(s).\n", id, f->param_count);
+        exit(1);
+    }
+    for (int i = 0; i < arg_count; ++i) {
+        if (args[i]->data_type != NODE_INT && args[i]->data_type != NODE_FLOAT) {
+            fprintf(stderr, "Error: el argumento %d de '%s' debe ser integer o floating.\n", i + 1, id);
+            exit(1);
+        }
+    }
+    Symbol* k = get_symbol(key);
+    if (!k || k->array_size || k->is_vector || k->is_map || k->record || k->is_channel ||
+        k->type != f->yield_type) {
+        fprintf(stderr, "Error: '%s' debe ser una variable %s para recorrer '%s'.\n",
+                key, f->yield_type == NODE_FLOAT ? "floating" : "integer", id);
+        exit(1);
+    }
+
+    ASTNode* call = new_node(NODE_FUNCCALL);
+    call->funccall.id = strdup(id);
+    call->funccall.args = args;
+    call->funccall.arg_count = arg_count;
+    call->data_type = f->yield_type;
+
+    char iter[32];
+    snprintf(iter, sizeof(iter), "__it%d", iter_count++);
+    ASTNode* node = new_node(NODE_FOR_IN);
+    node->forin.key = strdup(key);
+    node->forin.body = body;
+    node->forin.call = call;
+    node->forin.iter = strdup(iter);
     return node;
 }
 
 ASTNode* make_if_node(ASTNode* cond, ASTNode* then_branch, ASTNode* else_branch) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_IF;
+    ASTNode* node = new_node(NODE_IF);
     node->ifstmt.cond = cond;
     node->ifstmt.then_branch = then_branch;
     node->ifstmt.else_branch = else_branch;
@@ -170,16 +612,14 @@ ASTNode* make_if_node(ASTNode* cond, ASTNode* then_branch, ASTNode* else_branch)
 }
 
 ASTNode* make_while_node(ASTNode* cond, ASTNode* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_WHILE;
+    ASTNode* node = new_node(NODE_WHILE);
     node->whilestmt.cond = cond;
     node->whilestmt.body = body;
     return node;
 }
 
 ASTNode* make_for_node(ASTNode* init, ASTNode* cond, ASTNode* update, ASTNode* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_FOR;
+    ASTNode* node = new_node(NODE_FOR);
     node->forstmt.init = init;
     node->forstmt.cond = cond;
     node->forstmt.update = update;
@@ -187,9 +627,140 @@ ASTNode* make_for_node(ASTNode* init, ASTNode* cond, ASTNode* update, ASTNode* b
     return node;
 }
 
+// Solo la forma (i = a; i < b; i = i + 1), con < o <=: así el tramo [a, b) se conoce antes
+// de empezar y se puede repartir.
+ASTNode* make_parallel_for_node(ASTNode* init, ASTNode* cond, ASTNode* update, ASTNode* body) {
+    ASTNode* node = make_for_node(init, cond, update, body);
+    node->line = init->line;
+    if (!is_counted_loop(init, cond, update)) {
+        fprintf(stderr, "Error en la línea %d: parallel for necesita la forma "
+                        "(i = a; i < b; i = i + 1) con i integer.\n", node->line);
+        exit(1);
+    }
+    node->forstmt.parallel = 1;
+    return node;
+}
+
+// Lo que encuentra scan_generator en el cuerpo de una función: sus yield y, por si resulta
+// ser un generador, la primera construcción que un generador no admite.
+typedef struct {
+    const char* id;
+    int yields;
+    NodeType yield_type;
+    ASTNode* bad;
+    const char* reason;
+} GeneratorScan;
+
+// Un arreglo local de un generador vive en su frame, que va en la pila de quien lo recorre.
+#define GENERATOR_ARRAY_MAX 4096
+
+static void generator_bad(GeneratorScan* scan, ASTNode* node, const char* reason) {
+    if (!scan->bad) {
+        scan->bad = node;
+        scan->reason = reason;
+    }
+}
+
+static void scan_generator(ASTNode* node, GeneratorScan* scan, int in_parallel) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_YIELD:
+            if (in_parallel) {
+                fprintf(stderr, "Error en la línea %d: yield no se puede usar dentro de un parallel for.\n",
+                        node->line);
+                exit(1);
+            }
+            if (scan->yields++ && scan->yield_type != node->data_type) {
+                fprintf(stderr, "Error en la línea %d: todos los yield de '%s' deben entregar el mismo tipo.\n",
+                        node->line, scan->id);
+                exit(1);
+            }
+            scan->yield_type = node->data_type;
+            scan_generator(node->yieldstmt.value, scan, in_parallel);
+            break;
+        case NODE_DECL:
+            if (node->decl.is_vector || node->decl.is_map || node->decl.record || node->decl.is_channel ||
+                node->decl.decl_type == NODE_STRING)
+                generator_bad(scan, node, "variables que no sean integer, floating o arreglos de esos tipos");
+            else if (node->decl.array_size > GENERATOR_ARRAY_MAX)
+                generator_bad(scan, node, "arreglos de más de 4096 elementos");
+            break;
+        case NODE_SYNC:
+            generator_bad(scan, node, "sync");
+            break;
+        case NODE_FUNCCALL:
+            if (node->funccall.spawn) generator_bad(scan, node, "spawn");
+            if (strcmp(node->funccall.id, scan->id) == 0) generator_bad(scan, node, "llamadas a sí mismo");
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                scan_generator(node->funccall.args[i], scan, in_parallel);
+            break;
+        case NODE_ASSIGN:
+            scan_generator(node->assign.value, scan, in_parallel);
+            break;
+        case NODE_BINOP:
+            scan_generator(node->binop.left, scan, in_parallel);
+            scan_generator(node->binop.right, scan, in_parallel);
+            break;
+        case NODE_PRINT:
+            scan_generator(node->print.value, scan, in_parallel);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            scan_generator(node->index.index, scan, in_parallel);
+            scan_generator(node->index.value, scan, in_parallel);
+            break;
+        case NODE_IF:
+            scan_generator(node->ifstmt.cond, scan, in_parallel);
+            scan_generator(node->ifstmt.then_branch, scan, in_parallel);
+            scan_generator(node->ifstmt.else_branch, scan, in_parallel);
+            break;
+        case NODE_WHILE:
+            scan_generator(node->whilestmt.cond, scan, in_parallel);
+            scan_generator(node->whilestmt.body, scan, in_parallel);
+            break;
+        case NODE_FOR:
+            scan_generator(node->forstmt.init, scan, in_parallel);
+            scan_generator(node->forstmt.cond, scan, in_parallel);
+            scan_generator(node->forstmt.update, scan, in_parallel);
+            scan_generator(node->forstmt.body, scan, in_parallel || node->forstmt.parallel);
+            break;
+        case NODE_FOR_IN:
+            if (node->forin.map) generator_bad(scan, node, "recorrer maps");
+            if (node->forin.call) scan_generator(node->forin.call, scan, in_parallel);
+            scan_generator(node->forin.body, scan, in_parallel);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                scan_generator(node->block.stmts[i], scan, in_parallel);
+            break;
+        case NODE_RETURN:
+            scan_generator(node->returnstmt.value, scan, in_parallel);
+            break;
+        default:
+            break;
+    }
+}
+
+// Una función con yield es un generador: sus parámetros y locales pasan al frame que
+// conserva su estado entre un valor y el siguiente, así que solo pueden ser escalares o
+// arreglos integer y floating, y no lanza tareas ni se llama a sí misma.
 ASTNode* make_funcdef_node(const char* id, ASTNode** params, int param_count, ASTNode* body, ASTNode* return_expr) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_FUNCDEF;
+    GeneratorScan scan = { id, 0, NODE_INT, NULL, NULL };
+    scan_generator(body, &scan, 0);
+    if (scan.yields) {
+        for (int i = 0; i < param_count; ++i)
+            if (params[i]->decl.decl_type == NODE_STRING || params[i]->decl.is_channel)
+                generator_bad(&scan, params[i], "parámetros que no sean integer o floating");
+        if (return_expr->data_type == NODE_STRING)
+            generator_bad(&scan, return_expr, "devolver una chain");
+        if (scan.bad) {
+            fprintf(stderr, "Error en la línea %d: el generador '%s' no admite %s.\n",
+                    scan.bad->line, id, scan.reason);
+            exit(1);
+        }
+    }
+
+    ASTNode* node = new_node(NODE_FUNCDEF);
     node->funcdef.id = strdup(id);
     node->funcdef.params = params;
     node->funcdef.param_count = param_count;
@@ -198,18 +769,167 @@ ASTNode* make_funcdef_node(const char* id, ASTNode** params, int param_count, AS
     return node;
 }
 
+static const Builtin builtins[] = {
+    { "len",   NODE_INT,    1, { NODE_STRING } },
+    { "sub",   NODE_STRING, 3, { NODE_STRING, NODE_INT, NODE_INT } },
+    { "find",  NODE_INT,    2, { NODE_STRING, NODE_STRING } },
+    { "count", NODE_INT,    2, { NODE_STRING, NODE_STRING } },
+    { "split", NODE_STRING, 3, { NODE_STRING, NODE_STRING, NODE_INT } },
+
+    { "len",   NODE_INT,     1, { NODE_VECTOR } },
+    { "push",  NODE_INT,     2, { NODE_VECTOR, NODE_ELEMENT } },
+    { "pop",   NODE_ELEMENT, 1, { NODE_VECTOR } },
+    { "fill",  NODE_INT,     3, { NODE_VECTOR, NODE_INT, NODE_ELEMENT } },
+    { "copy",  NODE_INT,     2, { NODE_VECTOR, NODE_VECTOR } },
+    { "sum",   NODE_ELEMENT, 1, { NODE_VECTOR } },
+    { "min",   NODE_ELEMENT, 1, { NODE_VECTOR } },
+    { "max",   NODE_ELEMENT, 1, { NODE_VECTOR } },
+
+    { "len",   NODE_INT,     1, { NODE_MAP } },
+    { "put",   NODE_INT,     3, { NODE_MAP, NODE_KEY, NODE_ELEMENT } },
+    { "get",   NODE_ELEMENT, 2, { NODE_MAP, NODE_KEY } },
+    { "has",   NODE_INT,     2, { NODE_MAP, NODE_KEY } },
+
+    { "send",  NODE_INT,     2, { NODE_CHANNEL, NODE_ELEMENT } },
+    { "recv",  NODE_ELEMENT, 1, { NODE_CHANNEL } },
+};
+
+#define BUILTIN_COUNT (sizeof(builtins) / sizeof(builtins[0]))
+
+const Builtin* get_builtin(const char* id) {
+    for (size_t i = 0; i < BUILTIN_COUNT; ++i)
+        if (strcmp(builtins[i].id, id) == 0) return &builtins[i];
+    return NULL;
+}
+
+// Primer vector, map o channel entre los argumentos, o NULL.
+static Symbol* container_arg(ASTNode** args, int arg_count) {
+    for (int i = 0; i < arg_count; ++i)
+        if (args[i]->data_type == NODE_VECTOR || args[i]->data_type == NODE_MAP ||
+            args[i]->data_type == NODE_CHANNEL)
+            return get_symbol(args[i]->sval);
+    return NULL;
+}
+
+// Tipo concreto de un parámetro de la firma: NODE_ELEMENT y NODE_KEY dependen del contenedor.
+static NodeType builtin_param_type(NodeType type, Symbol* container) {
+    if (type == NODE_ELEMENT) return container ? container->type : NODE_INT;
+    if (type == NODE_KEY) return container ? container->key_type : NODE_INT;
+    return type;
+}
+
+// Devuelve el índice del primer argumento que no encaja con la firma, o -1.
+static int builtin_mismatch(const Builtin* b, ASTNode** args, Symbol* container) {
+    NodeType element = builtin_param_type(NODE_ELEMENT, container);
+    for (int i = 0; i < b->arg_count; ++i) {
+        NodeType expected = builtin_param_type(b->arg_types[i], container);
+        if (args[i]->data_type != expected) return i;
+        if (expected == NODE_VECTOR && get_symbol(args[i]->sval)->type != element) return i;
+    }
+    return -1;
+}
+
+static const char* type_name(NodeType type) {
+    switch (type) {
+        case NODE_INT: return "integer";
+        case NODE_FLOAT: return "floating";
+        case NODE_STRING: return "chain";
+        case NODE_VECTOR: return "vector";
+        case NODE_MAP: return "map";
+        case NODE_RECORD: return "record";
+        case NODE_CHANNEL: return "channel";
+        default: return "desconocido";
+    }
+}
+
 ASTNode* make_funccall_node_with_args(const char* id, ASTNode** args, int arg_count) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_FUNCCALL;
+    ASTNode* node = new_node(NODE_FUNCCALL);
     node->funccall.id = strdup(id);
     node->funccall.args = args;
     node->funccall.arg_count = arg_count;
+
+    const Builtin* builtin = get_builtin(id);
+    if (builtin) {
+        Symbol* container = container_arg(args, arg_count);
+        NodeType element = builtin_param_type(NODE_ELEMENT, container);
+        const Builtin* candidate = NULL;
+        int bad_arg = -1;
+        for (const Builtin* b = builtin; b < builtins + BUILTIN_COUNT; ++b) {
+            if (strcmp(b->id, id) != 0 || b->arg_count != arg_count) continue;
+            int mismatch = builtin_mismatch(b, args, container);
+            if (mismatch < 0) {
+                node->data_type = builtin_param_type(b->return_type, container);
+                return node;
+            }
+            if (!candidate) {
+                candidate = b;
+                bad_arg = mismatch;
+            }
+        }
+        if (!candidate) {
+            fprintf(stderr, "Error: '%s' espera %d argumento(s).\n", id, builtin->arg_count);
+            exit(1);
+        }
+        NodeType expected = builtin_param_type(candidate->arg_types[bad_arg], container);
+        if (expected == NODE_VECTOR && args[bad_arg]->data_type == NODE_VECTOR)
+            fprintf(stderr, "Error: el argumento %d de '%s' debe ser un vector de %s.\n",
+                    bad_arg + 1, id, type_name(element));
+        else
+            fprintf(stderr, "Error: el argumento %d de '%s' debe ser %s.\n",
+                    bad_arg + 1, id, type_name(expected));
+        exit(1);
+    }
+
+    for (int i = 0; i < arg_count; ++i) {
+        if (args[i]->data_type == NODE_VECTOR || args[i]->data_type == NODE_MAP) {
+            fprintf(stderr, "Error: no se puede pasar el %s '%s' a '%s'.\n",
+                    type_name(args[i]->data_type), args[i]->sval, id);
+            exit(1);
+        }
+    }
+
+    FunctionEntry* f = get_function_entry(id);
+    if (f && f->generator) {
+        fprintf(stderr, "Error en la línea %d: '%s' es un generador; recórralo con for (x in %s(...)).\n",
+                node->line, id, id);
+        exit(1);
+    }
+    node->data_type = (f && f->return_expr) ? f->return_expr->data_type : NODE_INT;
+    return node;
+}
+
+// spawn f(...); o id = spawn f(...);
+ASTNode* make_spawn_node(const char* id, ASTNode* call) {
+    if (get_builtin(call->funccall.id)) {
+        fprintf(stderr, "Error en la línea %d: spawn solo admite llamadas a funciones del programa.\n",
+                call->line);
+        exit(1);
+    }
+    call->funccall.spawn = 1;
+    return id ? make_assign_node(id, call) : call;
+}
+
+ASTNode* make_sync_node(void) {
+    return new_node(NODE_SYNC);
+}
+
+ASTNode* make_yield_node(ASTNode* expr) {
+    if (expr->data_type != NODE_INT && expr->data_type != NODE_FLOAT) {
+        fprintf(stderr, "Error en la línea %d: yield solo entrega valores integer o floating.\n", expr->line);
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_YIELD);
+    node->data_type = expr->data_type;
+    node->yieldstmt.value = expr;
     return node;
 }
 
 ASTNode* make_return_node(ASTNode* expr) {
-    ASTNode* node = malloc(sizeof(ASTNode));
-    node->type = NODE_RETURN;
+    if (expr->data_type == NODE_VECTOR || expr->data_type == NODE_MAP || expr->data_type == NODE_CHANNEL) {
+        fprintf(stderr, "Error: una función no puede devolver un %s.\n", type_name(expr->data_type));
+        exit(1);
+    }
+    ASTNode* node = new_node(NODE_RETURN);
     node->data_type = expr->data_type;
     node->returnstmt.value = expr;
     return node;
@@ -231,19 +951,37 @@ void print_ast(ASTNode* node, int indent) {
 FunctionEntry* function_table = NULL;
 
 void add_function(const char* id, ASTNode** params, int param_count, ASTNode* body, ASTNode* return_expr) {
+    if (get_builtin(id)) {
+        fprintf(stderr, "Error: '%s' es una función integrada y no se puede redefinir.\n", id);
+        exit(1);
+    }
     FunctionEntry* f = malloc(sizeof(FunctionEntry));
     f->id = strdup(id);
     f->params = params;
     f->param_count = param_count;
     f->body = body;
     f->return_expr = return_expr;
+    GeneratorScan scan = { id, 0, NODE_INT, NULL, NULL };
+    scan_generator(body, &scan, 0);
+    f->generator = scan.yields > 0;
+    f->yield_type = scan.yield_type;
+    f->callees = NULL;
+    f->callee_count = 0;
+    f->effect = EFFECT_WRITES;
+    f->effect_reason = "sin analizar";
+    f->may_fail = 1;
     f->next = function_table;
     function_table = f;
 }
 
-ASTNode* get_function(const char* id) {
+FunctionEntry* get_function_entry(const char* id) {
     for (FunctionEntry* f = function_table; f; f = f->next)
         if (strcmp(f->id, id) == 0)
-            return f->body;
+            return f;
     return NULL;
 }
+
+ASTNode* get_function(const char* id) {
+    FunctionEntry* f = get_function_entry(id);
+    return f ? f->body : NULL;
+}
@@ -21,12 +21,40 @@ typedef enum {
     NODE_DECL,
     NODE_FUNCDEF,
     NODE_FUNCCALL,
-    NODE_RETURN
+    NODE_RETURN,
+    NODE_INLINED,
+    NODE_INDEX,
+    NODE_INDEX_ASSIGN,
+    NODE_FOR_IN,
+    NODE_SYNC,
+    NODE_YIELD,
+    // Solo como tipo: una variable vector, map, record o channel y, en las firmas de las
+    // funciones integradas, el tipo de los elementos (o valores) y de las claves de ese
+    // contenedor.
+    NODE_VECTOR,
+    NODE_MAP,
+    NODE_RECORD,
+    NODE_CHANNEL,
+    NODE_ELEMENT,
+    NODE_KEY
 } NodeType;
 
+// Una reducción de un ciclo contado: acc = acc op ... con op '+' o '*', o el mínimo ('<') o
+// el máximo ('>') de expr. En '+' y '*' expr es el lado derecho completo, donde acc aparece
+// una sola vez.
+typedef struct {
+    char* acc;
+    char op;
+    struct ASTNode* expr;
+} Reduction;
+
 typedef struct ASTNode {
     NodeType type;
     NodeType data_type;
+    int line;
+    // En un NODE_FLOAT que sale de evaluar una llamada en compilación: se emite exacto y como
+    // float (los literales del programa se emiten con %f y son double).
+    int folded;
 
     union {
         int ival;
@@ -35,7 +63,7 @@ typedef struct ASTNode {
 
         struct { struct ASTNode* value; } print;
 
-        struct { char* op; struct ASTNode* left; struct ASTNode* right; } binop;
+        struct { char* op; struct ASTNode* left; struct ASTNode* right; int nonzero_divisor; } binop;
 
         struct { char* id; struct ASTNode* value; } assign;
 
@@ -43,11 +71,47 @@ typedef struct ASTNode {
 
         struct { struct ASTNode* cond; struct ASTNode* body; } whilestmt;
 
-        struct { struct ASTNode* init; struct ASTNode* cond; struct ASTNode* update; struct ASTNode* body; } forstmt;
+        // parallel: las iteraciones se reparten entre hilos; captures son las variables de
+        // afuera que usa el cuerpo y reductions sus acumuladores (los anota analyze_parallel,
+        // que también marca simd si el ciclo es solo reducciones vectorizables).
+        struct {
+            struct ASTNode* init;
+            struct ASTNode* cond;
+            struct ASTNode* update;
+            struct ASTNode* body;
+            int parallel;
+            struct Symbol** captures;
+            int capture_count;
+            Reduction* reductions;
+            int reduction_count;
+            int simd;
+        } forstmt;
 
         struct { struct ASTNode** stmts; int stmt_count; } block;
 
-        struct { char* id; NodeType decl_type; } decl;
+        // array_size 0: escalar. En un map, decl_type es el tipo de los valores. En un record
+        // (o arreglo de records) decl_type es NODE_RECORD y soa pide un arreglo por campo.
+        // En un channel decl_type es el tipo de los mensajes y array_size la capacidad (0 en
+        // un parámetro); spsc lo marca analyze_parallel si a lo sumo una tarea envía y una
+        // recibe.
+        struct {
+            char* id;
+            NodeType decl_type;
+            int array_size;
+            int is_vector;
+            int is_map;
+            NodeType key_type;
+            struct RecordType* record;
+            int soa;
+            int is_channel;
+            int spsc;
+            // Un arreglo del programa principal llenado en compilación: sus primeros
+            // init_count valores (literales); el resto queda en cero.
+            struct ASTNode** init;
+            int init_count;
+        } decl;
+
+        struct { char** ids; int id_count; int returns_status; } read;
 
         struct {
             char* id;
@@ -57,13 +121,38 @@ typedef struct ASTNode {
             struct ASTNode* return_expr;
         } funcdef;
 
+        // spawn: la llamada corre como tarea y el sync de la función que la lanzó la espera;
+        // en x = spawn f(...) el nodo es el valor de un NODE_ASSIGN.
         struct {
             char* id;
             struct ASTNode** args;
             int arg_count;
+            int spawn;
         } funccall;
 
         struct { struct ASTNode* value; } returnstmt;
+
+        // yield value: dentro de un generador, entrega value al ciclo que lo recorre.
+        struct { struct ASTNode* value; } yieldstmt;
+
+        struct { char* id; struct ASTNode* body; struct ASTNode* result; } inlined;
+
+        // v[i] (value == NULL) y v[i] = value; in_bounds: el análisis de rangos probó 0 <= i < size.
+        // En un vector size es 0: el límite es su largo actual. Con field es el campo de un
+        // record: v[i].campo, o r.campo si index es NULL; soa indica el layout del arreglo.
+        struct {
+            char* id;
+            struct ASTNode* index;
+            struct ASTNode* value;
+            int size;
+            int in_bounds;
+            char* field;
+            int soa;
+        } index;
+
+        // for (key in map) body, o for (key in g(...)) body con call la llamada al generador
+        // (map es NULL) e iter el nombre de su frame en el código generado.
+        struct { char* key; char* map; struct ASTNode* body; struct ASTNode* call; char* iter; } forin;
     };
 } ASTNode;
 
@@ -75,42 +164,155 @@ ASTNode* make_id_node(const char* name);
 ASTNode* make_binop_node(const char* op, ASTNode* left, ASTNode* right);
 ASTNode* make_assign_node(const char* id, ASTNode* value);
 ASTNode* make_print_node(ASTNode* expr);
-ASTNode* make_read_node(const char* id, int dummy);
+ASTNode* make_read_node(char** ids, int id_count, int returns_status);
 ASTNode* make_decl_node(const char* id, NodeType decl_type);
+ASTNode* make_array_decl_node(const char* id, NodeType elem_type, int size);
+ASTNode* make_vector_decl_node(const char* id, NodeType elem_type);
+ASTNode* make_map_decl_node(const char* id, NodeType key_type, NodeType value_type);
+ASTNode* make_for_in_node(const char* key, const char* map, ASTNode* body);
+ASTNode* make_for_generator_node(const char* key, const char* id, ASTNode** args, int arg_count, ASTNode* body);
+ASTNode* make_index_node(const char* id, ASTNode* index);
+ASTNode* make_index_assign_node(const char* id, ASTNode* index, ASTNode* value);
+ASTNode* make_record_decl_node(const char* id);
+ASTNode* make_channel_decl_node(const char* id, NodeType elem_type, int capacity);
+ASTNode* make_channel_param_node(const char* id, NodeType elem_type);
+ASTNode* make_field_node(const char* id, ASTNode* index, const char* field);
+ASTNode* make_field_assign_node(const char* id, ASTNode* index, const char* field, ASTNode* value);
 ASTNode* make_if_node(ASTNode* cond, ASTNode* then_branch, ASTNode* else_branch);
 ASTNode* make_while_node(ASTNode* cond, ASTNode* body);
 ASTNode* make_for_node(ASTNode* init, ASTNode* cond, ASTNode* update, ASTNode* body);
+ASTNode* make_parallel_for_node(ASTNode* init, ASTNode* cond, ASTNode* update, ASTNode* body);
 ASTNode* make_funcdef_node(const char* id, ASTNode** params, int param_count, ASTNode* body, ASTNode* return_expr);
 ASTNode* make_funccall_node_with_args(const char* id, ASTNode** args, int arg_count);
+ASTNode* make_spawn_node(const char* id, ASTNode* call);
+ASTNode* make_sync_node(void);
 ASTNode* make_return_node(ASTNode* expr);
+ASTNode* make_yield_node(ASTNode* expr);
 void print_ast(ASTNode* node, int indent);
 void generate_code(FILE* out, ASTNode* node);
 
 // Tabla de símbolos
 typedef struct Symbol {
     char* id;
-    NodeType type;
+    NodeType type;      // en los arreglos, el tipo de los elementos
+    int array_size;     // 0 si no es un arreglo
+    int is_vector;      // vector de largo variable; type es el de sus elementos
+    int is_map;         // map de key_type a type
+    NodeType key_type;
+    struct RecordType* record;  // record o arreglo de records (type es NODE_RECORD)
+    int soa;
+    int is_channel;     // channel de mensajes de tipo type
     struct Symbol* next;
 } Symbol;
 
 extern Symbol* symbol_table;
 void add_symbol(const char* id, NodeType type);
+void add_array_symbol(const char* id, NodeType elem_type, int size);
+void add_vector_symbol(const char* id, NodeType elem_type);
+void add_map_symbol(const char* id, NodeType key_type, NodeType value_type);
+void add_record_symbol(const char* id, const char* record, int size, const char* layout);
+void add_channel_symbol(const char* id, NodeType elem_type);
 Symbol* get_symbol(const char* id);
 NodeType get_symbol_type(const char* id);
 
-// Tabla de funciones
+// Tabla de records: cada campo es una declaración escalar integer o floating.
+typedef struct RecordType {
+    char* id;
+    ASTNode** fields;
+    int field_count;
+    struct RecordType* next;
+} RecordType;
+
+extern RecordType* record_table;
+void add_record(const char* id, ASTNode** fields, int field_count);
+RecordType* get_record(const char* id);
+
+// Tabla de funciones. Un generador (una función con yield) no se llama: se recorre con
+// for (x in g(...)) y entrega valores de tipo yield_type.
+// Efectos de una función vistos desde quien la llama (los calcula analyze_effects).
+// EFFECT_PURE: el resultado depende solo de los argumentos y no toca nada de afuera.
+// EFFECT_READ_ONLY: además lee memoria del runtime (cadenas), sin cambiar nada visible.
+// EFFECT_WRITES: hace E/S, usa channels o tareas, o escribe memoria de quien la llama.
+typedef enum { EFFECT_PURE, EFFECT_READ_ONLY, EFFECT_WRITES } Effect;
+
 typedef struct FunctionEntry {
     char* id;
     ASTNode** params;
     int param_count;
     ASTNode* body;
     ASTNode* return_expr;
+    int generator;
+    NodeType yield_type;
+    // Grafo de llamadas y efectos; may_fail: puede terminar el programa con un error.
+    struct FunctionEntry** callees;
+    int callee_count;
+    Effect effect;
+    const char* effect_reason;
+    int may_fail;
     struct FunctionEntry* next;
 } FunctionEntry;
 
 extern FunctionEntry* function_table;
 void add_function(const char* id, ASTNode** params, int param_count, ASTNode* body, ASTNode* return_expr);
 ASTNode* get_function(const char* id);
+FunctionEntry* get_function_entry(const char* id);
 void generate_all_functions(FILE* out);
 
+// Funciones integradas sobre cadenas y vectores: se reconocen al armar la llamada. Un mismo
+// nombre puede tener varias firmas (len sirve para chain, vector y map).
+#define MAX_BUILTIN_ARGS 3
+typedef struct Builtin {
+    const char* id;
+    NodeType return_type;
+    int arg_count;
+    NodeType arg_types[MAX_BUILTIN_ARGS];
+} Builtin;
+
+const Builtin* get_builtin(const char* id);
+
+// Inliner
+#define DEFAULT_INLINE_THRESHOLD 16
+extern int inline_threshold;
+void inline_functions(ASTNode* root);
+
+// Runtime del programa generado
+#define RT_OUTPUT (1u << 0)
+#define RT_INPUT  (1u << 1)
+#define RT_SYNC   (1u << 2)
+#define RT_ASYNC_INPUT (1u << 3)
+#define RT_CHAIN  (1u << 4)
+#define RT_ARRAY  (1u << 5)
+#define RT_VECTOR (1u << 6)
+#define RT_MAP    (1u << 7)
+#define RT_PARALLEL (1u << 8)
+#define RT_CHANNEL (1u << 9)
+extern unsigned runtime_features;
+extern int async_input;
+void emit_runtime(FILE* out, unsigned features);
+void generate_program(FILE* out, ASTNode* root);
+
+// Análisis de rangos (marca divisiones con divisor distinto de cero)
+void analyze_ranges(ASTNode* root);
+
+// Parallel for: rechaza los cuerpos que no se pueden repartir entre hilos y anota las
+// variables que captura cada uno. También detecta las reducciones de los ciclos contados
+// y las convierte en ciclos SIMD o en parallel for, revisa las funciones que se lanzan con
+// spawn y cierra con un sync el cuerpo de las funciones que lanzan tareas. Por último
+// revisa los channels pasados a funciones y marca los que usan una sola tarea de cada lado.
+void analyze_parallel(ASTNode* root);
+int is_counted_loop(ASTNode* init, ASTNode* cond, ASTNode* update);
+
+// Efectos: arma el grafo de llamadas y clasifica cada función (con --stats lo informa).
+// effect_attribute da el atributo de gcc que admite una función (const o pure) o NULL.
+extern int show_stats;
+void analyze_effects(void);
+const char* effect_attribute(FunctionEntry* f);
+
+// Evaluación en compilación: reemplaza por su resultado las llamadas a funciones puras con
+// argumentos constantes y los ciclos del programa principal que solo llenan arreglos.
+// eval_budget es el máximo de pasos del intérprete por intento (0 la desactiva).
+#define DEFAULT_EVAL_BUDGET 1000000
+extern int eval_budget;
+void evaluate_calls(ASTNode* root);
+
 #endif
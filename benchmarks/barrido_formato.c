@@ -0,0 +1,68 @@
+// Compara dpp_fmt_int y dpp_fmt_float del runtime con snprintf("%d") y snprintf("%f").
+// Se compila incluyendo un output.c generado (ver barrido_formato.sh); termina con 1 si
+// algún valor difiere.
+#define main dpp_programa
+#include SALIDA
+#undef main
+
+#include <limits.h>
+
+static char got[600], want[600];
+static long checked = 0;
+static long mismatches = 0;
+
+static void check_int(int v) {
+    *dpp_fmt_int(got, v) = '\0';
+    snprintf(want, sizeof(want), "%d", v);
+    checked++;
+    if (strcmp(got, want) != 0 && mismatches++ < 10)
+        printf("integer %d: %s en lugar de %s\n", v, got, want);
+}
+
+static void check_float(float v) {
+    *dpp_fmt_float(got, v) = '\0';
+    snprintf(want, sizeof(want), "%f", v);
+    checked++;
+    if (strcmp(got, want) != 0 && mismatches++ < 10)
+        printf("floating %a: %s en lugar de %s\n", v, got, want);
+}
+
+int main(void) {
+    // Enteros: los extremos, las potencias de 10 y sus vecinos, un tramo alrededor de 0 y
+    // valores pseudoaleatorios.
+    check_int(INT_MAX);
+    check_int(INT_MIN);
+    check_int(INT_MIN + 1);
+    for (long long p = 1; p <= INT_MAX; p *= 10) {
+        check_int((int)p);
+        check_int((int)p - 1);
+        check_int((int)-p);
+        check_int((int)(1 - p));
+    }
+    for (int i = -1000000; i <= 1000000; ++i) check_int(i);
+    uint32_t x = 2463534242u;
+    for (int i = 0; i < 5000000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        check_int((int)x);
+    }
+
+    // Floats: todos los patrones de bits con un paso impar (cubre subnormales, infinitos y
+    // NaN), y valores decimales cercanos al redondeo de 6 decimales.
+    for (uint64_t bits = 0; bits < 0x100000000ull; bits += 997) {
+        uint32_t b = (uint32_t)bits;
+        float f;
+        memcpy(&f, &b, sizeof(f));
+        check_float(f);
+    }
+    for (int i = -100000; i <= 100000; ++i) {
+        check_float(i / 1000.0f);
+        check_float(i * 0.37f);
+        check_float(i + 0.5f);
+        check_float(i * 0.0000005f);
+    }
+
+    printf("barrido de formato: %ld valores, %ld diferencia(s)\n", checked, mismatches);
+    return mismatches != 0;
+}
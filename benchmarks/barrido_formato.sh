@@ -0,0 +1,18 @@
+#!/bin/sh
+# Barrido de corrección del formato de números del runtime contra printf.
+# Uso: sh benchmarks/barrido_formato.sh   (sale con error si algún valor difiere)
+set -e
+cd "$(dirname "$0")/.."
+ROOT=$(pwd)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+gcc parser.tab.c lex.yy.c ast_c.c generarCodigo.c expandirLlamadas.c analizarRangos.c analizarParalelo.c analizarEfectos.c evaluarLlamadas.c emitirRuntime.c \
+    -o "$TMP/dpp_compiler" -lm
+
+# Un programa que imprime enteros y floating trae dpp_fmt_int y dpp_fmt_float en output.c.
+printf 'integer n;\nfloating f;\nn = 1;\nf = 1.5;\nprint n;\nprint f;\n' > "$TMP/formato.dpp"
+(cd "$TMP" && ./dpp_compiler < formato.dpp > /dev/null)
+gcc -O2 -DSALIDA="\"$TMP/output.c\"" benchmarks/barrido_formato.c -o "$TMP/barrido" -lm
+"$TMP/barrido"
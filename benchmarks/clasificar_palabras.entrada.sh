@@ -0,0 +1,7 @@
+#!/bin/sh
+# 10^7 métodos HTTP, uno por línea.
+awk 'BEGIN {
+    split("GET POST PUT DELETE HEAD OPTIONS GET GET", m, " ");
+    srand(7);
+    for (i = 0; i < 10000000; i++) print m[int(rand() * 8) + 1];
+}'
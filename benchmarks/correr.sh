@@ -0,0 +1,32 @@
+#!/bin/sh
+# Compila el compilador y mide cada benchmark de esta carpeta.
+# Uso: sh benchmarks/correr.sh [nombre]   (por ejemplo: imprimir_enteros)
+set -e
+cd "$(dirname "$0")/.."
+ROOT=$(pwd)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+gcc parser.tab.c lex.yy.c ast_c.c generarCodigo.c expandirLlamadas.c analizarRangos.c analizarParalelo.c analizarEfectos.c evaluarLlamadas.c emitirRuntime.c \
+    -o "$TMP/dpp_compiler" -lm
+
+for src in benchmarks/${1:-*}.dpp; do
+    name=$(basename "$src" .dpp)
+    (cd "$TMP" && ./dpp_compiler < "$ROOT/$src" > /dev/null)
+    gcc -O2 "$TMP/output.c" -o "$TMP/$name" -lm -pthread
+    input=/dev/null
+    if [ -f "benchmarks/$name.entrada.sh" ]; then
+        input="$TMP/$name.in"
+        sh "benchmarks/$name.entrada.sh" > "$input"
+    fi
+    # NOMBRE.entorno: variables de entorno para el programa, por ejemplo DPP_CHAN_STATS=1.
+    vars=
+    if [ -f "benchmarks/$name.entorno" ]; then
+        vars=$(cat "benchmarks/$name.entorno")
+    fi
+    start=$(date +%s%N)
+    env $vars "$TMP/$name" < "$input" > /dev/null
+    end=$(date +%s%N)
+    echo "$name: $(( (end - start) / 1000000 )) ms"
+done
@@ -0,0 +1,3 @@
+#!/bin/sh
+# Entrada para filtrar_registros.dpp: 10^7 registros "id valor peso".
+awk 'BEGIN { for (i = 1; i <= 10000000; i++) printf "%d %d %d.%02d\n", i, (i * 7919) % 1000, i % 100, i % 97 }'
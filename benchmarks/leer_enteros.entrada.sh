@@ -0,0 +1,4 @@
+#!/bin/sh
+# Entrada para leer_enteros.dpp: 10^7 enteros, uno por línea.
+echo 10000000
+seq 1 10000000
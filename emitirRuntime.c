@@ -0,0 +1,2507 @@
+#include <stdio.h>
+#include "ast_c.h"
+
+// Fragmentos del runtime que se copian al comienzo de output.c.
+
+static const char runtime_header[] =
+    "#ifndef _GNU_SOURCE\n"
+    "#define _GNU_SOURCE   // mremap\n"
+    "#endif\n"
+    "#include <stdio.h>\n"
+    "#include <string.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <errno.h>\n"
+    "#include <stdint.h>\n"
+    "#ifdef _WIN32\n"
+    "#include <io.h>\n"
+    "#else\n"
+    "#include <unistd.h>\n"
+    "#include <sys/mman.h>\n"
+    "#include <sys/stat.h>\n"
+    "#endif\n"
+    "\n"
+    "#define DPP_RT static __attribute__((unused))\n";
+
+static const char runtime_format[] =
+    "/* ---- Formato de números ---- */\n"
+    "\n"
+    "static const char dpp_digits2[201] =\n"
+    "    \"00010203040506070809101112131415161718192021222324252627282930313233343536373839\"\n"
+    "    \"40414243444546474849505152535455565758596061626364656667686970717273747576777879\"\n"
+    "    \"8081828384858687888990919293949596979899\";\n"
+    "\n"
+    "static const uint64_t dpp_pow10[20] = {\n"
+    "    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,\n"
+    "    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,\n"
+    "    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,\n"
+    "    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull\n"
+    "};\n"
+    "\n"
+    "// Número de dígitos decimales sin ciclos: log10 aproximado con clz y una corrección.\n"
+    "static inline int dpp_count_digits(uint64_t u) {\n"
+    "    uint64_t v = u | 1;\n"
+    "    int t = ((64 - __builtin_clzll(v)) * 1233) >> 12;\n"
+    "    return t - (v < dpp_pow10[t]) + 1;\n"
+    "}\n"
+    "\n"
+    "// Escribe u con exactamente `len` dígitos hacia atrás desde p + len, de a dos dígitos.\n"
+    "static inline void dpp_write_digits(char* p, uint64_t u, int len) {\n"
+    "    char* end = p + len;\n"
+    "    while (u >= 100) {\n"
+    "        uint64_t q = u / 100;\n"
+    "        end -= 2;\n"
+    "        memcpy(end, dpp_digits2 + (u - q * 100) * 2, 2);\n"
+    "        u = q;\n"
+    "    }\n"
+    "    if (u >= 10) {\n"
+    "        end -= 2;\n"
+    "        memcpy(end, dpp_digits2 + u * 2, 2);\n"
+    "    } else {\n"
+    "        *--end = (char)('0' + u);\n"
+    "    }\n"
+    "    while (end > p) *--end = '0';\n"
+    "}\n"
+    "\n"
+    "static inline char* dpp_fmt_u64(char* p, uint64_t u) {\n"
+    "    int len = dpp_count_digits(u);\n"
+    "    dpp_write_digits(p, u, len);\n"
+    "    return p + len;\n"
+    "}\n"
+    "\n"
+    "static inline char* dpp_fmt_int(char* p, int v) {\n"
+    "    uint32_t u = (uint32_t)v;\n"
+    "    if (v < 0) {\n"
+    "        *p++ = '-';\n"
+    "        u = 0u - u;\n"
+    "    }\n"
+    "    return dpp_fmt_u64(p, u);\n"
+    "}\n"
+    "\n"
+    "// Igual que printf(\"%f\", v): el float es exactamente m * 2^e, así que v * 10^6 se\n"
+    "// calcula en enteros y se redondea al par más cercano como glibc.\n"
+    "static inline char* dpp_fmt_float(char* p, float v) {\n"
+    "    uint32_t bits;\n"
+    "    memcpy(&bits, &v, sizeof(bits));\n"
+    "    uint32_t exp_bits = (bits >> 23) & 0xff;\n"
+    "    uint64_t m = bits & 0x7fffff;\n"
+    "    int e;\n"
+    "\n"
+    "    if (exp_bits == 0xff) return p + sprintf(p, \"%f\", v);\n"
+    "    if (exp_bits == 0) {\n"
+    "        e = -149;\n"
+    "    } else {\n"
+    "        m |= 0x800000;\n"
+    "        e = (int)exp_bits - 150;\n"
+    "    }\n"
+    "    if (e > 40) return p + sprintf(p, \"%f\", v);\n"
+    "\n"
+    "    if (bits >> 31) *p++ = '-';\n"
+    "\n"
+    "    uint64_t int_part, frac;\n"
+    "    if (e >= 0) {\n"
+    "        int_part = m << e;\n"
+    "        frac = 0;\n"
+    "    } else {\n"
+    "        int k = -e;\n"
+    "        uint64_t scaled = m * 1000000u;\n"
+    "        uint64_t q = 0;\n"
+    "        if (k < 64) {\n"
+    "            q = scaled >> k;\n"
+    "            uint64_t rem = scaled - (q << k);\n"
+    "            uint64_t half = 1ull << (k - 1);\n"
+    "            if (rem > half || (rem == half && (q & 1))) q++;\n"
+    "        }\n"
+    "        int_part = q / 1000000u;\n"
+    "        frac = q - int_part * 1000000u;\n"
+    "    }\n"
+    "\n"
+    "    p = dpp_fmt_u64(p, int_part);\n"
+    "    *p++ = '.';\n"
+    "    dpp_write_digits(p, frac, 6);\n"
+    "    return p + 6;\n"
+    "}\n";
+
+static const char runtime_output[] =
+    "/* ---- Salida con búfer ---- */\n"
+    "#define DPP_OUT_CAP (1 << 20)\n"
+    "\n"
+    "static char dpp_out_buf[DPP_OUT_CAP];\n"
+    "static size_t dpp_out_len = 0;\n"
+    "static int dpp_out_tty = 0;\n"
+    "\n"
+    "DPP_RT void dpp_out_raw(const char* s, size_t n) {\n"
+    "#ifdef _WIN32\n"
+    "    fwrite(s, 1, n, stdout);\n"
+    "    fflush(stdout);\n"
+    "#else\n"
+    "    while (n > 0) {\n"
+    "        ssize_t w = write(1, s, n);\n"
+    "        if (w < 0) {\n"
+    "            if (errno == EINTR) continue;\n"
+    "            return;\n"
+    "        }\n"
+    "        s += w;\n"
+    "        n -= (size_t)w;\n"
+    "    }\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_flush(void) {\n"
+    "    dpp_out_raw(dpp_out_buf, dpp_out_len);\n"
+    "    dpp_out_len = 0;\n"
+    "}\n"
+    "\n"
+    "static inline char* dpp_out_reserve(size_t n) {\n"
+    "    if (dpp_out_len + n > DPP_OUT_CAP) dpp_flush();\n"
+    "    return dpp_out_buf + dpp_out_len;\n"
+    "}\n"
+    "\n"
+    "// En una terminal se vacía en cada línea, igual que stdout con búfer de línea.\n"
+    "static inline void dpp_out_end_line(void) {\n"
+    "    if (dpp_out_tty) dpp_flush();\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_write(const char* s, size_t n) {\n"
+    "    if (n > DPP_OUT_CAP / 2) {\n"
+    "        dpp_flush();\n"
+    "        dpp_out_raw(s, n);\n"
+    "        return;\n"
+    "    }\n"
+    "    memcpy(dpp_out_reserve(n), s, n);\n"
+    "    dpp_out_len += n;\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_print_literal(const char* s, size_t n) {\n"
+    "    dpp_write(s, n);\n"
+    "    dpp_out_end_line();\n"
+    "}\n"
+    "\n"
+    "#define DPP_PRINT_LIT(s) dpp_print_literal(s \"\\n\", sizeof(s \"\\n\") - 1)\n"
+    "\n"
+    "DPP_RT void dpp_print_int(int v) {\n"
+    "    char* p = dpp_fmt_int(dpp_out_reserve(16), v);\n"
+    "    *p++ = '\\n';\n"
+    "    dpp_out_len = (size_t)(p - dpp_out_buf);\n"
+    "    dpp_out_end_line();\n"
+    "}\n"
+    "\n"
+    "// Con %f un float ocupa a lo sumo 48 caracteres (FLT_MAX).\n"
+    "DPP_RT void dpp_print_float(float v) {\n"
+    "    char* p = dpp_fmt_float(dpp_out_reserve(64), v);\n"
+    "    *p++ = '\\n';\n"
+    "    dpp_out_len = (size_t)(p - dpp_out_buf);\n"
+    "    dpp_out_end_line();\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_runtime_init(void) {\n"
+    "#ifndef _WIN32\n"
+    "    dpp_out_tty = isatty(1);\n"
+    "#endif\n"
+    "    atexit(dpp_flush);\n"
+    "}\n";
+
+static const char runtime_search[] =
+    "/* ---- Búsqueda en cadenas (SSE2 / AVX2) ---- */\n"
+    "// El núcleo se elige una sola vez según CPUID. Para buscar una subcadena se filtran\n"
+    "// las posiciones cuyo primer y último byte coinciden, y solo esas se verifican con memcmp.\n"
+    "#define DPP_NOT_FOUND ((size_t)-1)\n"
+    "\n"
+    "typedef size_t (*dpp_find_fn)(const char*, size_t, const char*, size_t);\n"
+    "typedef size_t (*dpp_count_fn)(const char*, size_t, char);\n"
+    "\n"
+    "static size_t dpp_find_scalar(const char* h, size_t n, const char* s, size_t m) {\n"
+    "    if (m > n) return DPP_NOT_FOUND;\n"
+    "    const char* end = h + n - m + 1;\n"
+    "    for (const char* p = h; (p = memchr(p, s[0], (size_t)(end - p))); ++p)\n"
+    "        if (memcmp(p + 1, s + 1, m - 1) == 0) return (size_t)(p - h);\n"
+    "    return DPP_NOT_FOUND;\n"
+    "}\n"
+    "\n"
+    "static size_t dpp_count_scalar(const char* h, size_t n, char c) {\n"
+    "    size_t total = 0;\n"
+    "    for (size_t i = 0; i < n; ++i) total += h[i] == c;\n"
+    "    return total;\n"
+    "}\n"
+    "\n"
+    "#if defined(__x86_64__) || defined(__i386__)\n"
+    "#include <immintrin.h>\n"
+    "\n"
+    "static size_t dpp_find_sse2(const char* h, size_t n, const char* s, size_t m) {\n"
+    "    const __m128i first = _mm_set1_epi8(s[0]);\n"
+    "    const __m128i last = _mm_set1_epi8(s[m - 1]);\n"
+    "    size_t i = 0;\n"
+    "    for (; i + m - 1 + 16 <= n; i += 16) {\n"
+    "        __m128i a = _mm_loadu_si128((const __m128i*)(h + i));\n"
+    "        __m128i b = _mm_loadu_si128((const __m128i*)(h + i + m - 1));\n"
+    "        unsigned mask = (unsigned)_mm_movemask_epi8(\n"
+    "            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));\n"
+    "        for (; mask; mask &= mask - 1) {\n"
+    "            size_t pos = i + (size_t)__builtin_ctz(mask);\n"
+    "            if (memcmp(h + pos + 1, s + 1, m - 2) == 0) return pos;\n"
+    "        }\n"
+    "    }\n"
+    "    size_t rest = dpp_find_scalar(h + i, n - i, s, m);\n"
+    "    return rest == DPP_NOT_FOUND ? rest : i + rest;\n"
+    "}\n"
+    "\n"
+    "__attribute__((target(\"avx2\")))\n"
+    "static size_t dpp_find_avx2(const char* h, size_t n, const char* s, size_t m) {\n"
+    "    const __m256i first = _mm256_set1_epi8(s[0]);\n"
+    "    const __m256i last = _mm256_set1_epi8(s[m - 1]);\n"
+    "    size_t i = 0;\n"
+    "    for (; i + m - 1 + 32 <= n; i += 32) {\n"
+    "        __m256i a = _mm256_loadu_si256((const __m256i*)(h + i));\n"
+    "        __m256i b = _mm256_loadu_si256((const __m256i*)(h + i + m - 1));\n"
+    "        unsigned mask = (unsigned)_mm256_movemask_epi8(\n"
+    "            _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));\n"
+    "        for (; mask; mask &= mask - 1) {\n"
+    "            size_t pos = i + (size_t)__builtin_ctz(mask);\n"
+    "            if (memcmp(h + pos + 1, s + 1, m - 2) == 0) return pos;\n"
+    "        }\n"
+    "    }\n"
+    "    size_t rest = dpp_find_sse2(h + i, n - i, s, m);\n"
+    "    return rest == DPP_NOT_FOUND ? rest : i + rest;\n"
+    "}\n"
+    "\n"
+    "// Las comparaciones valen -1 por byte: se restan a contadores de 8 bits que se vuelcan\n"
+    "// con SAD antes de que puedan desbordarse (255 vueltas).\n"
+    "static size_t dpp_count_sse2(const char* h, size_t n, char c) {\n"
+    "    const __m128i needle = _mm_set1_epi8(c);\n"
+    "    __m128i total = _mm_setzero_si128();\n"
+    "    size_t i = 0;\n"
+    "    while (i + 16 <= n) {\n"
+    "        __m128i acc = _mm_setzero_si128();\n"
+    "        for (int k = 0; k < 255 && i + 16 <= n; ++k, i += 16)\n"
+    "            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(h + i)), needle));\n"
+    "        total = _mm_add_epi64(total, _mm_sad_epu8(acc, _mm_setzero_si128()));\n"
+    "    }\n"
+    "    size_t sum = (size_t)_mm_cvtsi128_si64(total) + (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total));\n"
+    "    return sum + dpp_count_scalar(h + i, n - i, c);\n"
+    "}\n"
+    "\n"
+    "__attribute__((target(\"avx2\")))\n"
+    "static size_t dpp_count_avx2(const char* h, size_t n, char c) {\n"
+    "    const __m256i needle = _mm256_set1_epi8(c);\n"
+    "    __m256i total = _mm256_setzero_si256();\n"
+    "    size_t i = 0;\n"
+    "    while (i + 32 <= n) {\n"
+    "        __m256i acc = _mm256_setzero_si256();\n"
+    "        for (int k = 0; k < 255 && i + 32 <= n; ++k, i += 32)\n"
+    "            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(h + i)), needle));\n"
+    "        total = _mm256_add_epi64(total, _mm256_sad_epu8(acc, _mm256_setzero_si256()));\n"
+    "    }\n"
+    "    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));\n"
+    "    size_t sum = (size_t)_mm_cvtsi128_si64(half) + (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half));\n"
+    "    return sum + dpp_count_sse2(h + i, n - i, c);\n"
+    "}\n"
+    "#endif\n"
+    "\n"
+    "static dpp_find_fn dpp_find_impl;\n"
+    "static dpp_count_fn dpp_count_impl;\n"
+    "\n"
+    "static void dpp_search_init(void) {\n"
+    "    dpp_find_impl = dpp_find_scalar;\n"
+    "    dpp_count_impl = dpp_count_scalar;\n"
+    "#if defined(__x86_64__) || defined(__i386__)\n"
+    "    __builtin_cpu_init();\n"
+    "    if (__builtin_cpu_supports(\"avx2\")) {\n"
+    "        dpp_find_impl = dpp_find_avx2;\n"
+    "        dpp_count_impl = dpp_count_avx2;\n"
+    "    } else if (__builtin_cpu_supports(\"sse2\")) {\n"
+    "        dpp_find_impl = dpp_find_sse2;\n"
+    "        dpp_count_impl = dpp_count_sse2;\n"
+    "    }\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "// Posición de s (m bytes) en h (n bytes), o DPP_NOT_FOUND.\n"
+    "DPP_RT size_t dpp_search(const char* h, size_t n, const char* s, size_t m) {\n"
+    "    if (m == 0) return 0;\n"
+    "    if (m > n) return DPP_NOT_FOUND;\n"
+    "    if (m == 1) {\n"
+    "        const char* p = memchr(h, s[0], n);\n"
+    "        return p ? (size_t)(p - h) : DPP_NOT_FOUND;\n"
+    "    }\n"
+    "    if (!dpp_find_impl) dpp_search_init();\n"
+    "    return dpp_find_impl(h, n, s, m);\n"
+    "}\n"
+    "\n"
+    "DPP_RT size_t dpp_count_byte(const char* h, size_t n, char c) {\n"
+    "    if (!dpp_count_impl) dpp_search_init();\n"
+    "    return dpp_count_impl(h, n, c);\n"
+    "}\n";
+
+static const char runtime_region[] =
+    "/* ---- Región de temporales ---- */\n"
+    "// Memoria de bloques grandes obtenidos con mmap (2 MB, con páginas enormes si el kernel\n"
+    "// las da) que se reparte avanzando un puntero. Cada función de D++ y cada vuelta de un\n"
+    "// ciclo marcan un frame al entrar; al salir se vuelve a la marca en O(1). Solo los\n"
+    "// temporales de una sentencia viven aquí: nunca sobreviven a su frame.\n"
+    "#define DPP_CHUNK_SIZE ((size_t)2 << 20)\n"
+    "\n"
+    "typedef struct dpp_chunk {\n"
+    "    struct dpp_chunk* prev;\n"
+    "    size_t size;\n"
+    "} dpp_chunk;\n"
+    "\n"
+    "typedef struct {\n"
+    "    dpp_chunk* chunk;\n"
+    "    char* ptr;\n"
+    "} dpp_frame;\n"
+    "\n"
+    "static dpp_chunk* dpp_region_chunk;\n"
+    "static char* dpp_region_ptr;\n"
+    "static char* dpp_region_end;\n"
+    "static dpp_chunk* dpp_region_spare;   // bloques liberados, listos para reusar\n"
+    "\n"
+    "// Contadores (se informan al salir si existe la variable de entorno DPP_REGION_STATS).\n"
+    "static size_t dpp_region_bytes;       // bytes entregados en total\n"
+    "static size_t dpp_region_peak;        // máximo de bytes mapeados a la vez\n"
+    "static size_t dpp_region_mapped;\n"
+    "static size_t dpp_region_chunks;      // bloques pedidos al sistema\n"
+    "static size_t dpp_region_frames;      // frames abiertos\n"
+    "\n"
+    "#define DPP_FRAME_CLEANUP __attribute__((cleanup(dpp_frame_leave)))\n"
+    "\n"
+    "static void dpp_region_report(void) {\n"
+    "    fprintf(stderr, \"region: %zu bytes en temporales, %zu bloque(s), pico %zu KB, %zu frame(s)\\n\",\n"
+    "            dpp_region_bytes, dpp_region_chunks, dpp_region_peak >> 10, dpp_region_frames);\n"
+    "}\n"
+    "\n"
+    "static dpp_chunk* dpp_chunk_map(size_t size) {\n"
+    "    if (!dpp_region_chunks && getenv(\"DPP_REGION_STATS\")) atexit(dpp_region_report);\n"
+    "    dpp_region_chunks++;\n"
+    "#ifdef _WIN32\n"
+    "    dpp_chunk* c = malloc(size);\n"
+    "    if (!c) {\n"
+    "#else\n"
+    "    dpp_chunk* c = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);\n"
+    "    if (c == MAP_FAILED) {\n"
+    "#endif\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "#if defined(MADV_HUGEPAGE)\n"
+    "    madvise(c, size, MADV_HUGEPAGE);\n"
+    "#endif\n"
+    "    c->size = size;\n"
+    "    dpp_region_mapped += size;\n"
+    "    if (dpp_region_mapped > dpp_region_peak) dpp_region_peak = dpp_region_mapped;\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "static void dpp_chunk_unmap(dpp_chunk* c) {\n"
+    "    dpp_region_mapped -= c->size;\n"
+    "#ifdef _WIN32\n"
+    "    free(c);\n"
+    "#else\n"
+    "    munmap(c, c->size);\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "static void* dpp_region_grow(size_t n) {\n"
+    "    size_t need = n + sizeof(dpp_chunk) + 16;\n"
+    "    dpp_chunk* c;\n"
+    "    if (need <= DPP_CHUNK_SIZE && dpp_region_spare) {\n"
+    "        c = dpp_region_spare;\n"
+    "        dpp_region_spare = c->prev;\n"
+    "    } else {\n"
+    "        c = dpp_chunk_map(need <= DPP_CHUNK_SIZE ? DPP_CHUNK_SIZE\n"
+    "                                                 : (need + DPP_CHUNK_SIZE - 1) & ~(DPP_CHUNK_SIZE - 1));\n"
+    "    }\n"
+    "    c->prev = dpp_region_chunk;\n"
+    "    dpp_region_chunk = c;\n"
+    "    dpp_region_ptr = (char*)c + ((sizeof(dpp_chunk) + 15) & ~(size_t)15);\n"
+    "    dpp_region_end = (char*)c + c->size;\n"
+    "    void* p = dpp_region_ptr;\n"
+    "    dpp_region_ptr += (n + 15) & ~(size_t)15;\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "static inline void* dpp_region_alloc(size_t n) {\n"
+    "    dpp_region_bytes += n;\n"
+    "    if ((size_t)(dpp_region_end - dpp_region_ptr) >= n) {\n"
+    "        void* p = dpp_region_ptr;\n"
+    "        dpp_region_ptr += (n + 15) & ~(size_t)15;\n"
+    "        return p;\n"
+    "    }\n"
+    "    return dpp_region_grow(n);\n"
+    "}\n"
+    "\n"
+    "static inline dpp_frame dpp_frame_enter(void) {\n"
+    "    dpp_frame f = { dpp_region_chunk, dpp_region_ptr };\n"
+    "    dpp_region_frames++;\n"
+    "    return f;\n"
+    "}\n"
+    "\n"
+    "// Vuelve a la marca del frame. Los bloques abiertos después quedan de repuesto; los más\n"
+    "// grandes que un bloque normal se devuelven al sistema.\n"
+    "static inline void dpp_frame_leave(dpp_frame* f) {\n"
+    "    while (dpp_region_chunk != f->chunk) {\n"
+    "        dpp_chunk* c = dpp_region_chunk;\n"
+    "        dpp_region_chunk = c->prev;\n"
+    "        if (c->size == DPP_CHUNK_SIZE) {\n"
+    "            c->prev = dpp_region_spare;\n"
+    "            dpp_region_spare = c;\n"
+    "        } else {\n"
+    "            dpp_chunk_unmap(c);\n"
+    "        }\n"
+    "        dpp_region_end = dpp_region_chunk ? (char*)dpp_region_chunk + dpp_region_chunk->size : NULL;\n"
+    "    }\n"
+    "    dpp_region_ptr = f->ptr;\n"
+    "}\n";
+
+static const char runtime_chain[] =
+    "/* ---- Cadenas (chain) ---- */\n"
+    "// Cuatro representaciones: en línea (cadenas cortas, sin memoria dinámica), en el heap\n"
+    "// con contador de referencias (copy-on-write), literal (apunta al texto del programa) y\n"
+    "// vista (un tramo del búfer de otra cadena, que mantiene vivo con una referencia).\n"
+    "// Asignar nunca copia bytes largos: solo comparte el búfer y suma una referencia.\n"
+    "// Solo las cadenas en línea y en el heap terminan en '\\0'.\n"
+    "#define DPP_SSO_CAP 23\n"
+    "\n"
+    "enum { DPP_STR_SSO, DPP_STR_HEAP, DPP_STR_LIT, DPP_STR_SLICE };\n"
+    "\n"
+    "typedef struct {\n"
+    "    int refs;\n"
+    "    uint32_t cap;\n"
+    "    uint64_t hash;   // 0 = todavía no calculado\n"
+    "    int in_region;   // temporal: lo libera el frame, no free()\n"
+    "    char data[];\n"
+    "} dpp_strbuf;\n"
+    "\n"
+    "// Estado de internado: los literales del programa son canónicos (un único puntero por\n"
+    "// contenido), así que dos cadenas canónicas son iguales solo si apuntan al mismo texto.\n"
+    "enum { DPP_INTERN_UNKNOWN, DPP_INTERN_CANONICAL, DPP_INTERN_NONE };\n"
+    "\n"
+    "typedef struct {\n"
+    "    uint32_t len;\n"
+    "    uint8_t kind;\n"
+    "    uint8_t interned;\n"
+    "    union {\n"
+    "        char sso[DPP_SSO_CAP + 1];\n"
+    "        dpp_strbuf* heap;\n"
+    "        const char* lit;\n"
+    "        struct {\n"
+    "            dpp_strbuf* owner;\n"
+    "            const char* ptr;\n"
+    "        } slice;\n"
+    "    };\n"
+    "} dpp_chain;\n"
+    "\n"
+    "typedef struct {\n"
+    "    const char* ptr;\n"
+    "    size_t len;\n"
+    "} dpp_view;\n"
+    "\n"
+    "#define DPP_CHAIN_INIT { .len = 0, .kind = DPP_STR_SSO, .sso = { 0 } }\n"
+    "#define DPP_CHAIN_CLEANUP __attribute__((cleanup(dpp_chain_drop)))\n"
+    "// Literal del programa; el compilador emite uno solo por cada texto distinto.\n"
+    "#define DPP_CHAIN_LITERAL(s) { .len = sizeof(s) - 1, .kind = DPP_STR_LIT, \\\n"
+    "                               .interned = DPP_INTERN_CANONICAL, .lit = s }\n"
+    "\n"
+    "static inline const char* dpp_chain_data(const dpp_chain* c) {\n"
+    "    switch (c->kind) {\n"
+    "        case DPP_STR_HEAP: return c->heap->data;\n"
+    "        case DPP_STR_LIT: return c->lit;\n"
+    "        case DPP_STR_SLICE: return c->slice.ptr;\n"
+    "        default: return c->sso;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline dpp_view dpp_chain_view(const dpp_chain* c) {\n"
+    "    dpp_view v = { dpp_chain_data(c), c->len };\n"
+    "    return v;\n"
+    "}\n"
+    "\n"
+    "// Búfer compartido del que depende la cadena, o NULL.\n"
+    "static inline dpp_strbuf* dpp_chain_owner(const dpp_chain* c) {\n"
+    "    if (c->kind == DPP_STR_HEAP) return c->heap;\n"
+    "    if (c->kind == DPP_STR_SLICE) return c->slice.owner;\n"
+    "    return NULL;\n"
+    "}\n"
+    "\n"
+    "static void dpp_chain_drop(dpp_chain* c) {\n"
+    "    dpp_strbuf* owner = dpp_chain_owner(c);\n"
+    "    if (owner && __atomic_sub_fetch(&owner->refs, 1, __ATOMIC_ACQ_REL) == 0 && !owner->in_region)\n"
+    "        free(owner);\n"
+    "    c->len = 0;\n"
+    "    c->kind = DPP_STR_SSO;\n"
+    "    c->interned = DPP_INTERN_UNKNOWN;\n"
+    "    c->sso[0] = '\\0';\n"
+    "}\n"
+    "\n"
+    "static inline dpp_chain dpp_chain_copy(const dpp_chain* c) {\n"
+    "    dpp_strbuf* owner = dpp_chain_owner(c);\n"
+    "    if (owner) __atomic_add_fetch(&owner->refs, 1, __ATOMIC_RELAXED);\n"
+    "    return *c;\n"
+    "}\n"
+    "\n"
+    "static inline dpp_chain dpp_chain_lit(const char* s, size_t n) {\n"
+    "    dpp_chain c;\n"
+    "    c.len = (uint32_t)n;\n"
+    "    c.kind = DPP_STR_LIT;\n"
+    "    c.interned = DPP_INTERN_UNKNOWN;\n"
+    "    c.lit = s;\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Reemplaza *dst por src, del que toma posesión.\n"
+    "static inline void dpp_chain_move(dpp_chain* dst, dpp_chain src) {\n"
+    "    dpp_chain_drop(dst);\n"
+    "    *dst = src;\n"
+    "}\n"
+    "\n"
+    "static dpp_strbuf* dpp_strbuf_new(size_t cap) {\n"
+    "    dpp_strbuf* b = malloc(sizeof(dpp_strbuf) + cap + 1);\n"
+    "    if (!b || cap > UINT32_MAX) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    b->refs = 1;\n"
+    "    b->cap = (uint32_t)cap;\n"
+    "    b->hash = 0;\n"
+    "    b->in_region = 0;\n"
+    "    return b;\n"
+    "}\n"
+    "\n"
+    "// Cadena nueva de longitud len (contenido sin inicializar); devuelve dónde escribirlo.\n"
+    "static inline char* dpp_chain_alloc(dpp_chain* c, size_t len) {\n"
+    "    c->len = (uint32_t)len;\n"
+    "    c->interned = DPP_INTERN_UNKNOWN;\n"
+    "    if (len <= DPP_SSO_CAP) {\n"
+    "        c->kind = DPP_STR_SSO;\n"
+    "        c->sso[len] = '\\0';\n"
+    "        return c->sso;\n"
+    "    }\n"
+    "    c->kind = DPP_STR_HEAP;\n"
+    "    c->heap = dpp_strbuf_new(len);\n"
+    "    c->heap->data[len] = '\\0';\n"
+    "    return c->heap->data;\n"
+    "}\n"
+    "\n"
+    "DPP_RT dpp_chain dpp_chain_from(const char* s, size_t n) {\n"
+    "    dpp_chain c;\n"
+    "    memcpy(dpp_chain_alloc(&c, n), s, n);\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Copy-on-write: deja *c con un búfer propio de al menos `len` bytes y longitud len,\n"
+    "// conservando el prefijo que ya tenía.\n"
+    "DPP_RT char* dpp_chain_mut(dpp_chain* c, size_t len) {\n"
+    "    if (c->kind == DPP_STR_HEAP && c->heap->refs == 1 && c->heap->cap >= len) {\n"
+    "        c->len = (uint32_t)len;\n"
+    "        c->interned = DPP_INTERN_UNKNOWN;\n"
+    "        c->heap->hash = 0;\n"
+    "        c->heap->data[len] = '\\0';\n"
+    "        return c->heap->data;\n"
+    "    }\n"
+    "    if (c->kind == DPP_STR_SSO && len <= DPP_SSO_CAP) {\n"
+    "        c->len = (uint32_t)len;\n"
+    "        c->interned = DPP_INTERN_UNKNOWN;\n"
+    "        c->sso[len] = '\\0';\n"
+    "        return c->sso;\n"
+    "    }\n"
+    "    dpp_view old = dpp_chain_view(c);\n"
+    "    dpp_chain fresh;\n"
+    "    char* p = dpp_chain_alloc(&fresh, len);\n"
+    "    memcpy(p, old.ptr, old.len < len ? old.len : len);\n"
+    "    dpp_chain_move(c, fresh);\n"
+    "    return (char*)dpp_chain_data(c);   // en línea, los bytes se movieron con la cadena\n"
+    "}\n"
+    "\n"
+    "// Concatena n partes: suma las longitudes, reserva una sola vez y copia cada parte con un memcpy.\n"
+    "DPP_RT dpp_chain dpp_chain_concat_n(const dpp_view* parts, size_t n) {\n"
+    "    size_t total = 0;\n"
+    "    for (size_t i = 0; i < n; ++i) total += parts[i].len;\n"
+    "    dpp_chain c;\n"
+    "    char* p = dpp_chain_alloc(&c, total);\n"
+    "    for (size_t i = 0; i < n; ++i) {\n"
+    "        memcpy(p, parts[i].ptr, parts[i].len);\n"
+    "        p += parts[i].len;\n"
+    "    }\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Como dpp_chain_concat_n, pero el resultado vive en la región del frame actual: solo\n"
+    "// para temporales que se consumen en la misma sentencia.\n"
+    "DPP_RT dpp_chain dpp_chain_concat_tmp(const dpp_view* parts, size_t n) {\n"
+    "    size_t total = 0;\n"
+    "    for (size_t i = 0; i < n; ++i) total += parts[i].len;\n"
+    "    if (total <= DPP_SSO_CAP || total > UINT32_MAX) return dpp_chain_concat_n(parts, n);\n"
+    "    dpp_strbuf* b = dpp_region_alloc(sizeof(dpp_strbuf) + total + 1);\n"
+    "    b->refs = 1;\n"
+    "    b->cap = (uint32_t)total;\n"
+    "    b->hash = 0;\n"
+    "    b->in_region = 1;\n"
+    "    char* p = b->data;\n"
+    "    for (size_t i = 0; i < n; ++i) {\n"
+    "        memcpy(p, parts[i].ptr, parts[i].len);\n"
+    "        p += parts[i].len;\n"
+    "    }\n"
+    "    *p = '\\0';\n"
+    "    dpp_chain c;\n"
+    "    c.len = (uint32_t)total;\n"
+    "    c.kind = DPP_STR_HEAP;\n"
+    "    c.interned = DPP_INTERN_UNKNOWN;\n"
+    "    c.heap = b;\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Deja *c con un búfer propio de al menos `need` bytes, conservando el contenido.\n"
+    "// Al crecer por lo menos duplica la capacidad, así agregar al final cuesta O(1) amortizado.\n"
+    "DPP_RT char* dpp_chain_reserve(dpp_chain* c, size_t need) {\n"
+    "    c->interned = DPP_INTERN_UNKNOWN;\n"
+    "    if (c->kind == DPP_STR_HEAP && c->heap->refs == 1 && !c->heap->in_region) {\n"
+    "        c->heap->hash = 0;\n"
+    "        if (c->heap->cap >= need) return c->heap->data;\n"
+    "        size_t cap = (size_t)c->heap->cap * 2;\n"
+    "        if (cap < need) cap = need;\n"
+    "        dpp_strbuf* b = cap <= UINT32_MAX ? realloc(c->heap, sizeof(dpp_strbuf) + cap + 1) : NULL;\n"
+    "        if (!b) {\n"
+    "            fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "            exit(1);\n"
+    "        }\n"
+    "        b->cap = (uint32_t)cap;\n"
+    "        c->heap = b;\n"
+    "        return b->data;\n"
+    "    }\n"
+    "    if (c->kind == DPP_STR_SSO && need <= DPP_SSO_CAP) return c->sso;\n"
+    "\n"
+    "    size_t cap = (size_t)c->len * 2;\n"
+    "    if (cap < need) cap = need;\n"
+    "    uint32_t len = c->len;\n"
+    "    dpp_strbuf* b = dpp_strbuf_new(cap);\n"
+    "    memcpy(b->data, dpp_chain_data(c), len);\n"
+    "    b->data[len] = '\\0';\n"
+    "    dpp_chain_drop(c);\n"
+    "    c->len = len;\n"
+    "    c->kind = DPP_STR_HEAP;\n"
+    "    c->heap = b;\n"
+    "    return b->data;\n"
+    "}\n"
+    "\n"
+    "// s = s + a + b + ... dentro de un ciclo: agrega las partes al final de *dst sin recopiarlo.\n"
+    "// Ninguna parte puede apuntar al búfer de *dst.\n"
+    "DPP_RT void dpp_chain_append_n(dpp_chain* dst, const dpp_view* parts, size_t n) {\n"
+    "    size_t len = dst->len, total = len;\n"
+    "    for (size_t i = 0; i < n; ++i) total += parts[i].len;\n"
+    "    char* p = dpp_chain_reserve(dst, total);\n"
+    "    for (size_t i = 0; i < n; ++i) {\n"
+    "        memcpy(p + len, parts[i].ptr, parts[i].len);\n"
+    "        len += parts[i].len;\n"
+    "    }\n"
+    "    p[len] = '\\0';\n"
+    "    dst->len = (uint32_t)len;\n"
+    "}\n"
+    "\n"
+    "// Orden lexicográfico por bytes, como strcmp.\n"
+    "DPP_RT int dpp_chain_compare(const dpp_chain* a, const dpp_chain* b) {\n"
+    "    uint32_t n = a->len < b->len ? a->len : b->len;\n"
+    "    int r = memcmp(dpp_chain_data(a), dpp_chain_data(b), n);\n"
+    "    if (r != 0) return r;\n"
+    "    return (a->len > b->len) - (a->len < b->len);\n"
+    "}\n"
+    "\n"
+    "/* ---- Igualdad e internado ---- */\n"
+    "DPP_RT uint64_t dpp_hash_bytes(const char* p, size_t n) {\n"
+    "    uint64_t h = 0x9e3779b97f4a7c15ull ^ n;\n"
+    "    for (; n >= 8; p += 8, n -= 8) {\n"
+    "        uint64_t w;\n"
+    "        memcpy(&w, p, 8);\n"
+    "        h = (h ^ w) * 0xff51afd7ed558ccdull;\n"
+    "        h ^= h >> 32;\n"
+    "    }\n"
+    "    uint64_t w = 0;\n"
+    "    memcpy(&w, p, n);\n"
+    "    h = (h ^ w) * 0xc4ceb9fe1a85ec53ull;\n"
+    "    h ^= h >> 29;\n"
+    "    return h | 1;   // nunca 0, que marca \"sin calcular\"\n"
+    "}\n"
+    "\n"
+    "// Solo las cadenas largas en el heap guardan su hash: se calcula una vez por búfer.\n"
+    "#define DPP_HASH_MIN_LEN 64\n"
+    "\n"
+    "static inline uint64_t dpp_chain_hash(const dpp_chain* c) {\n"
+    "    if (c->kind == DPP_STR_HEAP) {\n"
+    "        if (!c->heap->hash) c->heap->hash = dpp_hash_bytes(c->heap->data, c->len);\n"
+    "        return c->heap->hash;\n"
+    "    }\n"
+    "    return dpp_hash_bytes(dpp_chain_data(c), c->len);\n"
+    "}\n"
+    "\n"
+    "// Largo, luego internado o puntero, luego hash guardado y por último memcmp.\n"
+    "DPP_RT int dpp_chain_equal(const dpp_chain* a, const dpp_chain* b) {\n"
+    "    if (a->len != b->len) return 0;\n"
+    "    if (a->interned == DPP_INTERN_CANONICAL && b->interned == DPP_INTERN_CANONICAL)\n"
+    "        return dpp_chain_data(a) == dpp_chain_data(b);\n"
+    "    if (a->interned + b->interned == DPP_INTERN_CANONICAL + DPP_INTERN_NONE)\n"
+    "        return 0;   // una es un literal y la otra no coincide con ninguno\n"
+    "    const char* pa = dpp_chain_data(a);\n"
+    "    const char* pb = dpp_chain_data(b);\n"
+    "    if (pa == pb) return 1;\n"
+    "    if (a->len >= DPP_HASH_MIN_LEN && a->kind == DPP_STR_HEAP && b->kind == DPP_STR_HEAP &&\n"
+    "        dpp_chain_hash(a) != dpp_chain_hash(b))\n"
+    "        return 0;\n"
+    "    return memcmp(pa, pb, a->len) == 0;\n"
+    "}\n"
+    "\n"
+    "// Tabla con los literales del programa, armada en la primera consulta.\n"
+    "#define DPP_INTERN_MAX_LEN 64\n"
+    "static const dpp_chain** dpp_intern_slots;\n"
+    "static uint32_t dpp_intern_mask;\n"
+    "\n"
+    "static void dpp_intern_build(const dpp_chain* const* pool, int count) {\n"
+    "    uint32_t size = 16;\n"
+    "    while (size < (uint32_t)count * 2) size *= 2;\n"
+    "    dpp_intern_slots = calloc(size, sizeof(*dpp_intern_slots));\n"
+    "    dpp_intern_mask = size - 1;\n"
+    "    for (int i = 0; i < count; ++i) {\n"
+    "        uint32_t j = (uint32_t)dpp_hash_bytes(pool[i]->lit, pool[i]->len) & dpp_intern_mask;\n"
+    "        while (dpp_intern_slots[j]) j = (j + 1) & dpp_intern_mask;\n"
+    "        dpp_intern_slots[j] = pool[i];\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Busca el contenido de *c entre los literales: si está, *c pasa a apuntar al literal\n"
+    "// canónico; si no, queda marcada como distinta de todos. Cualquier escritura lo olvida.\n"
+    "DPP_RT void dpp_chain_intern(dpp_chain* c, const dpp_chain* const* pool, int count) {\n"
+    "    if (c->interned || c->len > DPP_INTERN_MAX_LEN) return;\n"
+    "    if (!dpp_intern_slots) dpp_intern_build(pool, count);\n"
+    "    const char* p = dpp_chain_data(c);\n"
+    "    uint32_t j = (uint32_t)dpp_hash_bytes(p, c->len) & dpp_intern_mask;\n"
+    "    for (; dpp_intern_slots[j]; j = (j + 1) & dpp_intern_mask) {\n"
+    "        const dpp_chain* lit = dpp_intern_slots[j];\n"
+    "        if (lit->len == c->len && memcmp(lit->lit, p, c->len) == 0) {\n"
+    "            dpp_chain_move(c, *lit);\n"
+    "            return;\n"
+    "        }\n"
+    "    }\n"
+    "    c->interned = DPP_INTERN_NONE;\n"
+    "}\n"
+    "\n"
+    "// x == \"literal\". Con cadenas cortas basta el largo y un memcmp de tamaño constante; las\n"
+    "// más largas se internan la primera vez y desde ahí se comparan por puntero. Las que pasan\n"
+    "// de DPP_INTERN_MAX_LEN no se internan y se comparan siempre byte a byte.\n"
+    "#define DPP_SHORT_COMPARE 16\n"
+    "\n"
+    "static inline int dpp_chain_equal_lit(dpp_chain* c, const dpp_chain* lit,\n"
+    "                                      const dpp_chain* const* pool, int count) {\n"
+    "    if (c->len != lit->len) return 0;\n"
+    "    if (c->interned) return dpp_chain_data(c) == lit->lit;\n"
+    "    if (c->len <= DPP_SHORT_COMPARE) return memcmp(dpp_chain_data(c), lit->lit, lit->len) == 0;\n"
+    "    dpp_chain_intern(c, pool, count);\n"
+    "    if (c->interned) return dpp_chain_data(c) == lit->lit;\n"
+    "    return memcmp(dpp_chain_data(c), lit->lit, lit->len) == 0;\n"
+    "}\n"
+    "\n"
+    "/* ---- Funciones integradas sobre cadenas ---- */\n"
+    "DPP_RT int dpp_chain_len(dpp_view s) {\n"
+    "    return (int)s.len;\n"
+    "}\n"
+    "\n"
+    "// sub(s, inicio, largo): vista sin copia; los límites se recortan a la cadena.\n"
+    "// Los tramos cortos se copian en línea para no retener un búfer grande.\n"
+    "DPP_RT dpp_chain dpp_chain_sub(const dpp_chain* s, int start, int len) {\n"
+    "    if (start < 0) start = 0;\n"
+    "    if ((uint32_t)start > s->len) start = (int)s->len;\n"
+    "    if (len < 0) len = 0;\n"
+    "    if ((uint32_t)len > s->len - (uint32_t)start) len = (int)(s->len - (uint32_t)start);\n"
+    "\n"
+    "    const char* p = dpp_chain_data(s) + start;\n"
+    "    if (len <= DPP_SSO_CAP) return dpp_chain_from(p, (size_t)len);\n"
+    "    if (s->kind == DPP_STR_LIT) return dpp_chain_lit(p, (size_t)len);\n"
+    "\n"
+    "    dpp_chain c;\n"
+    "    c.len = (uint32_t)len;\n"
+    "    c.kind = DPP_STR_SLICE;\n"
+    "    c.interned = DPP_INTERN_UNKNOWN;\n"
+    "    c.slice.owner = dpp_chain_owner(s);\n"
+    "    c.slice.ptr = p;\n"
+    "    __atomic_add_fetch(&c.slice.owner->refs, 1, __ATOMIC_RELAXED);\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Posición de la primera aparición de needle en haystack, o -1.\n"
+    "DPP_RT int dpp_chain_find(dpp_view haystack, dpp_view needle) {\n"
+    "    size_t pos = dpp_search(haystack.ptr, haystack.len, needle.ptr, needle.len);\n"
+    "    return pos == DPP_NOT_FOUND ? -1 : (int)pos;\n"
+    "}\n"
+    "\n"
+    "// Apariciones de needle sin solaparse; con un solo byte, conteo vectorizado.\n"
+    "DPP_RT int dpp_chain_count(dpp_view haystack, dpp_view needle) {\n"
+    "    if (needle.len == 0) return 0;\n"
+    "    if (needle.len == 1) return (int)dpp_count_byte(haystack.ptr, haystack.len, needle.ptr[0]);\n"
+    "    int total = 0;\n"
+    "    size_t at = 0, pos;\n"
+    "    while ((pos = dpp_search(haystack.ptr + at, haystack.len - at, needle.ptr, needle.len)) != DPP_NOT_FOUND) {\n"
+    "        total++;\n"
+    "        at += pos + needle.len;\n"
+    "    }\n"
+    "    return total;\n"
+    "}\n"
+    "\n"
+    "// split(s, sep, i): campo i (desde 0) de s separado por sep, como vista; vacío si no existe.\n"
+    "DPP_RT dpp_chain dpp_chain_split(const dpp_chain* s, dpp_view sep, int index) {\n"
+    "    const dpp_chain empty = DPP_CHAIN_INIT;\n"
+    "    const char* data = dpp_chain_data(s);\n"
+    "    size_t start = 0;\n"
+    "    if (index < 0) return empty;\n"
+    "    for (int k = 0; k < index; ++k) {\n"
+    "        size_t pos = sep.len ? dpp_search(data + start, s->len - start, sep.ptr, sep.len) : DPP_NOT_FOUND;\n"
+    "        if (pos == DPP_NOT_FOUND) return empty;\n"
+    "        start += pos + sep.len;\n"
+    "    }\n"
+    "    size_t end = sep.len ? dpp_search(data + start, s->len - start, sep.ptr, sep.len) : DPP_NOT_FOUND;\n"
+    "    size_t len = end == DPP_NOT_FOUND ? s->len - start : end;\n"
+    "    return dpp_chain_sub(s, (int)start, (int)len);\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_print_chain(const dpp_chain* c) {\n"
+    "    dpp_write(dpp_chain_data(c), c->len);\n"
+    "    dpp_write(\"\\n\", 1);\n"
+    "    dpp_out_end_line();\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_print_chain_owned(dpp_chain c) {\n"
+    "    dpp_print_chain(&c);\n"
+    "    dpp_chain_drop(&c);\n"
+    "}\n";
+
+static const char runtime_input[] =
+    "/* ---- Entrada con búfer ---- */\n"
+    "#define DPP_IN_CHUNK (1 << 20)\n"
+    "\n"
+    "static char* dpp_in_buf = NULL;     // datos válidos en [dpp_in_pos, dpp_in_end)\n"
+    "static char* dpp_in_pos = NULL;\n"
+    "static char* dpp_in_end = NULL;\n"
+    "static size_t dpp_in_cap = 0;\n"
+    "static int dpp_in_mapped = 0;\n"
+    "static int dpp_in_eof = 0;\n"
+    "static int (*dpp_in_refill_hook)(void) = NULL;   // lo instala el lector en segundo plano\n"
+    "\n"
+    "// Si stdin es un archivo regular se proyecta completo en memoria; si no, se lee por bloques.\n"
+    "static void dpp_in_init(void) {\n"
+    "#ifndef _WIN32\n"
+    "    struct stat st;\n"
+    "    if (fstat(0, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {\n"
+    "        off_t off = lseek(0, 0, SEEK_CUR);\n"
+    "        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, 0, 0);\n"
+    "        if (map != MAP_FAILED && off >= 0 && off <= st.st_size) {\n"
+    "            dpp_in_buf = (char*)map;\n"
+    "            dpp_in_pos = dpp_in_buf + off;\n"
+    "            dpp_in_end = dpp_in_buf + st.st_size;\n"
+    "            dpp_in_mapped = 1;\n"
+    "            dpp_in_eof = 1;\n"
+    "            return;\n"
+    "        }\n"
+    "    }\n"
+    "#endif\n"
+    "    dpp_in_cap = DPP_IN_CHUNK;\n"
+    "    dpp_in_buf = malloc(dpp_in_cap);\n"
+    "    if (!dpp_in_buf) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    dpp_in_pos = dpp_in_end = dpp_in_buf;\n"
+    "}\n"
+    "\n"
+    "// Mueve lo pendiente al inicio del búfer y lee otro bloque. Devuelve 0 en EOF.\n"
+    "static int dpp_in_refill(void) {\n"
+    "    if (dpp_in_refill_hook) return dpp_in_refill_hook();\n"
+    "    if (dpp_in_eof) return 0;\n"
+    "    size_t pending = (size_t)(dpp_in_end - dpp_in_pos);\n"
+    "    if (dpp_in_pos != dpp_in_buf) memmove(dpp_in_buf, dpp_in_pos, pending);\n"
+    "    if (dpp_in_cap - pending < DPP_IN_CHUNK / 2) {\n"
+    "        dpp_in_cap *= 2;\n"
+    "        dpp_in_buf = realloc(dpp_in_buf, dpp_in_cap);\n"
+    "        if (!dpp_in_buf) {\n"
+    "            fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "            exit(1);\n"
+    "        }\n"
+    "    }\n"
+    "    dpp_in_pos = dpp_in_buf;\n"
+    "    dpp_in_end = dpp_in_buf + pending;\n"
+    "\n"
+    "    dpp_flush();   // los mensajes previos deben verse antes de bloquearse leyendo\n"
+    "    for (;;) {\n"
+    "#ifdef _WIN32\n"
+    "        int r = _read(0, dpp_in_end, (unsigned)(dpp_in_cap - pending));\n"
+    "#else\n"
+    "        ssize_t r = read(0, dpp_in_end, dpp_in_cap - pending);\n"
+    "#endif\n"
+    "        if (r < 0 && errno == EINTR) continue;\n"
+    "        if (r <= 0) {\n"
+    "            dpp_in_eof = 1;\n"
+    "            return 0;\n"
+    "        }\n"
+    "        dpp_in_end += r;\n"
+    "        return 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Siguiente línea sin el '\\n' (vista dentro del búfer, válida hasta la próxima lectura).\n"
+    "// Devuelve 0 si ya no queda entrada.\n"
+    "static int dpp_in_line(const char** line, size_t* len) {\n"
+    "    if (!dpp_in_buf) dpp_in_init();\n"
+    "    size_t scanned = 0;\n"
+    "    for (;;) {\n"
+    "        char* nl = memchr(dpp_in_pos + scanned, '\\n', (size_t)(dpp_in_end - dpp_in_pos) - scanned);\n"
+    "        if (nl) {\n"
+    "            *line = dpp_in_pos;\n"
+    "            *len = (size_t)(nl - dpp_in_pos);\n"
+    "            dpp_in_pos = nl + 1;\n"
+    "            return 1;\n"
+    "        }\n"
+    "        scanned = (size_t)(dpp_in_end - dpp_in_pos);\n"
+    "        if (!dpp_in_refill()) break;\n"
+    "    }\n"
+    "    if (dpp_in_pos == dpp_in_end) return 0;\n"
+    "    *line = dpp_in_pos;\n"
+    "    *len = (size_t)(dpp_in_end - dpp_in_pos);\n"
+    "    dpp_in_pos = dpp_in_end;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static inline const char* dpp_skip_blanks(const char* p, const char* end) {\n"
+    "    while (p < end && (*p == ' ' || *p == '\\t' || *p == '\\r' || *p == '\\v' || *p == '\\f')) p++;\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__\n"
+    "// SWAR: valida y convierte 8 dígitos ASCII con unas pocas operaciones de 64 bits.\n"
+    "static inline int dpp_is_8digits(uint64_t v) {\n"
+    "    return (((v & 0xF0F0F0F0F0F0F0F0ull) |\n"
+    "             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);\n"
+    "}\n"
+    "\n"
+    "static inline uint32_t dpp_parse_8digits(uint64_t v) {\n"
+    "    v -= 0x3030303030303030ull;\n"
+    "    v = (v * 10) + (v >> 8);\n"
+    "    v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +\n"
+    "         (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;\n"
+    "    return (uint32_t)v;\n"
+    "}\n"
+    "#endif\n"
+    "\n"
+    "// Acumula dígitos en *acc (módulo 2^64); devuelve el puntero tras el último dígito.\n"
+    "static inline const char* dpp_scan_digits(const char* p, const char* end, uint64_t* acc, int* count) {\n"
+    "    uint64_t v = *acc;\n"
+    "    int n = 0;\n"
+    "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__\n"
+    "    while (end - p >= 8) {\n"
+    "        uint64_t chunk;\n"
+    "        memcpy(&chunk, p, 8);\n"
+    "        if (!dpp_is_8digits(chunk)) break;\n"
+    "        v = v * 100000000ull + dpp_parse_8digits(chunk);\n"
+    "        p += 8;\n"
+    "        n += 8;\n"
+    "    }\n"
+    "#endif\n"
+    "    while (p < end && (unsigned)(*p - '0') < 10) {\n"
+    "        v = v * 10 + (uint64_t)(*p - '0');\n"
+    "        p++;\n"
+    "        n++;\n"
+    "    }\n"
+    "    *acc = v;\n"
+    "    *count = n;\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "// Campos pendientes de la línea actual: `write a b c;` lee los tres de una misma línea.\n"
+    "static const char* dpp_field_pos = NULL;\n"
+    "static const char* dpp_field_end = NULL;\n"
+    "\n"
+    "// Avanza a la siguiente línea. Devuelve 0 si ya no queda entrada; en ese caso los\n"
+    "// campos se leen de una línea vacía y fallan como ella.\n"
+    "DPP_RT int dpp_fields_begin(void) {\n"
+    "    const char* line;\n"
+    "    size_t len;\n"
+    "    if (!dpp_in_line(&line, &len)) {\n"
+    "        dpp_field_pos = dpp_field_end = \"\";\n"
+    "        return 0;\n"
+    "    }\n"
+    "    dpp_field_pos = line;\n"
+    "    dpp_field_end = line + len;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// Como \"%d\" de sscanf sobre lo que queda de la línea.\n"
+    "DPP_RT int dpp_field_int(int* x) {\n"
+    "    const char* end = dpp_field_end;\n"
+    "    const char* p = dpp_skip_blanks(dpp_field_pos, end);\n"
+    "    int neg = 0;\n"
+    "    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');\n"
+    "    uint64_t v = 0;\n"
+    "    int digits;\n"
+    "    p = dpp_scan_digits(p, end, &v, &digits);\n"
+    "    if (digits == 0) return 0;\n"
+    "    *x = (int)(neg ? 0u - (uint32_t)v : (uint32_t)v);\n"
+    "    dpp_field_pos = p;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static const float dpp_fpow10[11] = {\n"
+    "    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f\n"
+    "};\n"
+    "\n"
+    "// Como \"%f\" de sscanf. Camino rápido exacto (mantisa < 2^24 y exponente decimal\n"
+    "// pequeño: una sola operación redondeada); el resto va a strtof.\n"
+    "DPP_RT int dpp_field_float(float* x) {\n"
+    "    const char* end = dpp_field_end;\n"
+    "    const char* start = dpp_skip_blanks(dpp_field_pos, end);\n"
+    "    const char* p = start;\n"
+    "    int neg = 0;\n"
+    "    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');\n"
+    "\n"
+    "    uint64_t m = 0;\n"
+    "    int int_digits, frac_digits = 0;\n"
+    "    p = dpp_scan_digits(p, end, &m, &int_digits);\n"
+    "    if (p < end && *p == '.') p = dpp_scan_digits(p + 1, end, &m, &frac_digits);\n"
+    "    int digits = int_digits + frac_digits;\n"
+    "\n"
+    "    if (digits > 0 && digits <= 19 && m < (1u << 24) && frac_digits <= 10 &&\n"
+    "        (p == end || (*p != 'e' && *p != 'E'))) {\n"
+    "        float f = (float)m;\n"
+    "        if (frac_digits) f /= dpp_fpow10[frac_digits];\n"
+    "        *x = neg ? -f : f;\n"
+    "        dpp_field_pos = p;\n"
+    "        return 1;\n"
+    "    }\n"
+    "\n"
+    "    char tmp[512];\n"
+    "    size_t n = (size_t)(end - start) < sizeof(tmp) - 1 ? (size_t)(end - start) : sizeof(tmp) - 1;\n"
+    "    memcpy(tmp, start, n);\n"
+    "    tmp[n] = '\\0';\n"
+    "    char* stop;\n"
+    "    float f = strtof(tmp, &stop);\n"
+    "    if (stop == tmp) return 0;\n"
+    "    *x = f;\n"
+    "    dpp_field_pos = start + (stop - tmp);\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// Siguiente palabra como vista dentro del búfer de entrada (sin copiar); válida\n"
+    "// hasta la próxima lectura.\n"
+    "DPP_RT int dpp_field_token(const char** token, size_t* len) {\n"
+    "    const char* end = dpp_field_end;\n"
+    "    const char* p = dpp_skip_blanks(dpp_field_pos, end);\n"
+    "    const char* q = p;\n"
+    "    while (q < end && *q != ' ' && *q != '\\t' && *q != '\\r' && *q != '\\v' && *q != '\\f') q++;\n"
+    "    dpp_field_pos = q;\n"
+    "    *token = p;\n"
+    "    *len = (size_t)(q - p);\n"
+    "    return q != p;\n"
+    "}\n";
+
+static const char runtime_input_chain[] =
+    "/* ---- Lectura de cadenas ---- */\n"
+    "// Como \"%s\" de sscanf: devuelve 0 si no queda ninguna palabra en la línea, y entonces\n"
+    "// queda vacía (`write s;` lo acepta; `while (write s)` termina ahí).\n"
+    "DPP_RT int dpp_field_chain(dpp_chain* dst) {\n"
+    "    const char* token;\n"
+    "    size_t len;\n"
+    "    int found = dpp_field_token(&token, &len);\n"
+    "    memcpy(dpp_chain_mut(dst, len), token, len);\n"
+    "    return found;\n"
+    "}\n";
+
+static const char runtime_sync[] =
+    "/* ---- Sincronización entre hilos ---- */\n"
+    "#include <pthread.h>\n"
+    "#include <sched.h>\n"
+    "#include <limits.h>\n"
+    "#ifdef __linux__\n"
+    "#include <linux/futex.h>\n"
+    "#include <sys/syscall.h>\n"
+    "#endif\n"
+    "\n"
+    "static inline void dpp_cpu_relax(void) {\n"
+    "#if defined(__x86_64__) || defined(__i386__)\n"
+    "    __builtin_ia32_pause();\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "// Duerme en un futex mientras *addr == value.\n"
+    "DPP_RT void dpp_sleep_while(int* addr, int value) {\n"
+    "    while (__atomic_load_n(addr, __ATOMIC_ACQUIRE) == value) {\n"
+    "#ifdef __linux__\n"
+    "        syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);\n"
+    "#else\n"
+    "        sched_yield();\n"
+    "#endif\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Espera mientras *addr == value: primero gira, luego duerme en un futex.\n"
+    "DPP_RT void dpp_wait_while(int* addr, int value) {\n"
+    "    for (int i = 0; i < 2048; ++i) {\n"
+    "        if (__atomic_load_n(addr, __ATOMIC_ACQUIRE) != value) return;\n"
+    "        dpp_cpu_relax();\n"
+    "    }\n"
+    "    dpp_sleep_while(addr, value);\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_wake_all(int* addr) {\n"
+    "#ifdef __linux__\n"
+    "    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);\n"
+    "#else\n"
+    "    (void)addr;\n"
+    "#endif\n"
+    "}\n";
+
+static const char runtime_async_input[] =
+    "/* ---- Lector de entrada en segundo plano (--async-input) ---- */\n"
+    "// Doble búfer SPSC: el hilo lector llena un bloque mientras el programa analiza el otro.\n"
+    "// dpp_async_full[i] pasa a 1 cuando el bloque i tiene datos y vuelve a 0 al devolverlo.\n"
+    "static char* dpp_async_slot[2];\n"
+    "static size_t dpp_async_len[2];\n"
+    "static int dpp_async_full[2];\n"
+    "static int dpp_async_next = 0;       // próximo bloque a consumir\n"
+    "static int dpp_async_held = -1;      // bloque que el programa está leyendo\n"
+    "static char* dpp_async_rest = NULL;  // resto del bloque tras coser una línea partida\n"
+    "static char* dpp_async_rest_end = NULL;\n"
+    "\n"
+    "static void* dpp_async_reader(void* arg) {\n"
+    "    (void)arg;\n"
+    "    int idx = 0;\n"
+    "    for (;;) {\n"
+    "        dpp_wait_while(&dpp_async_full[idx], 1);\n"
+    "        ssize_t r;\n"
+    "        do {\n"
+    "            r = read(0, dpp_async_slot[idx], DPP_IN_CHUNK);\n"
+    "        } while (r < 0 && errno == EINTR);\n"
+    "        dpp_async_len[idx] = r > 0 ? (size_t)r : 0;\n"
+    "        __atomic_store_n(&dpp_async_full[idx], 1, __ATOMIC_RELEASE);\n"
+    "        dpp_wake_all(&dpp_async_full[idx]);\n"
+    "        if (r <= 0) return NULL;\n"
+    "        idx ^= 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static void dpp_async_release(void) {\n"
+    "    if (dpp_async_held < 0) return;\n"
+    "    __atomic_store_n(&dpp_async_full[dpp_async_held], 0, __ATOMIC_RELEASE);\n"
+    "    dpp_wake_all(&dpp_async_full[dpp_async_held]);\n"
+    "    dpp_async_held = -1;\n"
+    "}\n"
+    "\n"
+    "// Mismo contrato que dpp_in_refill: conserva lo pendiente como prefijo y agrega datos.\n"
+    "// Sin línea partida se analiza directamente sobre el bloque; si la hay, solo se copia\n"
+    "// al búfer propio lo pendiente más el trozo del bloque nuevo hasta el primer '\\n'.\n"
+    "static int dpp_in_refill_async(void) {\n"
+    "    size_t pending = (size_t)(dpp_in_end - dpp_in_pos);\n"
+    "    if (pending == 0 && dpp_async_rest) {\n"
+    "        dpp_in_pos = dpp_async_rest;\n"
+    "        dpp_in_end = dpp_async_rest_end;\n"
+    "        dpp_async_rest = NULL;\n"
+    "        return 1;\n"
+    "    }\n"
+    "    if (dpp_in_eof) return 0;\n"
+    "\n"
+    "    if (pending) memmove(dpp_in_buf, dpp_in_pos, pending);\n"
+    "    dpp_in_pos = dpp_in_buf;\n"
+    "    dpp_in_end = dpp_in_buf + pending;\n"
+    "    dpp_async_release();\n"
+    "\n"
+    "    int idx = dpp_async_next;\n"
+    "    if (!__atomic_load_n(&dpp_async_full[idx], __ATOMIC_ACQUIRE)) {\n"
+    "        dpp_flush();\n"
+    "        dpp_wait_while(&dpp_async_full[idx], 0);\n"
+    "    }\n"
+    "    char* slot = dpp_async_slot[idx];\n"
+    "    size_t n = dpp_async_len[idx];\n"
+    "    if (n == 0) {\n"
+    "        dpp_in_eof = 1;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    dpp_async_held = idx;\n"
+    "    dpp_async_next = idx ^ 1;\n"
+    "\n"
+    "    if (!pending) {\n"
+    "        dpp_in_pos = slot;\n"
+    "        dpp_in_end = slot + n;\n"
+    "        return 1;\n"
+    "    }\n"
+    "\n"
+    "    char* nl = memchr(slot, '\\n', n);\n"
+    "    size_t take = nl ? (size_t)(nl - slot) + 1 : n;\n"
+    "    if (pending + take > dpp_in_cap) {\n"
+    "        while (pending + take > dpp_in_cap) dpp_in_cap *= 2;\n"
+    "        dpp_in_buf = realloc(dpp_in_buf, dpp_in_cap);\n"
+    "        if (!dpp_in_buf) {\n"
+    "            fprintf(stderr, \"Error: memoria insuficiente.\\n\");\n"
+    "            exit(1);\n"
+    "        }\n"
+    "    }\n"
+    "    memcpy(dpp_in_buf + pending, slot, take);\n"
+    "    dpp_in_pos = dpp_in_buf;\n"
+    "    dpp_in_end = dpp_in_buf + pending + take;\n"
+    "    if (take < n) {\n"
+    "        dpp_async_rest = slot + take;\n"
+    "        dpp_async_rest_end = slot + n;\n"
+    "    } else {\n"
+    "        dpp_async_release();\n"
+    "    }\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// Si stdin es un archivo regular ya se usa mmap y el hilo no aporta nada.\n"
+    "DPP_RT void dpp_async_input_start(void) {\n"
+    "    dpp_in_init();\n"
+    "    if (dpp_in_mapped) return;\n"
+    "    dpp_async_slot[0] = malloc(DPP_IN_CHUNK);\n"
+    "    dpp_async_slot[1] = malloc(DPP_IN_CHUNK);\n"
+    "    if (!dpp_async_slot[0] || !dpp_async_slot[1]) return;\n"
+    "\n"
+    "    pthread_t reader;\n"
+    "    if (pthread_create(&reader, NULL, dpp_async_reader, NULL) != 0) return;\n"
+    "    pthread_detach(reader);\n"
+    "    dpp_in_refill_hook = dpp_in_refill_async;\n"
+    "}\n";
+
+static const char runtime_array[] =
+    "/* ---- Arreglos de tamaño fijo ---- */\n"
+    "#define DPP_ARRAY_ALIGN 64\n"
+    "#define DPP_ARRAY_CLEANUP __attribute__((cleanup(dpp_array_free)))\n"
+    "\n"
+    "__attribute__((noreturn, cold, noinline))\n"
+    "DPP_RT void dpp_index_error(int i, int n, int line) {\n"
+    "    dpp_flush();\n"
+    "    fprintf(stderr, \"Error en la línea %d: índice %d fuera de rango [0, %d).\\n\", line, i, n);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "/* Comprobación de límites; el análisis de rangos la quita cuando puede probarla. */\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_index(int i, int n, int line) {\n"
+    "    if (__builtin_expect((unsigned)i >= (unsigned)n, 0)) dpp_index_error(i, n, line);\n"
+    "    return i;\n"
+    "}\n"
+    "\n"
+    "/* Arreglos locales grandes: en el heap, alineados y en cero. */\n"
+    "DPP_RT void* dpp_array_new(size_t count, size_t size) {\n"
+    "    size_t bytes = (count * size + DPP_ARRAY_ALIGN - 1) & ~(size_t)(DPP_ARRAY_ALIGN - 1);\n"
+    "    void* p = aligned_alloc(DPP_ARRAY_ALIGN, bytes);\n"
+    "    if (!p) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente para un arreglo de %zu elementos.\\n\", count);\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    memset(p, 0, bytes);\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_array_free(const void* slot) {\n"
+    "    free(*(void* const*)slot);\n"
+    "}\n";
+
+static const char runtime_vector[] =
+    "/* ---- Vectores ---- */\n"
+    "// Arreglos de largo variable con los datos alineados a 64 bytes; la capacidad se duplica\n"
+    "// al llenarse. realloc no conserva esa alineación, así que los búferes chicos se piden con\n"
+    "// aligned_alloc y se copian al crecer; desde DPP_VEC_MAP_MIN bytes el búfer es un mapeo\n"
+    "// propio que mremap agranda sin copiar los datos (el kernel mueve las páginas).\n"
+    "#define DPP_VEC_MAP_MIN ((size_t)1 << 20)\n"
+    "#define DPP_VEC_MAX_LEN (1 << 30)\n"
+    "#define DPP_VEC_INIT { NULL, 0, 0 }\n"
+    "\n"
+    "// Vectores de 16 bytes: el ancho de SSE2 y NEON. Con 32 bytes gcc parte cada operación en\n"
+    "// dos cuando la CPU de destino no tiene AVX, y min/max resultan más lentos que el ciclo escalar.\n"
+    "typedef int dpp_v4i __attribute__((vector_size(16), may_alias));\n"
+    "typedef unsigned dpp_v4u __attribute__((vector_size(16), may_alias));\n"
+    "typedef float dpp_v4f __attribute__((vector_size(16), may_alias));\n"
+    "\n"
+    "// Lee 4 enteros sin exigir la alineación de 16 bytes.\n"
+    "static inline __attribute__((always_inline, unused)) dpp_v4i dpp_loadu4i(const int* p) {\n"
+    "    dpp_v4i v;\n"
+    "    memcpy(&v, p, sizeof(v));\n"
+    "    return v;\n"
+    "}\n"
+    "\n"
+    "// Elige x donde la máscara vale -1 e y donde vale 0, para cualquier tipo de 4 carriles.\n"
+    "#define DPP_VSEL(V, mask, x, y) \\\n"
+    "    ((V)(((dpp_v4i)(mask) & (dpp_v4i)(x)) | (~(dpp_v4i)(mask) & (dpp_v4i)(y))))\n"
+    "\n"
+    "__attribute__((noreturn, cold, noinline))\n"
+    "DPP_RT void dpp_vec_error(const char* what, int line) {\n"
+    "    dpp_flush();\n"
+    "    fprintf(stderr, \"Error en la línea %d: %s.\\n\", line, what);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "DPP_RT void* dpp_vec_resize(void* old, size_t used, size_t old_cap, size_t new_cap) {\n"
+    "    void* p;\n"
+    "#ifndef _WIN32\n"
+    "    if (new_cap >= DPP_VEC_MAP_MIN) {\n"
+    "        if (old_cap >= DPP_VEC_MAP_MIN) {\n"
+    "#ifdef MREMAP_MAYMOVE\n"
+    "            p = mremap(old, old_cap, new_cap, MREMAP_MAYMOVE);\n"
+    "#else\n"
+    "            p = mmap(NULL, new_cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);\n"
+    "            if (p != MAP_FAILED) {\n"
+    "                memcpy(p, old, used);\n"
+    "                munmap(old, old_cap);\n"
+    "            }\n"
+    "#endif\n"
+    "        } else {\n"
+    "            p = mmap(NULL, new_cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);\n"
+    "            if (p != MAP_FAILED) {\n"
+    "                if (used) memcpy(p, old, used);\n"
+    "                free(old);\n"
+    "            }\n"
+    "        }\n"
+    "        if (p == MAP_FAILED) dpp_vec_error(\"memoria insuficiente para el vector\", 0);\n"
+    "#if defined(MADV_HUGEPAGE)\n"
+    "        madvise(p, new_cap, MADV_HUGEPAGE);\n"
+    "#endif\n"
+    "        return p;\n"
+    "    }\n"
+    "#endif\n"
+    "    p = aligned_alloc(64, new_cap);\n"
+    "    if (!p) dpp_vec_error(\"memoria insuficiente para el vector\", 0);\n"
+    "    if (used) memcpy(p, old, used);\n"
+    "    free(old);\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "DPP_RT void dpp_vec_release(void* data, size_t cap) {\n"
+    "#ifndef _WIN32\n"
+    "    if (cap >= DPP_VEC_MAP_MIN) {\n"
+    "        munmap(data, cap);\n"
+    "        return;\n"
+    "    }\n"
+    "#endif\n"
+    "    free(data);\n"
+    "}\n"
+    "\n"
+    "// Tipo y operaciones comunes de un vector de T; V es el tipo SIMD de 4 carriles de T.\n"
+    "#define DPP_VEC_DEFINE(T, V) \\\n"
+    "typedef struct { T* data; int len; int cap; } dpp_vec_##T; \\\n"
+    "\\\n"
+    "DPP_RT void dpp_vec_##T##_free(dpp_vec_##T* v) { \\\n"
+    "    if (v->data) dpp_vec_release(v->data, (size_t)v->cap * sizeof(T)); \\\n"
+    "} \\\n"
+    "\\\n"
+    "__attribute__((noinline)) \\\n"
+    "DPP_RT void dpp_vec_##T##_reserve(dpp_vec_##T* v, long long n) { \\\n"
+    "    if (n <= v->cap) return; \\\n"
+    "    if (n > DPP_VEC_MAX_LEN) dpp_vec_error(\"el vector supera el largo máximo\", 0); \\\n"
+    "    long long cap = v->cap ? v->cap : 16; \\\n"
+    "    while (cap < n) cap *= 2; \\\n"
+    "    v->data = dpp_vec_resize(v->data, (size_t)v->len * sizeof(T), (size_t)v->cap * sizeof(T), \\\n"
+    "                             (size_t)cap * sizeof(T)); \\\n"
+    "    v->cap = (int)cap; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_vec_##T##_push(dpp_vec_##T* v, T x) { \\\n"
+    "    if (__builtin_expect(v->len == v->cap, 0)) dpp_vec_##T##_reserve(v, (long long)v->len + 1); \\\n"
+    "    v->data[v->len++] = x; \\\n"
+    "    return v->len; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) T dpp_vec_##T##_pop(dpp_vec_##T* v, int line) { \\\n"
+    "    if (__builtin_expect(v->len == 0, 0)) dpp_vec_error(\"pop sobre un vector vacío\", line); \\\n"
+    "    return v->data[--v->len]; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_vec_##T##_len(dpp_vec_##T* v) { \\\n"
+    "    return v->len; \\\n"
+    "} \\\n"
+    "\\\n"
+    "DPP_RT int dpp_vec_##T##_fill(dpp_vec_##T* v, int n, T x, int line) { \\\n"
+    "    if (n < 0) dpp_vec_error(\"fill con un largo negativo\", line); \\\n"
+    "    dpp_vec_##T##_reserve(v, n); \\\n"
+    "    V b = (V){ 0 } + x; \\\n"
+    "    V* p = (V*)v->data; \\\n"
+    "    int blocks = n / 4; \\\n"
+    "    for (int i = 0; i < blocks; ++i) p[i] = b; \\\n"
+    "    for (int i = blocks * 4; i < n; ++i) v->data[i] = x; \\\n"
+    "    v->len = n; \\\n"
+    "    return n; \\\n"
+    "} \\\n"
+    "\\\n"
+    "DPP_RT int dpp_vec_##T##_copy(dpp_vec_##T* dst, dpp_vec_##T* src) { \\\n"
+    "    if (dst == src) return dst->len; \\\n"
+    "    dst->len = 0; \\\n"
+    "    dpp_vec_##T##_reserve(dst, src->len); \\\n"
+    "    if (src->len) memcpy(dst->data, src->data, (size_t)src->len * sizeof(T)); \\\n"
+    "    dst->len = src->len; \\\n"
+    "    return dst->len; \\\n"
+    "}\n"
+    "\n"
+    "// min y max: cuatro acumuladores recorren 64 bytes (una línea de caché) por vuelta.\n"
+    "#define DPP_VEC_MINMAX(T, V, NAME, OP) \\\n"
+    "DPP_RT T dpp_vec_##T##_##NAME(dpp_vec_##T* v, int line) { \\\n"
+    "    if (v->len == 0) dpp_vec_error(#NAME \" sobre un vector vacío\", line); \\\n"
+    "    const V* p = (const V*)v->data; \\\n"
+    "    int blocks = v->len / 16; \\\n"
+    "    T m = v->data[0]; \\\n"
+    "    if (blocks > 0) { \\\n"
+    "        V a = p[0], b = p[1], c = p[2], d = p[3]; \\\n"
+    "        for (int i = 1; i < blocks; ++i) { \\\n"
+    "            a = DPP_VSEL(V, p[4 * i] OP a, p[4 * i], a); \\\n"
+    "            b = DPP_VSEL(V, p[4 * i + 1] OP b, p[4 * i + 1], b); \\\n"
+    "            c = DPP_VSEL(V, p[4 * i + 2] OP c, p[4 * i + 2], c); \\\n"
+    "            d = DPP_VSEL(V, p[4 * i + 3] OP d, p[4 * i + 3], d); \\\n"
+    "        } \\\n"
+    "        a = DPP_VSEL(V, b OP a, b, a); \\\n"
+    "        c = DPP_VSEL(V, d OP c, d, c); \\\n"
+    "        a = DPP_VSEL(V, c OP a, c, a); \\\n"
+    "        for (int k = 0; k < 4; ++k) if (a[k] OP m) m = a[k]; \\\n"
+    "    } \\\n"
+    "    for (int i = blocks * 16; i < v->len; ++i) if (v->data[i] OP m) m = v->data[i]; \\\n"
+    "    return m; \\\n"
+    "}\n"
+    "\n"
+    "DPP_VEC_DEFINE(int, dpp_v4i)\n"
+    "DPP_VEC_DEFINE(float, dpp_v4f)\n"
+    "DPP_VEC_MINMAX(int, dpp_v4i, min, <)\n"
+    "DPP_VEC_MINMAX(int, dpp_v4i, max, >)\n"
+    "DPP_VEC_MINMAX(float, dpp_v4f, min, <)\n"
+    "DPP_VEC_MINMAX(float, dpp_v4f, max, >)\n"
+    "\n"
+    "// La suma de enteros se acumula sin signo: desborda dando la vuelta, como en el ciclo escalar.\n"
+    "DPP_RT int dpp_vec_int_sum(dpp_vec_int* v) {\n"
+    "    const dpp_v4u* p = (const dpp_v4u*)v->data;\n"
+    "    int blocks = v->len / 16;\n"
+    "    dpp_v4u a = { 0 }, b = { 0 }, c = { 0 }, d = { 0 };\n"
+    "    for (int i = 0; i < blocks; ++i) {\n"
+    "        a += p[4 * i];\n"
+    "        b += p[4 * i + 1];\n"
+    "        c += p[4 * i + 2];\n"
+    "        d += p[4 * i + 3];\n"
+    "    }\n"
+    "    a += b + c + d;\n"
+    "    unsigned s = 0;\n"
+    "    for (int k = 0; k < 4; ++k) s += a[k];\n"
+    "    for (int i = blocks * 16; i < v->len; ++i) s += (unsigned)v->data[i];\n"
+    "    return (int)s;\n"
+    "}\n"
+    "\n"
+    "// La suma de floating se reparte en 16 sumas parciales: el redondeo puede diferir del orden\n"
+    "// secuencial en los últimos decimales.\n"
+    "DPP_RT float dpp_vec_float_sum(dpp_vec_float* v) {\n"
+    "    const dpp_v4f* p = (const dpp_v4f*)v->data;\n"
+    "    int blocks = v->len / 16;\n"
+    "    dpp_v4f a = { 0 }, b = { 0 }, c = { 0 }, d = { 0 };\n"
+    "    for (int i = 0; i < blocks; ++i) {\n"
+    "        a += p[4 * i];\n"
+    "        b += p[4 * i + 1];\n"
+    "        c += p[4 * i + 2];\n"
+    "        d += p[4 * i + 3];\n"
+    "    }\n"
+    "    a += b + c + d;\n"
+    "    float s = 0;\n"
+    "    for (int k = 0; k < 4; ++k) s += a[k];\n"
+    "    for (int i = blocks * 16; i < v->len; ++i) s += v->data[i];\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "#define DPP_VEC_CLEANUP(T) __attribute__((cleanup(dpp_vec_##T##_free)))\n";
+
+static const char runtime_map[] =
+    "/* ---- Maps ---- */\n"
+    "// Tablas hash de direccionamiento abierto al estilo Swiss table. Un byte de control por\n"
+    "// casilla: DPP_CTRL_EMPTY o los 7 bits altos del hash de la clave. Las casillas se agrupan\n"
+    "// de a 16 y se compara un grupo entero de bytes de control con una instrucción SSE2;\n"
+    "// solo las casillas que coinciden en esos 7 bits se comparan de verdad. El sondeo salta\n"
+    "// de grupo en grupo (triangular) hasta encontrar uno con una casilla vacía. Se agranda al\n"
+    "// doble al pasar 7/8 de ocupación. No hay borrado, así que no hacen falta lápidas.\n"
+    "#if defined(__SSE2__)\n"
+    "#include <emmintrin.h>\n"
+    "#endif\n"
+    "\n"
+    "#define DPP_MAP_GROUP 16\n"
+    "#define DPP_CTRL_EMPTY ((int8_t)-128)\n"
+    "#define DPP_MAP_INIT { 0 }\n"
+    "\n"
+    "typedef union {\n"
+    "    int i;\n"
+    "    float f;\n"
+    "} dpp_value;\n"
+    "\n"
+    "static inline unsigned dpp_group_match(const int8_t* ctrl, int8_t h2) {\n"
+    "#if defined(__SSE2__)\n"
+    "    __m128i g = _mm_load_si128((const __m128i*)ctrl);\n"
+    "    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(h2)));\n"
+    "#else\n"
+    "    unsigned bits = 0;\n"
+    "    for (int i = 0; i < DPP_MAP_GROUP; ++i) bits |= (unsigned)(ctrl[i] == h2) << i;\n"
+    "    return bits;\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "// Casillas vacías del grupo: las únicas con el bit de signo encendido.\n"
+    "static inline unsigned dpp_group_empty(const int8_t* ctrl) {\n"
+    "#if defined(__SSE2__)\n"
+    "    return (unsigned)_mm_movemask_epi8(_mm_load_si128((const __m128i*)ctrl));\n"
+    "#else\n"
+    "    unsigned bits = 0;\n"
+    "    for (int i = 0; i < DPP_MAP_GROUP; ++i) bits |= (unsigned)(ctrl[i] < 0) << i;\n"
+    "    return bits;\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "static inline int8_t dpp_hash_h2(uint64_t h) {\n"
+    "    return (int8_t)(h >> 57);\n"
+    "}\n"
+    "\n"
+    "static inline size_t dpp_hash_group(uint64_t h, size_t group_mask) {\n"
+    "    return (size_t)(h >> 7) & group_mask;\n"
+    "}\n"
+    "\n"
+    "DPP_RT int8_t* dpp_ctrl_new(size_t cap) {\n"
+    "    int8_t* ctrl = aligned_alloc(DPP_MAP_GROUP, cap);\n"
+    "    if (!ctrl) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente para el map.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    memset(ctrl, DPP_CTRL_EMPTY, cap);\n"
+    "    return ctrl;\n"
+    "}\n"
+    "\n"
+    "// Primera casilla vacía en la secuencia de sondeo de h.\n"
+    "static inline size_t dpp_ctrl_free_slot(const int8_t* ctrl, uint64_t h, size_t group_mask) {\n"
+    "    size_t g = dpp_hash_group(h, group_mask);\n"
+    "    for (size_t stride = 0;; g = (g + ++stride) & group_mask) {\n"
+    "        unsigned bits = dpp_group_empty(ctrl + g * DPP_MAP_GROUP);\n"
+    "        if (bits) return g * DPP_MAP_GROUP + (size_t)__builtin_ctz(bits);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t dpp_hash_int(int key) {\n"
+    "    uint64_t z = (uint64_t)(uint32_t)key;\n"
+    "    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;\n"
+    "    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;\n"
+    "    return z ^ (z >> 31);\n"
+    "}\n"
+    "\n"
+    "/* ---- Map con claves integer ---- */\n"
+    "typedef struct {\n"
+    "    int key;\n"
+    "    dpp_value value;\n"
+    "} dpp_map_int_slot;\n"
+    "\n"
+    "typedef struct {\n"
+    "    int8_t* ctrl;\n"
+    "    dpp_map_int_slot* slots;\n"
+    "    size_t cap;          // casillas: múltiplo de 16 y potencia de dos, o 0\n"
+    "    size_t growth_left;  // inserciones posibles antes de agrandar\n"
+    "    int len;\n"
+    "} dpp_map_int;\n"
+    "\n"
+    "DPP_RT void dpp_map_int_free(dpp_map_int* m) {\n"
+    "    free(m->ctrl);\n"
+    "    free(m->slots);\n"
+    "}\n"
+    "\n"
+    "static inline dpp_map_int_slot* dpp_map_int_find(const dpp_map_int* m, int key, uint64_t h) {\n"
+    "    if (!m->cap) return NULL;\n"
+    "    size_t group_mask = m->cap / DPP_MAP_GROUP - 1;\n"
+    "    int8_t h2 = dpp_hash_h2(h);\n"
+    "    size_t g = dpp_hash_group(h, group_mask);\n"
+    "    for (size_t stride = 0;; g = (g + ++stride) & group_mask) {\n"
+    "        const int8_t* ctrl = m->ctrl + g * DPP_MAP_GROUP;\n"
+    "        for (unsigned bits = dpp_group_match(ctrl, h2); bits; bits &= bits - 1) {\n"
+    "            dpp_map_int_slot* s = &m->slots[g * DPP_MAP_GROUP + (size_t)__builtin_ctz(bits)];\n"
+    "            if (s->key == key) return s;\n"
+    "        }\n"
+    "        if (dpp_group_empty(ctrl)) return NULL;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "__attribute__((noinline))\n"
+    "DPP_RT void dpp_map_int_grow(dpp_map_int* m) {\n"
+    "    size_t cap = m->cap ? m->cap * 2 : DPP_MAP_GROUP;\n"
+    "    int8_t* ctrl = dpp_ctrl_new(cap);\n"
+    "    dpp_map_int_slot* slots = malloc(cap * sizeof(dpp_map_int_slot));\n"
+    "    if (!slots) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente para el map.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    for (size_t i = 0; i < m->cap; ++i) {\n"
+    "        if (m->ctrl[i] < 0) continue;\n"
+    "        uint64_t h = dpp_hash_int(m->slots[i].key);\n"
+    "        size_t j = dpp_ctrl_free_slot(ctrl, h, cap / DPP_MAP_GROUP - 1);\n"
+    "        ctrl[j] = dpp_hash_h2(h);\n"
+    "        slots[j] = m->slots[i];\n"
+    "    }\n"
+    "    dpp_map_int_free(m);\n"
+    "    m->ctrl = ctrl;\n"
+    "    m->slots = slots;\n"
+    "    m->cap = cap;\n"
+    "    m->growth_left = cap - cap / 8 - (size_t)m->len;\n"
+    "}\n"
+    "\n"
+    "// Devuelve 1 si la clave no estaba.\n"
+    "static inline int dpp_map_int_put(dpp_map_int* m, int key, dpp_value value) {\n"
+    "    uint64_t h = dpp_hash_int(key);\n"
+    "    dpp_map_int_slot* s = dpp_map_int_find(m, key, h);\n"
+    "    if (s) {\n"
+    "        s->value = value;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    if (!m->growth_left) dpp_map_int_grow(m);\n"
+    "    size_t j = dpp_ctrl_free_slot(m->ctrl, h, m->cap / DPP_MAP_GROUP - 1);\n"
+    "    m->ctrl[j] = dpp_hash_h2(h);\n"
+    "    m->slots[j].key = key;\n"
+    "    m->slots[j].value = value;\n"
+    "    m->growth_left--;\n"
+    "    m->len++;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// Una clave ausente vale 0.\n"
+    "static inline dpp_value dpp_map_int_get(const dpp_map_int* m, int key) {\n"
+    "    dpp_map_int_slot* s = dpp_map_int_find(m, key, dpp_hash_int(key));\n"
+    "    dpp_value zero = { 0 };\n"
+    "    return s ? s->value : zero;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_map_int_has(const dpp_map_int* m, int key) {\n"
+    "    return dpp_map_int_find(m, key, dpp_hash_int(key)) != NULL;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_map_int_len(const dpp_map_int* m) {\n"
+    "    return m->len;\n"
+    "}\n"
+    "\n"
+    "// Recorrido en el orden de las casillas; *pos avanza hasta la siguiente ocupada.\n"
+    "static inline int dpp_map_int_next(const dpp_map_int* m, size_t* pos, int* key) {\n"
+    "    for (size_t i = *pos; i < m->cap; ++i) {\n"
+    "        if (m->ctrl[i] >= 0) {\n"
+    "            *key = m->slots[i].key;\n"
+    "            *pos = i + 1;\n"
+    "            return 1;\n"
+    "        }\n"
+    "    }\n"
+    "    *pos = m->cap;\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "#define DPP_MAP_CLEANUP(K) __attribute__((cleanup(dpp_map_##K##_free)))\n";
+
+static const char runtime_map_chain[] =
+    "/* ---- Map con claves chain ---- */\n"
+    "// Cada casilla guarda el hash completo de su clave: al agrandar no se recalcula, y antes\n"
+    "// de comparar bytes se descartan las claves con otro hash. Las claves de los búferes\n"
+    "// largos ya traen su hash guardado (dpp_chain_hash), así que buscarlas no las recorre.\n"
+    "typedef struct {\n"
+    "    dpp_chain key;\n"
+    "    uint64_t hash;\n"
+    "    dpp_value value;\n"
+    "} dpp_map_chain_slot;\n"
+    "\n"
+    "typedef struct {\n"
+    "    int8_t* ctrl;\n"
+    "    dpp_map_chain_slot* slots;\n"
+    "    size_t cap;\n"
+    "    size_t growth_left;\n"
+    "    int len;\n"
+    "} dpp_map_chain;\n"
+    "\n"
+    "DPP_RT void dpp_map_chain_free(dpp_map_chain* m) {\n"
+    "    for (size_t i = 0; i < m->cap; ++i)\n"
+    "        if (m->ctrl[i] >= 0) dpp_chain_drop(&m->slots[i].key);\n"
+    "    free(m->ctrl);\n"
+    "    free(m->slots);\n"
+    "}\n"
+    "\n"
+    "static inline dpp_map_chain_slot* dpp_map_chain_find(const dpp_map_chain* m, const dpp_chain* key,\n"
+    "                                                     uint64_t h) {\n"
+    "    if (!m->cap) return NULL;\n"
+    "    size_t group_mask = m->cap / DPP_MAP_GROUP - 1;\n"
+    "    int8_t h2 = dpp_hash_h2(h);\n"
+    "    size_t g = dpp_hash_group(h, group_mask);\n"
+    "    const char* data = dpp_chain_data(key);\n"
+    "    for (size_t stride = 0;; g = (g + ++stride) & group_mask) {\n"
+    "        const int8_t* ctrl = m->ctrl + g * DPP_MAP_GROUP;\n"
+    "        for (unsigned bits = dpp_group_match(ctrl, h2); bits; bits &= bits - 1) {\n"
+    "            dpp_map_chain_slot* s = &m->slots[g * DPP_MAP_GROUP + (size_t)__builtin_ctz(bits)];\n"
+    "            if (s->hash == h && s->key.len == key->len &&\n"
+    "                memcmp(dpp_chain_data(&s->key), data, key->len) == 0)\n"
+    "                return s;\n"
+    "        }\n"
+    "        if (dpp_group_empty(ctrl)) return NULL;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "__attribute__((noinline))\n"
+    "DPP_RT void dpp_map_chain_grow(dpp_map_chain* m) {\n"
+    "    size_t cap = m->cap ? m->cap * 2 : DPP_MAP_GROUP;\n"
+    "    int8_t* ctrl = dpp_ctrl_new(cap);\n"
+    "    dpp_map_chain_slot* slots = malloc(cap * sizeof(dpp_map_chain_slot));\n"
+    "    if (!slots) {\n"
+    "        fprintf(stderr, \"Error: memoria insuficiente para el map.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    for (size_t i = 0; i < m->cap; ++i) {\n"
+    "        if (m->ctrl[i] < 0) continue;\n"
+    "        size_t j = dpp_ctrl_free_slot(ctrl, m->slots[i].hash, cap / DPP_MAP_GROUP - 1);\n"
+    "        ctrl[j] = dpp_hash_h2(m->slots[i].hash);\n"
+    "        slots[j] = m->slots[i];\n"
+    "    }\n"
+    "    free(m->ctrl);\n"
+    "    free(m->slots);\n"
+    "    m->ctrl = ctrl;\n"
+    "    m->slots = slots;\n"
+    "    m->cap = cap;\n"
+    "    m->growth_left = cap - cap / 8 - (size_t)m->len;\n"
+    "}\n"
+    "\n"
+    "// La clave se guarda como copia compartida; una vista o un temporal de la región se\n"
+    "// copian para no retener (o perder) el búfer del que salieron.\n"
+    "DPP_RT int dpp_map_chain_put(dpp_map_chain* m, const dpp_chain* key, dpp_value value) {\n"
+    "    uint64_t h = dpp_chain_hash(key);\n"
+    "    dpp_map_chain_slot* s = dpp_map_chain_find(m, key, h);\n"
+    "    if (s) {\n"
+    "        s->value = value;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    if (!m->growth_left) dpp_map_chain_grow(m);\n"
+    "    size_t j = dpp_ctrl_free_slot(m->ctrl, h, m->cap / DPP_MAP_GROUP - 1);\n"
+    "    m->ctrl[j] = dpp_hash_h2(h);\n"
+    "    s = &m->slots[j];\n"
+    "    if (key->kind == DPP_STR_SLICE || (key->kind == DPP_STR_HEAP && key->heap->in_region))\n"
+    "        s->key = dpp_chain_from(dpp_chain_data(key), key->len);\n"
+    "    else\n"
+    "        s->key = dpp_chain_copy(key);\n"
+    "    s->hash = h;\n"
+    "    s->value = value;\n"
+    "    m->growth_left--;\n"
+    "    m->len++;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static inline dpp_value dpp_map_chain_get(const dpp_map_chain* m, const dpp_chain* key) {\n"
+    "    dpp_map_chain_slot* s = dpp_map_chain_find(m, key, dpp_chain_hash(key));\n"
+    "    dpp_value zero = { 0 };\n"
+    "    return s ? s->value : zero;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_map_chain_has(const dpp_map_chain* m, const dpp_chain* key) {\n"
+    "    return dpp_map_chain_find(m, key, dpp_chain_hash(key)) != NULL;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_map_chain_len(const dpp_map_chain* m) {\n"
+    "    return m->len;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_map_chain_next(const dpp_map_chain* m, size_t* pos, dpp_chain* key) {\n"
+    "    for (size_t i = *pos; i < m->cap; ++i) {\n"
+    "        if (m->ctrl[i] >= 0) {\n"
+    "            dpp_chain_move(key, dpp_chain_copy(&m->slots[i].key));\n"
+    "            *pos = i + 1;\n"
+    "            return 1;\n"
+    "        }\n"
+    "    }\n"
+    "    *pos = m->cap;\n"
+    "    return 0;\n"
+    "}\n";
+
+static const char runtime_parallel[] =
+    "/* ---- Parallel for y spawn/sync: pool de hilos con robo de trabajo ---- */\n"
+    "#include <time.h>\n"
+    "\n"
+    "// Un parallel for en curso. Sus tareas son tramos [lo, hi) de iteraciones.\n"
+    "typedef struct {\n"
+    "    void (*fn)(void*, int, int);\n"
+    "    void* ctx;\n"
+    "    int grain;          // tramo mínimo que vale la pena partir\n"
+    "    long remaining;     // iteraciones que faltan terminar\n"
+    "} dpp_pfor_job;\n"
+    "\n"
+    "// Una llamada lanzada con spawn. El código generado la extiende con los argumentos y el\n"
+    "// puntero al resultado (struct dpp_spawn_<función>); run hace la llamada.\n"
+    "typedef struct dpp_task_frame {\n"
+    "    void (*run)(struct dpp_task_frame*);\n"
+    "    long* pending;                  // contador del grupo que espera el sync\n"
+    "    struct dpp_task_frame* next;    // en la lista libre del hilo\n"
+    "    size_t size;\n"
+    "} dpp_task_frame;\n"
+    "\n"
+    "// Las tareas lanzadas por una llamada a función que todavía no terminaron.\n"
+    "typedef struct {\n"
+    "    long pending;\n"
+    "} dpp_spawn_group;\n"
+    "\n"
+    "// Un tramo de un parallel for o, con job == NULL, una tarea de spawn.\n"
+    "typedef struct {\n"
+    "    dpp_pfor_job* job;\n"
+    "    int lo, hi;\n"
+    "    dpp_task_frame* frame;\n"
+    "} dpp_task;\n"
+    "\n"
+    "// Cola de Chase-Lev de capacidad fija: el dueño agrega y saca por abajo y los demás hilos\n"
+    "// roban por arriba. Si se llena, el dueño ejecuta el tramo sin partirlo.\n"
+    "#define DPP_DEQUE_SIZE 1024\n"
+    "\n"
+    "typedef struct {\n"
+    "    long top __attribute__((aligned(64)));\n"
+    "    long bottom __attribute__((aligned(64)));\n"
+    "    dpp_task tasks[DPP_DEQUE_SIZE];\n"
+    "} dpp_deque;\n"
+    "\n"
+    "// Los frames de tarea son de tamaño fijo y cada hilo recicla los que libera en una lista\n"
+    "// propia, sin sincronizar: un frame lo puede liberar un hilo distinto del que lo pidió.\n"
+    "#define DPP_TASK_FRAME_SIZE 128\n"
+    "#define DPP_FREE_FRAMES_MAX 1024\n"
+    "\n"
+    "typedef struct {\n"
+    "    dpp_deque deque;\n"
+    "    unsigned seed;\n"
+    "    dpp_task_frame* free_frames;\n"
+    "    int free_count;\n"
+    "    // Estadísticas (DPP_SCHED_STATS): solo las escribe el dueño.\n"
+    "    long tasks;\n"
+    "    long steals;\n"
+    "    long long idle_ns;\n"
+    "} dpp_worker;\n"
+    "\n"
+    "// Hay lugar para DPP_MAX_WORKERS hilos desde el principio porque, con channels, el pool\n"
+    "// puede crecer mientras los demás hilos recorren el arreglo buscando qué robar. Cada\n"
+    "// lugar se inicializa recién al crear su hilo, así que las páginas que no se usan no se tocan.\n"
+    "#define DPP_MAX_WORKERS 256\n"
+    "\n"
+    "static dpp_worker* dpp_workers = NULL;\n"
+    "static int dpp_worker_count = 0;\n"
+    "static __thread dpp_worker* dpp_self = NULL;\n"
+    "static pthread_mutex_t dpp_pool_lock = PTHREAD_MUTEX_INITIALIZER;\n"
+    "\n"
+    "// Pasa a 1 cuando se crea un channel: desde ahí una tarea puede quedar bloqueada esperando\n"
+    "// a otra, así que ninguna se ejecuta en el momento del spawn.\n"
+    "static int dpp_tasks_may_block = 0;\n"
+    "\n"
+    "static inline int dpp_workers_now(void) {\n"
+    "    return __atomic_load_n(&dpp_worker_count, __ATOMIC_ACQUIRE);\n"
+    "}\n"
+    "\n"
+    "// Los hilos sin trabajo duermen en un futex sobre dpp_pool_epoch, que cambia cuando\n"
+    "// aparecen tareas nuevas y hay alguien durmiendo.\n"
+    "static int dpp_pool_epoch = 0;\n"
+    "static int dpp_pool_sleeping = 0;\n"
+    "static int dpp_sched_stats = 0;\n"
+    "\n"
+    "#define DPP_STAT_ADD(field, n) __atomic_store_n(&(field), (field) + (n), __ATOMIC_RELAXED)\n"
+    "\n"
+    "static inline long long dpp_now_ns(void) {\n"
+    "    struct timespec ts;\n"
+    "    clock_gettime(CLOCK_MONOTONIC, &ts);\n"
+    "    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;\n"
+    "}\n"
+    "\n"
+    "// Tiempo ocioso: desde la primera búsqueda sin éxito hasta que se consigue una tarea.\n"
+    "static inline void dpp_idle_begin(long long* since) {\n"
+    "    if (dpp_sched_stats && !*since) *since = dpp_now_ns();\n"
+    "}\n"
+    "\n"
+    "static inline void dpp_idle_end(dpp_worker* w, long long* since) {\n"
+    "    if (*since) {\n"
+    "        DPP_STAT_ADD(w->idle_ns, dpp_now_ns() - *since);\n"
+    "        *since = 0;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_deque_push(dpp_deque* d, dpp_task task) {\n"
+    "    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);\n"
+    "    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);\n"
+    "    if (b - t >= DPP_DEQUE_SIZE) return 0;\n"
+    "    d->tasks[b & (DPP_DEQUE_SIZE - 1)] = task;\n"
+    "    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELEASE);\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_deque_pop(dpp_deque* d, dpp_task* task) {\n"
+    "    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;\n"
+    "    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);\n"
+    "    __atomic_thread_fence(__ATOMIC_SEQ_CST);\n"
+    "    long t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);\n"
+    "    if (t > b) {\n"
+    "        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);\n"
+    "        return 0;\n"
+    "    }\n"
+    "    *task = d->tasks[b & (DPP_DEQUE_SIZE - 1)];\n"
+    "    if (t < b) return 1;\n"
+    "    // Era la última: se la disputa con los ladrones.\n"
+    "    int won = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);\n"
+    "    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);\n"
+    "    return won;\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_deque_steal(dpp_deque* d, dpp_task* task) {\n"
+    "    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);\n"
+    "    __atomic_thread_fence(__ATOMIC_SEQ_CST);\n"
+    "    long b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);\n"
+    "    if (t >= b) return 0;\n"
+    "    *task = d->tasks[t & (DPP_DEQUE_SIZE - 1)];\n"
+    "    return __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_deque_empty(dpp_deque* d) {\n"
+    "    return __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) <= __atomic_load_n(&d->top, __ATOMIC_RELAXED);\n"
+    "}\n"
+    "\n"
+    "static inline void dpp_pool_notify(void) {\n"
+    "    __atomic_thread_fence(__ATOMIC_SEQ_CST);\n"
+    "    if (__atomic_load_n(&dpp_pool_sleeping, __ATOMIC_SEQ_CST) > 0) {\n"
+    "        __atomic_fetch_add(&dpp_pool_epoch, 1, __ATOMIC_SEQ_CST);\n"
+    "        dpp_wake_all(&dpp_pool_epoch);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Primero la cola propia; si está vacía, roba a los demás empezando por uno al azar.\n"
+    "static int dpp_find_task(dpp_worker* w, dpp_task* task) {\n"
+    "    if (dpp_deque_pop(&w->deque, task)) return 1;\n"
+    "    int count = dpp_workers_now();\n"
+    "    w->seed = w->seed * 1103515245u + 12345u;\n"
+    "    int start = (int)((w->seed >> 16) % (unsigned)count);\n"
+    "    for (int i = 0; i < count; ++i) {\n"
+    "        dpp_worker* victim = &dpp_workers[(start + i) % count];\n"
+    "        if (victim != w && dpp_deque_steal(&victim->deque, task)) {\n"
+    "            DPP_STAT_ADD(w->steals, 1);\n"
+    "            return 1;\n"
+    "        }\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static void dpp_frame_release(dpp_worker* w, dpp_task_frame* f) {\n"
+    "    if (f->size == DPP_TASK_FRAME_SIZE && w->free_count < DPP_FREE_FRAMES_MAX) {\n"
+    "        f->next = w->free_frames;\n"
+    "        w->free_frames = f;\n"
+    "        w->free_count++;\n"
+    "    } else {\n"
+    "        free(f);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static void dpp_run_frame(dpp_worker* w, dpp_task_frame* f) {\n"
+    "    long* pending = f->pending;\n"
+    "    f->run(f);\n"
+    "    dpp_frame_release(w, f);\n"
+    "    DPP_STAT_ADD(w->tasks, 1);\n"
+    "    if (pending) __atomic_fetch_sub(pending, 1, __ATOMIC_RELEASE);\n"
+    "}\n"
+    "\n"
+    "// Partición perezosa: el tramo se parte en dos solo cuando la cola propia está vacía, es\n"
+    "// decir, cuando otro hilo se llevó lo que había y puede haber hilos sin trabajo. Mientras\n"
+    "// tanto se ejecuta de a grain iteraciones, así que el reparto se adapta a la carga real.\n"
+    "static void dpp_run_task(dpp_worker* w, dpp_task task) {\n"
+    "    if (!task.job) {\n"
+    "        dpp_run_frame(w, task.frame);\n"
+    "        return;\n"
+    "    }\n"
+    "    DPP_STAT_ADD(w->tasks, 1);\n"
+    "    dpp_pfor_job* job = task.job;\n"
+    "    int lo = task.lo, hi = task.hi;\n"
+    "    while (lo < hi) {\n"
+    "        if ((long)hi - lo > 2L * job->grain && dpp_deque_empty(&w->deque)) {\n"
+    "            int mid = (int)(((long)lo + hi) / 2);\n"
+    "            if (dpp_deque_push(&w->deque, (dpp_task){ job, mid, hi, NULL })) {\n"
+    "                hi = mid;\n"
+    "                dpp_pool_notify();\n"
+    "                continue;\n"
+    "            }\n"
+    "        }\n"
+    "        int end = (long)hi - lo > job->grain ? lo + job->grain : hi;\n"
+    "        job->fn(job->ctx, lo, end);\n"
+    "        __atomic_fetch_sub(&job->remaining, (long)end - lo, __ATOMIC_ACQ_REL);\n"
+    "        lo = end;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static void* dpp_worker_main(void* arg) {\n"
+    "    dpp_worker* w = arg;\n"
+    "    dpp_self = w;\n"
+    "    dpp_task task;\n"
+    "    long long idle = 0;\n"
+    "    for (;;) {\n"
+    "        int spins = 0;\n"
+    "        while (!dpp_find_task(w, &task)) {\n"
+    "            dpp_idle_begin(&idle);\n"
+    "            if (++spins < 64) {\n"
+    "                dpp_cpu_relax();\n"
+    "                continue;\n"
+    "            }\n"
+    "            int epoch = __atomic_load_n(&dpp_pool_epoch, __ATOMIC_SEQ_CST);\n"
+    "            __atomic_fetch_add(&dpp_pool_sleeping, 1, __ATOMIC_SEQ_CST);\n"
+    "            int found = dpp_find_task(w, &task);\n"
+    "            if (!found) dpp_wait_while(&dpp_pool_epoch, epoch);\n"
+    "            __atomic_fetch_sub(&dpp_pool_sleeping, 1, __ATOMIC_SEQ_CST);\n"
+    "            if (found) break;\n"
+    "            spins = 0;\n"
+    "        }\n"
+    "        dpp_idle_end(w, &idle);\n"
+    "        dpp_run_task(w, task);\n"
+    "    }\n"
+    "    return NULL;\n"
+    "}\n"
+    "\n"
+    "static void dpp_sched_report(void) {\n"
+    "    int count = dpp_workers_now();\n"
+    "    for (int i = 0; i < count; ++i) {\n"
+    "        dpp_worker* w = &dpp_workers[i];\n"
+    "        fprintf(stderr, \"planificador: hilo %d: %ld tarea(s), %ld robo(s), %.1f ms ocioso\\n\", i,\n"
+    "                __atomic_load_n(&w->tasks, __ATOMIC_RELAXED), __atomic_load_n(&w->steals, __ATOMIC_RELAXED),\n"
+    "                __atomic_load_n(&w->idle_ns, __ATOMIC_RELAXED) / 1e6);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Agrega un hilo al pool; devuelve 0 si no se pudo.\n"
+    "static int dpp_pool_add_worker(void) {\n"
+    "    pthread_mutex_lock(&dpp_pool_lock);\n"
+    "    int i = dpp_worker_count, added = 0;\n"
+    "    if (i < DPP_MAX_WORKERS) {\n"
+    "        memset(&dpp_workers[i], 0, sizeof(dpp_worker));\n"
+    "        dpp_workers[i].seed = 2654435761u * (unsigned)(i + 1);\n"
+    "        pthread_t thread;\n"
+    "        if (pthread_create(&thread, NULL, dpp_worker_main, &dpp_workers[i]) == 0) {\n"
+    "            pthread_detach(thread);\n"
+    "            __atomic_store_n(&dpp_worker_count, i + 1, __ATOMIC_RELEASE);\n"
+    "            added = 1;\n"
+    "        }\n"
+    "    }\n"
+    "    pthread_mutex_unlock(&dpp_pool_lock);\n"
+    "    return added;\n"
+    "}\n"
+    "\n"
+    "// Los hilos se crean con el primer parallel for o spawn: uno por CPU, o DPP_THREADS. El\n"
+    "// hilo principal es el trabajador 0. Con DPP_SCHED_STATS se informa al salir cuántas\n"
+    "// tareas ejecutó y robó cada hilo y cuánto tiempo estuvo sin trabajo.\n"
+    "static void dpp_pool_start(void) {\n"
+    "    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);\n"
+    "    const char* env = getenv(\"DPP_THREADS\");\n"
+    "    if (env && atoi(env) > 0) n = atoi(env);\n"
+    "    if (n < 1) n = 1;\n"
+    "    if (n > DPP_MAX_WORKERS) n = DPP_MAX_WORKERS;\n"
+    "    dpp_workers = aligned_alloc(64, sizeof(dpp_worker) * DPP_MAX_WORKERS);\n"
+    "    if (!dpp_workers) {\n"
+    "        fprintf(stderr, \"Error: no hay memoria para los hilos de parallel for.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    memset(&dpp_workers[0], 0, sizeof(dpp_worker));\n"
+    "    dpp_workers[0].seed = 2654435761u;\n"
+    "    dpp_worker_count = 1;\n"
+    "    dpp_self = &dpp_workers[0];\n"
+    "    if (getenv(\"DPP_SCHED_STATS\")) {\n"
+    "        dpp_sched_stats = 1;\n"
+    "        atexit(dpp_sched_report);\n"
+    "    }\n"
+    "    for (int i = 1; i < n; ++i)\n"
+    "        if (!dpp_pool_add_worker()) break;\n"
+    "}\n"
+    "\n"
+    "// Ejecuta tareas pendientes hasta que *remaining llegue a 0.\n"
+    "static void dpp_help_while(dpp_worker* w, long* remaining) {\n"
+    "    dpp_task task;\n"
+    "    int spins = 0;\n"
+    "    long long idle = 0;\n"
+    "    while (__atomic_load_n(remaining, __ATOMIC_ACQUIRE) > 0) {\n"
+    "        if (dpp_find_task(w, &task)) {\n"
+    "            dpp_idle_end(w, &idle);\n"
+    "            dpp_run_task(w, task);\n"
+    "            spins = 0;\n"
+    "            continue;\n"
+    "        }\n"
+    "        dpp_idle_begin(&idle);\n"
+    "        if (++spins < 1024) dpp_cpu_relax();\n"
+    "        else sched_yield();\n"
+    "    }\n"
+    "    dpp_idle_end(w, &idle);\n"
+    "}\n"
+    "\n"
+    "// Ejecuta fn(ctx, lo', hi') sobre tramos que cubren [lo, hi) y vuelve cuando terminaron\n"
+    "// todos. Mientras espera, el hilo que llama ayuda con cualquier tarea pendiente, así que\n"
+    "// un parallel for dentro de otro no bloquea a nadie.\n"
+    "DPP_RT void dpp_parallel_for(void (*fn)(void*, int, int), void* ctx, int lo, int hi) {\n"
+    "    if (lo >= hi) return;\n"
+    "    if (!dpp_workers) dpp_pool_start();\n"
+    "    int count = dpp_workers_now();\n"
+    "    if (count == 1) {\n"
+    "        fn(ctx, lo, hi);\n"
+    "        return;\n"
+    "    }\n"
+    "    long n = (long)hi - lo;\n"
+    "    long grain = n / (32L * count);\n"
+    "    if (grain < 1) grain = 1;\n"
+    "    if (grain > 4096) grain = 4096;\n"
+    "    dpp_pfor_job job = { fn, ctx, (int)grain, n };\n"
+    "    dpp_worker* w = dpp_self;\n"
+    "    dpp_run_task(w, (dpp_task){ &job, lo, hi, NULL });\n"
+    "    dpp_help_while(w, &job.remaining);\n"
+    "}\n"
+    "\n"
+    "// Combinan el resultado parcial de un tramo con el acumulador de una reducción. La suma y\n"
+    "// el producto dan la vuelta como en unsigned, igual que en la versión SIMD.\n"
+    "DPP_RT void dpp_reduce_add(int* acc, int x) {\n"
+    "    __atomic_fetch_add((unsigned*)acc, (unsigned)x, __ATOMIC_RELAXED);\n"
+    "}\n"
+    "\n"
+    "#define DPP_REDUCE_CAS(NAME, NEXT) \\\n"
+    "DPP_RT void dpp_reduce_##NAME(int* acc, int x) { \\\n"
+    "    int old = __atomic_load_n(acc, __ATOMIC_RELAXED); \\\n"
+    "    while (!__atomic_compare_exchange_n(acc, &old, (NEXT), 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {} \\\n"
+    "}\n"
+    "\n"
+    "DPP_REDUCE_CAS(mul, (int)((unsigned)old * (unsigned)x))\n"
+    "DPP_REDUCE_CAS(min, x < old ? x : old)\n"
+    "DPP_REDUCE_CAS(max, x > old ? x : old)\n"
+    "\n"
+    "// Frame para una tarea de spawn, de la lista libre del hilo si hay uno.\n"
+    "DPP_RT dpp_task_frame* dpp_spawn_alloc(size_t size) {\n"
+    "    if (!dpp_workers) dpp_pool_start();\n"
+    "    dpp_worker* w = dpp_self;\n"
+    "    dpp_task_frame* f;\n"
+    "    if (size <= DPP_TASK_FRAME_SIZE && w->free_frames) {\n"
+    "        f = w->free_frames;\n"
+    "        w->free_frames = f->next;\n"
+    "        w->free_count--;\n"
+    "        return f;\n"
+    "    }\n"
+    "    if (size < DPP_TASK_FRAME_SIZE) size = DPP_TASK_FRAME_SIZE;\n"
+    "    f = malloc(size);\n"
+    "    if (!f) {\n"
+    "        fprintf(stderr, \"Error: no hay memoria para las tareas de spawn.\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    f->size = size;\n"
+    "    return f;\n"
+    "}\n"
+    "\n"
+    "// La tarea va a la cola propia, de donde la puede robar otro hilo; el que la lanzó la\n"
+    "// ejecuta en el sync si nadie se la llevó. Con un solo hilo, o con la cola llena, la\n"
+    "// llamada se hace en el momento, salvo que haya channels: entonces la tarea podría\n"
+    "// esperar algo que recién hace el código que sigue al spawn.\n"
+    "DPP_RT void dpp_spawn(dpp_spawn_group* g, dpp_task_frame* f) {\n"
+    "    dpp_worker* w = dpp_self;\n"
+    "    if (dpp_workers_now() > 1 || __atomic_load_n(&dpp_tasks_may_block, __ATOMIC_RELAXED)) {\n"
+    "        f->pending = &g->pending;\n"
+    "        __atomic_fetch_add(&g->pending, 1, __ATOMIC_RELAXED);\n"
+    "        if (dpp_deque_push(&w->deque, (dpp_task){ NULL, 0, 0, f })) {\n"
+    "            dpp_pool_notify();\n"
+    "            return;\n"
+    "        }\n"
+    "        __atomic_fetch_sub(&g->pending, 1, __ATOMIC_RELAXED);\n"
+    "    }\n"
+    "    f->pending = NULL;\n"
+    "    dpp_run_frame(w, f);\n"
+    "}\n"
+    "\n"
+    "// Espera las tareas del grupo ejecutando, mientras tanto, las que haya pendientes.\n"
+    "DPP_RT void dpp_sync(dpp_spawn_group* g) {\n"
+    "    if (__atomic_load_n(&g->pending, __ATOMIC_ACQUIRE) == 0) return;\n"
+    "    dpp_help_while(dpp_self, &g->pending);\n"
+    "}\n";
+
+static const char runtime_channel[] =
+    "/* ---- Channels: colas acotadas sin locks entre tareas ---- */\n"
+    "// Un channel es un anillo con capacidad potencia de 2. Si el compilador probó que a lo sumo\n"
+    "// un hilo envía y uno recibe (spsc), cada lado avanza su índice con un store y guarda una\n"
+    "// copia del índice del otro lado, que solo vuelve a leer cuando el anillo parece lleno o\n"
+    "// vacío. Si no, es la cola de Vyukov: cada celda lleva un número de secuencia y los\n"
+    "// índices se toman con compare-and-swap. Los índices de cada lado, las palabras donde se\n"
+    "// duerme y los datos de solo lectura van en líneas de caché distintas.\n"
+    "#define DPP_CHAN_SPINS 256\n"
+    "#define DPP_CHAN_HIST (64 * 4)\n"
+    "\n"
+    "// Con DPP_CHAN_STATS cada mensaje lleva la hora del envío y al recibirlo se anota la\n"
+    "// latencia en un histograma logarítmico con 4 sub-tramos por potencia de 2.\n"
+    "typedef struct {\n"
+    "    long long* sent_ns;\n"
+    "    long long first_ns, last_ns;\n"
+    "    long messages;\n"
+    "    long hist[DPP_CHAN_HIST];\n"
+    "    int line;\n"
+    "} dpp_chan_stats;\n"
+    "\n"
+    "static int dpp_chan_stats_on = -1;\n"
+    "static int dpp_chan_blocked = 0;   // hilos dormidos en algún channel\n"
+    "static int dpp_chan_spins = -1;    // con una sola CPU girar no sirve: el otro lado no corre\n"
+    "\n"
+    "__attribute__((noreturn, cold, noinline))\n"
+    "DPP_RT void dpp_chan_no_memory(int line) {\n"
+    "    dpp_flush();\n"
+    "    fprintf(stderr, \"Error en la línea %d: memoria insuficiente para el channel.\\n\", line);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "static inline int dpp_chan_bucket(long long ns) {\n"
+    "    if (ns < 4) return ns < 0 ? 0 : (int)ns;\n"
+    "    int msb = 63 - __builtin_clzll((unsigned long long)ns);\n"
+    "    return msb * 4 + (int)((ns >> (msb - 2)) & 3);\n"
+    "}\n"
+    "\n"
+    "static inline long long dpp_chan_bucket_ns(int b) {\n"
+    "    if (b < 4) return b;\n"
+    "    return (4LL + (b & 3)) << (b / 4 - 2);\n"
+    "}\n"
+    "\n"
+    "__attribute__((noinline))\n"
+    "DPP_RT void dpp_chan_stats_send(dpp_chan_stats* s, long pos) {\n"
+    "    long long now = dpp_now_ns();\n"
+    "    long long zero = 0;\n"
+    "    __atomic_compare_exchange_n(&s->first_ns, &zero, now, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);\n"
+    "    s->sent_ns[pos] = now;\n"
+    "}\n"
+    "\n"
+    "__attribute__((noinline))\n"
+    "DPP_RT void dpp_chan_stats_recv(dpp_chan_stats* s, long pos) {\n"
+    "    long long now = dpp_now_ns();\n"
+    "    __atomic_fetch_add(&s->hist[dpp_chan_bucket(now - s->sent_ns[pos])], 1, __ATOMIC_RELAXED);\n"
+    "    __atomic_fetch_add(&s->messages, 1, __ATOMIC_RELAXED);\n"
+    "    __atomic_store_n(&s->last_ns, now, __ATOMIC_RELAXED);\n"
+    "}\n"
+    "\n"
+    "static long long dpp_chan_percentile(dpp_chan_stats* s, double p) {\n"
+    "    long target = (long)(s->messages * p), seen = 0;\n"
+    "    for (int b = 0; b < DPP_CHAN_HIST; ++b) {\n"
+    "        seen += s->hist[b];\n"
+    "        if (seen > target) return dpp_chan_bucket_ns(b);\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static void dpp_chan_stats_report(dpp_chan_stats* s, int spsc) {\n"
+    "    if (!s->messages) return;\n"
+    "    double secs = (s->last_ns - s->first_ns) / 1e9;\n"
+    "    fprintf(stderr, \"channel de la línea %d (%s): %ld mensaje(s), %.0f msg/s, latencia \"\n"
+    "            \"p50 %lld ns, p90 %lld ns, p99 %lld ns\\n\", s->line, spsc ? \"spsc\" : \"mpmc\",\n"
+    "            s->messages, secs > 0 ? s->messages / secs : 0.0, dpp_chan_percentile(s, 0.5),\n"
+    "            dpp_chan_percentile(s, 0.9), dpp_chan_percentile(s, 0.99));\n"
+    "}\n"
+    "\n"
+    "// ¿Queda alguna tarea en la cola de algún hilo?\n"
+    "static int dpp_pool_has_tasks(void) {\n"
+    "    if (!dpp_workers) return 0;\n"
+    "    int count = dpp_workers_now();\n"
+    "    for (int i = 0; i < count; ++i)\n"
+    "        if (!dpp_deque_empty(&dpp_workers[i].deque)) return 1;\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "// Duerme en *word mientras valga epoch. Si todos los hilos del pool quedaron dormidos en\n"
+    "// channels y hay tareas en alguna cola, la que falta para despertarlos nunca se\n"
+    "// ejecutaría: se agrega un hilo que la tome.\n"
+    "__attribute__((noinline))\n"
+    "DPP_RT void dpp_chan_sleep(int* word, int epoch) {\n"
+    "    int blocked = __atomic_add_fetch(&dpp_chan_blocked, 1, __ATOMIC_SEQ_CST);\n"
+    "    if (blocked >= dpp_workers_now() && dpp_pool_has_tasks()) dpp_pool_add_worker();\n"
+    "    dpp_sleep_while(word, epoch);\n"
+    "    __atomic_sub_fetch(&dpp_chan_blocked, 1, __ATOMIC_SEQ_CST);\n"
+    "}\n"
+    "\n"
+    "// Después de enviar (o recibir) despierta a los que esperan del otro lado, si hay alguno.\n"
+    "// El que despierta baja la marca, así los envíos que siguen mientras el otro hilo todavía\n"
+    "// no corrió no pagan otra llamada al sistema.\n"
+    "static inline void dpp_chan_notify(int* epoch, int* waiting) {\n"
+    "    __atomic_thread_fence(__ATOMIC_SEQ_CST);\n"
+    "    if (__builtin_expect(__atomic_load_n(waiting, __ATOMIC_RELAXED), 0) &&\n"
+    "        __atomic_exchange_n(waiting, 0, __ATOMIC_SEQ_CST)) {\n"
+    "        __atomic_fetch_add(epoch, 1, __ATOMIC_SEQ_CST);\n"
+    "        dpp_wake_all(epoch);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "#define DPP_CHAN_DEFINE(T) \\\n"
+    "typedef struct { \\\n"
+    "    long tail __attribute__((aligned(64)));     /* próximo envío */ \\\n"
+    "    long head_cache;                            /* spsc: última cabeza vista */ \\\n"
+    "    long head __attribute__((aligned(64)));     /* próxima recepción */ \\\n"
+    "    long tail_cache;                            /* spsc: última cola vista */ \\\n"
+    "    int space_epoch __attribute__((aligned(64))); \\\n"
+    "    int send_waiting;                           /* hay quien duerme esperando lugar */ \\\n"
+    "    int items_epoch __attribute__((aligned(64))); \\\n"
+    "    int recv_waiting; \\\n"
+    "    T* data __attribute__((aligned(64))); \\\n"
+    "    long* seq;                                  /* mpmc: secuencia de cada celda */ \\\n"
+    "    long mask; \\\n"
+    "    int spsc; \\\n"
+    "    dpp_chan_stats* stats; \\\n"
+    "} dpp_chan_##T; \\\n"
+    "\\\n"
+    "DPP_RT dpp_chan_##T* dpp_chan_##T##_new(long capacity, int spsc, int line) { \\\n"
+    "    long cap = 2; \\\n"
+    "    while (cap < capacity) cap <<= 1; \\\n"
+    "    dpp_chan_##T* c = aligned_alloc(64, sizeof(dpp_chan_##T)); \\\n"
+    "    if (!c) dpp_chan_no_memory(line); \\\n"
+    "    memset(c, 0, sizeof(*c)); \\\n"
+    "    c->data = aligned_alloc(64, ((sizeof(T) * cap + 63) / 64) * 64); \\\n"
+    "    c->mask = cap - 1; \\\n"
+    "    c->spsc = spsc; \\\n"
+    "    if (!spsc) { \\\n"
+    "        c->seq = aligned_alloc(64, ((sizeof(long) * cap + 63) / 64) * 64); \\\n"
+    "        if (c->seq) for (long i = 0; i < cap; ++i) c->seq[i] = i; \\\n"
+    "    } \\\n"
+    "    if (!c->data || (!spsc && !c->seq)) dpp_chan_no_memory(line); \\\n"
+    "    if (dpp_chan_stats_on < 0) { \\\n"
+    "        dpp_chan_stats_on = getenv(\"DPP_CHAN_STATS\") != NULL; \\\n"
+    "        dpp_chan_spins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? DPP_CHAN_SPINS : 0; \\\n"
+    "    } \\\n"
+    "    if (dpp_chan_stats_on) { \\\n"
+    "        c->stats = calloc(1, sizeof(dpp_chan_stats)); \\\n"
+    "        if (c->stats) c->stats->sent_ns = calloc(cap, sizeof(long long)); \\\n"
+    "        if (!c->stats || !c->stats->sent_ns) dpp_chan_no_memory(line); \\\n"
+    "        c->stats->line = line; \\\n"
+    "    } \\\n"
+    "    __atomic_store_n(&dpp_tasks_may_block, 1, __ATOMIC_RELAXED); \\\n"
+    "    return c; \\\n"
+    "} \\\n"
+    "\\\n"
+    "DPP_RT void dpp_chan_##T##_free(dpp_chan_##T** pc) { \\\n"
+    "    dpp_chan_##T* c = *pc; \\\n"
+    "    if (c->stats) { \\\n"
+    "        dpp_chan_stats_report(c->stats, c->spsc); \\\n"
+    "        free(c->stats->sent_ns); \\\n"
+    "        free(c->stats); \\\n"
+    "    } \\\n"
+    "    free(c->seq); \\\n"
+    "    free(c->data); \\\n"
+    "    free(c); \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_chan_##T##_try_send(dpp_chan_##T* c, T x) { \\\n"
+    "    long pos = __atomic_load_n(&c->tail, __ATOMIC_RELAXED); \\\n"
+    "    if (c->spsc) { \\\n"
+    "        if (pos - c->head_cache > c->mask) { \\\n"
+    "            c->head_cache = __atomic_load_n(&c->head, __ATOMIC_ACQUIRE); \\\n"
+    "            if (pos - c->head_cache > c->mask) return 0; \\\n"
+    "        } \\\n"
+    "        c->data[pos & c->mask] = x; \\\n"
+    "        if (__builtin_expect(c->stats != NULL, 0)) dpp_chan_stats_send(c->stats, pos & c->mask); \\\n"
+    "        __atomic_store_n(&c->tail, pos + 1, __ATOMIC_RELEASE); \\\n"
+    "        return 1; \\\n"
+    "    } \\\n"
+    "    for (;;) { \\\n"
+    "        long seq = __atomic_load_n(&c->seq[pos & c->mask], __ATOMIC_ACQUIRE); \\\n"
+    "        long diff = seq - pos; \\\n"
+    "        if (diff == 0) { \\\n"
+    "            if (__atomic_compare_exchange_n(&c->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break; \\\n"
+    "        } else if (diff < 0) { \\\n"
+    "            return 0; \\\n"
+    "        } else { \\\n"
+    "            pos = __atomic_load_n(&c->tail, __ATOMIC_RELAXED); \\\n"
+    "        } \\\n"
+    "    } \\\n"
+    "    c->data[pos & c->mask] = x; \\\n"
+    "    if (__builtin_expect(c->stats != NULL, 0)) dpp_chan_stats_send(c->stats, pos & c->mask); \\\n"
+    "    __atomic_store_n(&c->seq[pos & c->mask], pos + 1, __ATOMIC_RELEASE); \\\n"
+    "    return 1; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_chan_##T##_try_recv(dpp_chan_##T* c, T* x) { \\\n"
+    "    long pos = __atomic_load_n(&c->head, __ATOMIC_RELAXED); \\\n"
+    "    if (c->spsc) { \\\n"
+    "        if (pos >= c->tail_cache) { \\\n"
+    "            c->tail_cache = __atomic_load_n(&c->tail, __ATOMIC_ACQUIRE); \\\n"
+    "            if (pos >= c->tail_cache) return 0; \\\n"
+    "        } \\\n"
+    "        *x = c->data[pos & c->mask]; \\\n"
+    "        if (__builtin_expect(c->stats != NULL, 0)) dpp_chan_stats_recv(c->stats, pos & c->mask); \\\n"
+    "        __atomic_store_n(&c->head, pos + 1, __ATOMIC_RELEASE); \\\n"
+    "        return 1; \\\n"
+    "    } \\\n"
+    "    for (;;) { \\\n"
+    "        long seq = __atomic_load_n(&c->seq[pos & c->mask], __ATOMIC_ACQUIRE); \\\n"
+    "        long diff = seq - (pos + 1); \\\n"
+    "        if (diff == 0) { \\\n"
+    "            if (__atomic_compare_exchange_n(&c->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break; \\\n"
+    "        } else if (diff < 0) { \\\n"
+    "            return 0; \\\n"
+    "        } else { \\\n"
+    "            pos = __atomic_load_n(&c->head, __ATOMIC_RELAXED); \\\n"
+    "        } \\\n"
+    "    } \\\n"
+    "    *x = c->data[pos & c->mask]; \\\n"
+    "    if (__builtin_expect(c->stats != NULL, 0)) dpp_chan_stats_recv(c->stats, pos & c->mask); \\\n"
+    "    __atomic_store_n(&c->seq[pos & c->mask], pos + c->mask + 1, __ATOMIC_RELEASE); \\\n"
+    "    return 1; \\\n"
+    "} \\\n"
+    "\\\n"
+    "/* Anillo lleno (o vacío): gira un rato y después se marca como esperando, vuelve a \\\n"
+    "   probar y duerme hasta que el otro lado cambie la época. */ \\\n"
+    "__attribute__((noinline)) \\\n"
+    "DPP_RT void dpp_chan_##T##_send_slow(dpp_chan_##T* c, T x) { \\\n"
+    "    for (int spins = 0;; ++spins) { \\\n"
+    "        if (dpp_chan_##T##_try_send(c, x)) break; \\\n"
+    "        if (spins < dpp_chan_spins) { \\\n"
+    "            dpp_cpu_relax(); \\\n"
+    "            continue; \\\n"
+    "        } \\\n"
+    "        int epoch = __atomic_load_n(&c->space_epoch, __ATOMIC_SEQ_CST); \\\n"
+    "        __atomic_store_n(&c->send_waiting, 1, __ATOMIC_SEQ_CST); \\\n"
+    "        __atomic_thread_fence(__ATOMIC_SEQ_CST); \\\n"
+    "        if (dpp_chan_##T##_try_send(c, x)) break; \\\n"
+    "        dpp_chan_sleep(&c->space_epoch, epoch); \\\n"
+    "        spins = 0; \\\n"
+    "    } \\\n"
+    "    dpp_chan_notify(&c->items_epoch, &c->recv_waiting); \\\n"
+    "} \\\n"
+    "\\\n"
+    "__attribute__((noinline)) \\\n"
+    "DPP_RT T dpp_chan_##T##_recv_slow(dpp_chan_##T* c) { \\\n"
+    "    T x; \\\n"
+    "    for (int spins = 0;; ++spins) { \\\n"
+    "        if (dpp_chan_##T##_try_recv(c, &x)) break; \\\n"
+    "        if (spins < dpp_chan_spins) { \\\n"
+    "            dpp_cpu_relax(); \\\n"
+    "            continue; \\\n"
+    "        } \\\n"
+    "        int epoch = __atomic_load_n(&c->items_epoch, __ATOMIC_SEQ_CST); \\\n"
+    "        __atomic_store_n(&c->recv_waiting, 1, __ATOMIC_SEQ_CST); \\\n"
+    "        __atomic_thread_fence(__ATOMIC_SEQ_CST); \\\n"
+    "        if (dpp_chan_##T##_try_recv(c, &x)) break; \\\n"
+    "        dpp_chan_sleep(&c->items_epoch, epoch); \\\n"
+    "        spins = 0; \\\n"
+    "    } \\\n"
+    "    dpp_chan_notify(&c->space_epoch, &c->send_waiting); \\\n"
+    "    return x; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) int dpp_chan_##T##_send(dpp_chan_##T* c, T x) { \\\n"
+    "    if (__builtin_expect(dpp_chan_##T##_try_send(c, x), 1)) \\\n"
+    "        dpp_chan_notify(&c->items_epoch, &c->recv_waiting); \\\n"
+    "    else \\\n"
+    "        dpp_chan_##T##_send_slow(c, x); \\\n"
+    "    return 1; \\\n"
+    "} \\\n"
+    "\\\n"
+    "static inline __attribute__((always_inline, unused)) T dpp_chan_##T##_recv(dpp_chan_##T* c) { \\\n"
+    "    T x; \\\n"
+    "    if (__builtin_expect(dpp_chan_##T##_try_recv(c, &x), 1)) { \\\n"
+    "        dpp_chan_notify(&c->space_epoch, &c->send_waiting); \\\n"
+    "        return x; \\\n"
+    "    } \\\n"
+    "    return dpp_chan_##T##_recv_slow(c); \\\n"
+    "}\n"
+    "\n"
+    "DPP_CHAN_DEFINE(int)\n"
+    "DPP_CHAN_DEFINE(float)\n"
+    "\n"
+    "#define DPP_CHAN_CLEANUP(T) __attribute__((cleanup(dpp_chan_##T##_free)))\n";
+
+static void emit_fragment(FILE* out, const char* text) {
+    fputs(text, out);
+    fputs("\n", out);
+}
+
+void emit_runtime(FILE* out, unsigned features) {
+    emit_fragment(out, runtime_header);
+    if (features & RT_OUTPUT) {
+        emit_fragment(out, runtime_format);
+        emit_fragment(out, runtime_output);
+    }
+    if (features & RT_CHAIN) {
+        emit_fragment(out, runtime_search);
+        emit_fragment(out, runtime_region);
+        emit_fragment(out, runtime_chain);
+    }
+    if (features & RT_ARRAY) emit_fragment(out, runtime_array);
+    if (features & RT_VECTOR) emit_fragment(out, runtime_vector);
+    if (features & RT_MAP) emit_fragment(out, runtime_map);
+    if ((features & RT_MAP) && (features & RT_CHAIN)) emit_fragment(out, runtime_map_chain);
+    if (features & RT_INPUT) emit_fragment(out, runtime_input);
+    if ((features & RT_INPUT) && (features & RT_CHAIN)) emit_fragment(out, runtime_input_chain);
+    if (features & RT_SYNC) emit_fragment(out, runtime_sync);
+    if (features & RT_ASYNC_INPUT) emit_fragment(out, runtime_async_input);
+    if (features & RT_PARALLEL) emit_fragment(out, runtime_parallel);
+    if (features & RT_CHANNEL) emit_fragment(out, runtime_channel);
+}
@@ -0,0 +1,692 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include "ast_c.h"
+
+#define MAX_EVAL_DEPTH 256
+
+int eval_budget = DEFAULT_EVAL_BUDGET;
+
+// Tipo de C que tiene una expresión en el código generado. Los literales floating se emiten
+// con %f y son double, así que una cuenta con uno se hace en double, como en output.c.
+typedef enum { C_INT, C_FLOAT, C_DOUBLE } CType;
+
+typedef struct {
+    CType type;
+    union {
+        int i;
+        float f;
+        double d;
+    };
+} Value;
+
+// Una variable del intérprete: escalar (size 0) o arreglo de integer o floating.
+typedef struct {
+    const char* id;
+    NodeType type;
+    int size;
+    int defined;
+    Value* cells;
+} EvalVar;
+
+typedef struct {
+    EvalVar* vars;
+    int count;
+} EvalEnv;
+
+static long steps_left = 0;
+static int eval_depth = 0;
+static int folded_calls = 0;
+static int folded_loops = 0;
+
+static int step(void) {
+    return --steps_left >= 0;
+}
+
+static EvalVar* find_var(EvalEnv* env, const char* id) {
+    for (int i = env->count - 1; i >= 0; --i)
+        if (strcmp(env->vars[i].id, id) == 0) return &env->vars[i];
+    return NULL;
+}
+
+// Declarar de nuevo (en cada vuelta de un ciclo) deja el escalar sin valor y el arreglo en
+// cero, igual que el código generado.
+static EvalVar* declare_var(EvalEnv* env, const char* id, NodeType type, int size) {
+    // Poner en cero el arreglo también cuesta pasos.
+    if (size > steps_left) return NULL;
+    steps_left -= size;
+    EvalVar* v = find_var(env, id);
+    if (!v) {
+        env->vars = realloc(env->vars, (env->count + 1) * sizeof(EvalVar));
+        v = &env->vars[env->count++];
+        v->id = id;
+        v->cells = NULL;
+    }
+    free(v->cells);
+    v->type = type;
+    v->size = size;
+    v->defined = 0;
+    v->cells = calloc(size ? size : 1, sizeof(Value));
+    for (int i = 0; i < (size ? size : 1); ++i)
+        v->cells[i].type = type == NODE_INT ? C_INT : C_FLOAT;
+    return v;
+}
+
+static void env_free(EvalEnv* env) {
+    for (int i = 0; i < env->count; ++i) free(env->vars[i].cells);
+    free(env->vars);
+}
+
+static double as_double(Value v) {
+    switch (v.type) {
+        case C_INT: return v.i;
+        case C_FLOAT: return v.f;
+        default: return v.d;
+    }
+}
+
+// Conversión implícita de C a una variable, parámetro o resultado integer o floating. Pasar
+// a int un valor fuera de rango es indefinido en C: no se evalúa.
+static int convert(Value v, NodeType type, Value* out) {
+    if (type == NODE_FLOAT) {
+        out->type = C_FLOAT;
+        out->f = v.type == C_INT ? (float)v.i : v.type == C_FLOAT ? v.f : (float)v.d;
+        return 1;
+    }
+    if (type != NODE_INT) return 0;
+    out->type = C_INT;
+    if (v.type == C_INT) {
+        out->i = v.i;
+        return 1;
+    }
+    double d = as_double(v);
+    if (!(d > -2147483649.0 && d < 2147483648.0)) return 0;
+    out->i = (int)d;
+    return 1;
+}
+
+static int truthy(Value v) {
+    return v.type == C_INT ? v.i != 0 : v.type == C_FLOAT ? v.f != 0.0f : v.d != 0.0;
+}
+
+static int compare(const char* op, double a, double b, Value* out) {
+    out->type = C_INT;
+    if (strcmp(op, "<") == 0) out->i = a < b;
+    else if (strcmp(op, ">") == 0) out->i = a > b;
+    else if (strcmp(op, "<=") == 0) out->i = a <= b;
+    else if (strcmp(op, ">=") == 0) out->i = a >= b;
+    else if (strcmp(op, "==") == 0) out->i = a == b;
+    else if (strcmp(op, "!=") == 0) out->i = a != b;
+    else return 0;
+    return 1;
+}
+
+// Operación con las conversiones aritméticas usuales de C. Los enteros dan la vuelta al
+// desbordar (se calculan sin signo); los float se calculan en float y los double en double.
+static int arith(const char* op, Value l, Value r, Value* out) {
+    CType type = l.type > r.type ? l.type : r.type;
+    if (type == C_INT) {
+        unsigned a = (unsigned)l.i, b = (unsigned)r.i;
+        out->type = C_INT;
+        switch (op[0]) {
+            case '+': out->i = (int)(a + b); return 1;
+            case '-': out->i = (int)(a - b); return 1;
+            case '*': out->i = (int)(a * b); return 1;
+            case '/':
+            case '%':
+                if (r.i == 0 || (l.i == INT_MIN && r.i == -1)) return 0;
+                out->i = op[0] == '/' ? l.i / r.i : l.i % r.i;
+                return 1;
+            default:
+                return compare(op, l.i, r.i, out);
+        }
+    }
+    if (type == C_FLOAT) {
+        float a = l.type == C_INT ? (float)l.i : l.f;
+        float b = r.type == C_INT ? (float)r.i : r.f;
+        out->type = C_FLOAT;
+        switch (op[0]) {
+            case '+': out->f = a + b; return 1;
+            case '-': out->f = a - b; return 1;
+            case '*': out->f = a * b; return 1;
+            case '/': out->f = a / b; return 1;
+            case '%': return 0;
+            default: return compare(op, a, b, out);
+        }
+    }
+    double a = as_double(l), b = as_double(r);
+    out->type = C_DOUBLE;
+    switch (op[0]) {
+        case '+': out->d = a + b; return 1;
+        case '-': out->d = a - b; return 1;
+        case '*': out->d = a * b; return 1;
+        case '/': out->d = a / b; return 1;
+        case '%': return 0;
+        default: return compare(op, a, b, out);
+    }
+}
+
+static int eval_expr(ASTNode* node, EvalEnv* env, Value* out);
+static int exec_stmt(ASTNode* node, EvalEnv* env);
+
+static int eval_binop(ASTNode* node, EvalEnv* env, Value* out) {
+    const char* op = node->binop.op;
+    Value l, r;
+    if (node->binop.left->data_type == NODE_STRING || node->binop.right->data_type == NODE_STRING) return 0;
+    if (!eval_expr(node->binop.left, env, &l) || !eval_expr(node->binop.right, env, &r)) return 0;
+    if ((strcmp(op, "/") == 0 || strcmp(op, "%") == 0) && !node->binop.nonzero_divisor) {
+        // El código generado guarda el divisor en un int y termina el programa si es cero:
+        // ese error queda para la ejecución.
+        Value divisor;
+        if (!convert(r, NODE_INT, &divisor) || divisor.i == 0) return 0;
+        r = divisor;
+    }
+    return arith(op, l, r, out);
+}
+
+// Un literal floating del programa se emite con %f: vale lo que C lee de ese texto.
+static void float_literal(ASTNode* node, Value* out) {
+    if (node->folded) {
+        out->type = C_FLOAT;
+        out->f = node->fval;
+        return;
+    }
+    char text[64];
+    snprintf(text, sizeof(text), "%f", node->fval);
+    out->type = C_DOUBLE;
+    out->d = strtod(text, NULL);
+}
+
+// v[i] con i dentro del arreglo; fuera de él el programa termina con un error en la ejecución.
+static int element(ASTNode* node, EvalEnv* env, EvalVar** var, int* index) {
+    EvalVar* v = find_var(env, node->index.id);
+    Value i;
+    if (node->index.field || !v || !v->size) return 0;
+    if (!eval_expr(node->index.index, env, &i) || i.type != C_INT) return 0;
+    if (i.i < 0 || i.i >= v->size) return 0;
+    *var = v;
+    *index = i.i;
+    return 1;
+}
+
+static int eval_call(ASTNode* node, EvalEnv* env, Value* out) {
+    FunctionEntry* f = get_function_entry(node->funccall.id);
+    if (node->funccall.spawn || get_builtin(node->funccall.id)) return 0;
+    if (!f || f->generator || !f->return_expr || f->param_count != node->funccall.arg_count) return 0;
+    if (eval_depth >= MAX_EVAL_DEPTH) return 0;
+
+    EvalEnv callee = { NULL, 0 };
+    int ok = 1;
+    for (int i = 0; ok && i < f->param_count; ++i) {
+        ASTNode* param = f->params[i];
+        Value arg;
+        EvalVar* v = NULL;
+        ok = !param->decl.is_channel && eval_expr(node->funccall.args[i], env, &arg) &&
+             (v = declare_var(&callee, param->decl.id, param->decl.decl_type, 0)) &&
+             convert(arg, param->decl.decl_type, &v->cells[0]);
+        if (ok) v->defined = 1;
+    }
+    eval_depth++;
+    Value result;
+    ok = ok && exec_stmt(f->body, &callee) && eval_expr(f->return_expr->returnstmt.value, &callee, &result) &&
+         convert(result, f->return_expr->data_type, out);
+    eval_depth--;
+    env_free(&callee);
+    return ok;
+}
+
+static int eval_expr(ASTNode* node, EvalEnv* env, Value* out) {
+    if (!node || !step()) return 0;
+    switch (node->type) {
+        case NODE_INT:
+            out->type = C_INT;
+            out->i = node->ival;
+            return 1;
+        case NODE_FLOAT:
+            float_literal(node, out);
+            return 1;
+        case NODE_ID: {
+            EvalVar* v = find_var(env, node->sval);
+            // Leer un escalar sin asignar es indefinido en C.
+            if (!v || v->size || !v->defined) return 0;
+            *out = v->cells[0];
+            return 1;
+        }
+        case NODE_BINOP:
+            return eval_binop(node, env, out);
+        case NODE_INDEX: {
+            EvalVar* v;
+            int i;
+            if (!element(node, env, &v, &i)) return 0;
+            *out = v->cells[i];
+            return 1;
+        }
+        case NODE_FUNCCALL:
+            return eval_call(node, env, out);
+        case NODE_INLINED:
+            return exec_stmt(node->inlined.body, env) && eval_expr(node->inlined.result, env, out);
+        default:
+            return 0;
+    }
+}
+
+// Ejecuta una sentencia; 0 si hace algo que el intérprete no reproduce (E/S, cadenas,
+// contenedores, tareas), si llega a un error de ejecución o si se acaba el presupuesto.
+static int exec_stmt(ASTNode* node, EvalEnv* env) {
+    if (!node) return 1;
+    if (!step()) return 0;
+    switch (node->type) {
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                if (!exec_stmt(node->block.stmts[i], env)) return 0;
+            return 1;
+        case NODE_DECL: {
+            NodeType type = node->decl.decl_type;
+            if (node->decl.is_vector || node->decl.is_map || node->decl.record || node->decl.is_channel) return 0;
+            if (type != NODE_INT && type != NODE_FLOAT) return 0;
+            return declare_var(env, node->decl.id, type, node->decl.array_size) != NULL;
+        }
+        case NODE_ASSIGN: {
+            EvalVar* v = find_var(env, node->assign.id);
+            Value value;
+            if (!v || v->size || !eval_expr(node->assign.value, env, &value)) return 0;
+            if (!convert(value, v->type, &v->cells[0])) return 0;
+            v->defined = 1;
+            return 1;
+        }
+        case NODE_INDEX_ASSIGN: {
+            EvalVar* v;
+            int i;
+            Value value;
+            if (!element(node, env, &v, &i) || !eval_expr(node->index.value, env, &value)) return 0;
+            return convert(value, v->type, &v->cells[i]);
+        }
+        case NODE_IF: {
+            Value cond;
+            if (!eval_expr(node->ifstmt.cond, env, &cond)) return 0;
+            return exec_stmt(truthy(cond) ? node->ifstmt.then_branch : node->ifstmt.else_branch, env);
+        }
+        case NODE_WHILE:
+            for (;;) {
+                Value cond;
+                if (!eval_expr(node->whilestmt.cond, env, &cond)) return 0;
+                if (!truthy(cond)) return 1;
+                if (!exec_stmt(node->whilestmt.body, env)) return 0;
+            }
+        case NODE_FOR:
+            // Un parallel for o una reducción dan lo mismo que el ciclo en orden: cada vuelta
+            // escribe posiciones distintas y las sumas y productos enteros dan la vuelta.
+            if (!exec_stmt(node->forstmt.init, env)) return 0;
+            for (;;) {
+                Value cond;
+                if (!eval_expr(node->forstmt.cond, env, &cond)) return 0;
+                if (!truthy(cond)) return 1;
+                if (!exec_stmt(node->forstmt.body, env) || !exec_stmt(node->forstmt.update, env)) return 0;
+            }
+        case NODE_FUNCCALL: {
+            Value ignored;
+            return eval_expr(node, env, &ignored);
+        }
+        case NODE_INLINED: {
+            Value ignored;
+            if (!exec_stmt(node->inlined.body, env)) return 0;
+            return !node->inlined.result || node->inlined.result->type != NODE_FUNCCALL ||
+                   eval_expr(node->inlined.result, env, &ignored);
+        }
+        default:
+            return 0;
+    }
+}
+
+// Literal que reemplaza un valor en el AST: el int tal cual y el float exacto. INT_MIN se
+// emitiría como -2147483648, que en C es un long, y un float no finito no tiene literal.
+static int make_literal(Value v, NodeType type, ASTNode* node) {
+    if (type == NODE_INT && v.type == C_INT && v.i != INT_MIN) {
+        node->type = NODE_INT;
+        node->ival = v.i;
+    } else if (type == NODE_FLOAT && v.type == C_FLOAT && isfinite(v.f)) {
+        node->type = NODE_FLOAT;
+        node->fval = v.f;
+        node->folded = 1;
+    } else {
+        return 0;
+    }
+    node->data_type = type;
+    return 1;
+}
+
+// Una llamada (o una llamada expandida) a una función pura con argumentos constantes: se
+// evalúa sin variables de afuera y, si termina dentro del presupuesto, queda su resultado.
+static void try_fold(ASTNode* node, const char* owner) {
+    const char* id = node->type == NODE_FUNCCALL ? node->funccall.id : node->inlined.id;
+    FunctionEntry* f = get_function_entry(id);
+    if (!f || f->generator || f->effect != EFFECT_PURE) return;
+    if (node->type == NODE_FUNCCALL && node->funccall.spawn) return;
+
+    EvalEnv env = { NULL, 0 };
+    Value value;
+    ASTNode literal = { 0 };
+    steps_left = eval_budget;
+    eval_depth = 0;
+    int ok = eval_expr(node, &env, &value) && make_literal(value, node->data_type, &literal);
+    env_free(&env);
+    if (!ok) return;
+
+    long steps = eval_budget - steps_left;
+    int line = node->line;
+    node->type = literal.type;
+    node->data_type = literal.data_type;
+    node->folded = literal.folded;
+    if (literal.type == NODE_INT) {
+        node->ival = literal.ival;
+        printf("Evaluación: %s() en %s, línea %d = %d (%ld pasos)\n", id, owner, line, literal.ival, steps);
+    } else {
+        node->fval = literal.fval;
+        printf("Evaluación: %s() en %s, línea %d = %.9g (%ld pasos)\n", id, owner, line, literal.fval, steps);
+    }
+    folded_calls++;
+}
+
+static void fold_stmt(ASTNode* node, const char* owner);
+
+static void fold_expr(ASTNode* node, const char* owner) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                fold_expr(node->funccall.args[i], owner);
+            if (!get_builtin(node->funccall.id)) try_fold(node, owner);
+            break;
+        case NODE_INLINED:
+            fold_stmt(node->inlined.body, owner);
+            fold_expr(node->inlined.result, owner);
+            try_fold(node, owner);
+            break;
+        case NODE_BINOP:
+            fold_expr(node->binop.left, owner);
+            fold_expr(node->binop.right, owner);
+            break;
+        case NODE_INDEX:
+            fold_expr(node->index.index, owner);
+            break;
+        default:
+            break;
+    }
+}
+
+static void fold_stmt(ASTNode* node, const char* owner) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                fold_stmt(node->block.stmts[i], owner);
+            break;
+        case NODE_ASSIGN:
+            fold_expr(node->assign.value, owner);
+            break;
+        case NODE_INDEX_ASSIGN:
+            fold_expr(node->index.index, owner);
+            fold_expr(node->index.value, owner);
+            break;
+        case NODE_PRINT:
+            fold_expr(node->print.value, owner);
+            break;
+        case NODE_IF:
+            fold_expr(node->ifstmt.cond, owner);
+            fold_stmt(node->ifstmt.then_branch, owner);
+            fold_stmt(node->ifstmt.else_branch, owner);
+            break;
+        case NODE_WHILE:
+            fold_expr(node->whilestmt.cond, owner);
+            fold_stmt(node->whilestmt.body, owner);
+            break;
+        case NODE_FOR:
+            fold_stmt(node->forstmt.init, owner);
+            fold_expr(node->forstmt.cond, owner);
+            fold_stmt(node->forstmt.update, owner);
+            fold_stmt(node->forstmt.body, owner);
+            break;
+        case NODE_FOR_IN:
+            if (node->forin.call)
+                for (int i = 0; i < node->forin.call->funccall.arg_count; ++i)
+                    fold_expr(node->forin.call->funccall.args[i], owner);
+            fold_stmt(node->forin.body, owner);
+            break;
+        case NODE_YIELD:
+            fold_expr(node->yieldstmt.value, owner);
+            break;
+        case NODE_RETURN:
+            fold_expr(node->returnstmt.value, owner);
+            break;
+        case NODE_FUNCCALL:
+            // El resultado de una llamada como sentencia se descarta: solo los argumentos.
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                fold_expr(node->funccall.args[i], owner);
+            break;
+        case NODE_INLINED:
+            fold_stmt(node->inlined.body, owner);
+            fold_expr(node->inlined.result, owner);
+            break;
+        default:
+            break;
+    }
+}
+
+// Nombres que usa una sentencia (sin contar las declaraciones).
+typedef struct {
+    const char** ids;
+    int count;
+} NameSet;
+
+static int has_name(NameSet* set, const char* id) {
+    for (int i = 0; i < set->count; ++i)
+        if (strcmp(set->ids[i], id) == 0) return 1;
+    return 0;
+}
+
+static void add_name(NameSet* set, const char* id) {
+    if (!id || has_name(set, id)) return;
+    set->ids = realloc(set->ids, (set->count + 1) * sizeof(const char*));
+    set->ids[set->count++] = id;
+}
+
+static void collect_names(ASTNode* node, NameSet* names, NameSet* written) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_ID:
+            add_name(names, node->sval);
+            break;
+        case NODE_ASSIGN:
+            add_name(names, node->assign.id);
+            collect_names(node->assign.value, names, written);
+            break;
+        case NODE_INDEX_ASSIGN:
+            if (written) add_name(written, node->index.id);
+            // fallthrough
+        case NODE_INDEX:
+            add_name(names, node->index.id);
+            collect_names(node->index.index, names, written);
+            collect_names(node->index.value, names, written);
+            break;
+        case NODE_BINOP:
+            collect_names(node->binop.left, names, written);
+            collect_names(node->binop.right, names, written);
+            break;
+        case NODE_PRINT:
+            collect_names(node->print.value, names, written);
+            break;
+        case NODE_READ:
+            for (int i = 0; i < node->read.id_count; ++i) add_name(names, node->read.ids[i]);
+            break;
+        case NODE_IF:
+            collect_names(node->ifstmt.cond, names, written);
+            collect_names(node->ifstmt.then_branch, names, written);
+            collect_names(node->ifstmt.else_branch, names, written);
+            break;
+        case NODE_WHILE:
+            collect_names(node->whilestmt.cond, names, written);
+            collect_names(node->whilestmt.body, names, written);
+            break;
+        case NODE_FOR:
+            collect_names(node->forstmt.init, names, written);
+            collect_names(node->forstmt.cond, names, written);
+            collect_names(node->forstmt.update, names, written);
+            collect_names(node->forstmt.body, names, written);
+            break;
+        case NODE_FOR_IN:
+            add_name(names, node->forin.key);
+            add_name(names, node->forin.map);
+            collect_names(node->forin.call, names, written);
+            collect_names(node->forin.body, names, written);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                collect_names(node->block.stmts[i], names, written);
+            break;
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                collect_names(node->funccall.args[i], names, written);
+            break;
+        case NODE_INLINED:
+            collect_names(node->inlined.body, names, written);
+            collect_names(node->inlined.result, names, written);
+            break;
+        default:
+            break;
+    }
+}
+
+static ASTNode* find_array_decl(ASTNode* root, int before, const char* id) {
+    for (int i = 0; i < before; ++i) {
+        ASTNode* s = root->block.stmts[i];
+        if (s && s->type == NODE_DECL && strcmp(s->decl.id, id) == 0) return s;
+    }
+    return NULL;
+}
+
+// Una variable que ninguna otra sentencia del nivel superior nombra: si su única declaración
+// está ahí mismo, se puede quitar junto con el ciclo sin que cambie nada.
+static ASTNode* unused_decl(ASTNode* root, int index, const char* id) {
+    NameSet names = { NULL, 0 };
+    for (int i = 0; i < root->block.stmt_count; ++i)
+        if (i != index) collect_names(root->block.stmts[i], &names, NULL);
+    int used = has_name(&names, id);
+    free(names.ids);
+    return used ? NULL : find_array_decl(root, index, id);
+}
+
+static void make_empty(ASTNode* node) {
+    int line = node->line;
+    memset(node, 0, sizeof(ASTNode));
+    node->type = NODE_BLOCK;
+    node->line = line;
+}
+
+// Un for del nivel superior del programa que solo llena arreglos estáticos todavía en cero:
+// se ejecuta en compilación, los arreglos se declaran con esos valores y del ciclo queda la
+// asignación del valor final de su variable. Si nadie más la usa, no queda nada (gcc -Wall
+// avisaría de una variable que solo se asigna).
+static int try_fold_loop(ASTNode* root, int index, NameSet* used) {
+    ASTNode* loop = root->block.stmts[index];
+    ASTNode* init = loop->forstmt.init;
+    if (!init || init->type != NODE_ASSIGN) return 0;
+    const char* var = init->assign.id;
+    Symbol* var_symbol = get_symbol(var);
+    if (!var_symbol || var_symbol->array_size || (var_symbol->type != NODE_INT && var_symbol->type != NODE_FLOAT))
+        return 0;
+
+    NameSet names = { NULL, 0 }, written = { NULL, 0 };
+    collect_names(loop, &names, &written);
+    ASTNode** decls = malloc((written.count + 1) * sizeof(ASTNode*));
+    int ok = written.count > 0;
+    for (int i = 0; ok && i < written.count; ++i) {
+        decls[i] = find_array_decl(root, index, written.ids[i]);
+        ok = decls[i] && decls[i]->decl.array_size && !decls[i]->decl.init && !has_name(used, written.ids[i]) &&
+             !decls[i]->decl.record && (decls[i]->decl.decl_type == NODE_INT || decls[i]->decl.decl_type == NODE_FLOAT);
+    }
+
+    // El ciclo ve solo su variable y los arreglos que llena; cualquier otra variable de afuera
+    // hace que no se evalúe.
+    EvalEnv env = { NULL, 0 };
+    steps_left = eval_budget;
+    eval_depth = 0;
+    for (int i = 0; ok && i < written.count; ++i)
+        ok = declare_var(&env, decls[i]->decl.id, decls[i]->decl.decl_type, decls[i]->decl.array_size) != NULL;
+    ok = ok && declare_var(&env, var, var_symbol->type, 0) && exec_stmt(loop, &env);
+
+    ASTNode final = { 0 };
+    ok = ok && make_literal(find_var(&env, var)->cells[0], var_symbol->type, &final);
+    for (int i = 0; ok && i < written.count; ++i) {
+        EvalVar* v = find_var(&env, decls[i]->decl.id);
+        for (int k = 0; ok && k < v->size; ++k)
+            ok = v->type == NODE_INT || isfinite(v->cells[k].f);
+    }
+
+    if (ok) {
+        long steps = eval_budget - steps_left;
+        for (int i = 0; i < written.count; ++i) {
+            EvalVar* v = find_var(&env, decls[i]->decl.id);
+            int count = 0;
+            for (int k = 0; k < v->size; ++k)
+                if (v->type == NODE_INT ? v->cells[k].i != 0 : (v->cells[k].f != 0.0f || signbit(v->cells[k].f)))
+                    count = k + 1;
+            ASTNode** values = malloc((count + 1) * sizeof(ASTNode*));
+            for (int k = 0; k < count; ++k) {
+                values[k] = calloc(1, sizeof(ASTNode));
+                make_literal(v->cells[k], v->type, values[k]);
+            }
+            decls[i]->decl.init = values;
+            decls[i]->decl.init_count = count;
+            printf("Evaluación: ciclo de la línea %d llena '%s' en compilación (%d valor(es), %ld pasos)\n",
+                   loop->line, v->id, v->size, steps);
+        }
+        for (int i = 0; i < names.count; ++i) add_name(used, names.ids[i]);
+
+        int line = loop->line;
+        ASTNode* var_decl = unused_decl(root, index, var);
+        if (var_decl) {
+            make_empty(var_decl);
+            make_empty(loop);
+        } else {
+            ASTNode* value = malloc(sizeof(ASTNode));
+            *value = final;
+            value->line = line;
+            memset(loop, 0, sizeof(ASTNode));
+            loop->type = NODE_ASSIGN;
+            loop->line = line;
+            loop->assign.id = strdup(var);
+            loop->assign.value = value;
+        }
+        folded_loops++;
+    }
+    env_free(&env);
+    free(decls);
+    free(written.ids);
+    free(names.ids);
+    return ok;
+}
+
+void evaluate_calls(ASTNode* root) {
+    if (eval_budget <= 0) return;
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        fold_stmt(f->body, f->id);
+        fold_stmt(f->return_expr, f->id);
+    }
+    fold_stmt(root, "main");
+
+    if (root && root->type == NODE_BLOCK) {
+        NameSet used = { NULL, 0 };
+        for (int i = 0; i < root->block.stmt_count; ++i) {
+            ASTNode* s = root->block.stmts[i];
+            if (s && s->type == NODE_FOR && try_fold_loop(root, i, &used)) continue;
+            collect_names(s, &used, NULL);
+        }
+        free(used.ids);
+    }
+
+    if (folded_calls > 0 || folded_loops > 0)
+        printf("Evaluación: %d llamada(s) y %d ciclo(s) evaluados en compilación (presupuesto %d pasos)\n",
+               folded_calls, folded_loops, eval_budget);
+}
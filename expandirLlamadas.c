@@ -0,0 +1,548 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ast_c.h"
+
+#define MAX_INLINE_DEPTH 8
+
+int inline_threshold = DEFAULT_INLINE_THRESHOLD;
+
+static int inline_counter = 0;
+static int inlined_sites = 0;
+
+// Pila de funciones en expansión (guarda contra recursión).
+static const char* expanding[MAX_INLINE_DEPTH];
+static int expanding_depth = 0;
+
+typedef struct {
+    const char* from;
+    char* to;
+    ASTNode* value;   // si no es NULL, el parámetro se sustituye por esta expresión
+} Rename;
+
+typedef struct {
+    Rename* items;
+    int count;
+} RenameMap;
+
+static void inline_in(ASTNode* node, const char* owner);
+
+// Costo: número de nodos; los ciclos pesan más porque duplican código caliente.
+static int node_cost(ASTNode* node) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_BINOP:
+            return 1 + node_cost(node->binop.left) + node_cost(node->binop.right);
+        case NODE_ASSIGN:
+            return 1 + node_cost(node->assign.value);
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            return 1 + node_cost(node->index.index) + node_cost(node->index.value);
+        case NODE_PRINT:
+            return 1 + node_cost(node->print.value);
+        case NODE_IF:
+            return 1 + node_cost(node->ifstmt.cond) + node_cost(node->ifstmt.then_branch) +
+                   node_cost(node->ifstmt.else_branch);
+        case NODE_WHILE:
+            return 4 + node_cost(node->whilestmt.cond) + node_cost(node->whilestmt.body);
+        case NODE_FOR:
+            return 4 + node_cost(node->forstmt.init) + node_cost(node->forstmt.cond) +
+                   node_cost(node->forstmt.update) + node_cost(node->forstmt.body);
+        case NODE_FOR_IN:
+            return 4 + node_cost(node->forin.call) + node_cost(node->forin.body);
+        case NODE_BLOCK: {
+            int cost = 0;
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                cost += node_cost(node->block.stmts[i]);
+            return cost;
+        }
+        case NODE_FUNCCALL: {
+            int cost = 1;
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                cost += node_cost(node->funccall.args[i]);
+            return cost;
+        }
+        case NODE_RETURN:
+            return node_cost(node->returnstmt.value);
+        case NODE_INLINED:
+            return node_cost(node->inlined.body) + node_cost(node->inlined.result);
+        default:
+            return 1;
+    }
+}
+
+static int assigns_to(ASTNode* node, const char* id) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_ASSIGN:
+            return strcmp(node->assign.id, id) == 0 || assigns_to(node->assign.value, id);
+        case NODE_INDEX_ASSIGN:
+            return strcmp(node->index.id, id) == 0 || assigns_to(node->index.index, id) ||
+                   assigns_to(node->index.value, id);
+        case NODE_INDEX:
+            return assigns_to(node->index.index, id);
+        case NODE_READ:
+            for (int i = 0; i < node->read.id_count; ++i)
+                if (strcmp(node->read.ids[i], id) == 0) return 1;
+            return 0;
+        case NODE_BINOP:
+            return assigns_to(node->binop.left, id) || assigns_to(node->binop.right, id);
+        case NODE_PRINT:
+            return assigns_to(node->print.value, id);
+        case NODE_IF:
+            return assigns_to(node->ifstmt.cond, id) || assigns_to(node->ifstmt.then_branch, id) ||
+                   assigns_to(node->ifstmt.else_branch, id);
+        case NODE_WHILE:
+            return assigns_to(node->whilestmt.cond, id) || assigns_to(node->whilestmt.body, id);
+        case NODE_FOR:
+            return assigns_to(node->forstmt.init, id) || assigns_to(node->forstmt.cond, id) ||
+                   assigns_to(node->forstmt.update, id) || assigns_to(node->forstmt.body, id);
+        case NODE_FOR_IN:
+            return strcmp(node->forin.key, id) == 0 || assigns_to(node->forin.call, id) ||
+                   assigns_to(node->forin.body, id);
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                if (assigns_to(node->block.stmts[i], id)) return 1;
+            return 0;
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                if (assigns_to(node->funccall.args[i], id)) return 1;
+            return 0;
+        case NODE_RETURN:
+            return assigns_to(node->returnstmt.value, id);
+        case NODE_INLINED:
+            return assigns_to(node->inlined.body, id) || assigns_to(node->inlined.result, id);
+        default:
+            return 0;
+    }
+}
+
+static int calls_function(ASTNode* node, const char* target);
+
+// Funciones ya visitadas durante la búsqueda en el grafo de llamadas.
+static const char* visited[256];
+static int visited_count = 0;
+
+static int reaches(const char* from, const char* target) {
+    for (int i = 0; i < visited_count; ++i)
+        if (strcmp(visited[i], from) == 0) return 0;
+    FunctionEntry* f = get_function_entry(from);
+    if (!f || visited_count >= 256) return 0;
+    visited[visited_count++] = from;
+    return calls_function(f->body, target) || calls_function(f->return_expr, target);
+}
+
+static int calls_function(ASTNode* node, const char* target) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                if (calls_function(node->funccall.args[i], target)) return 1;
+            return strcmp(node->funccall.id, target) == 0 || reaches(node->funccall.id, target);
+        case NODE_ASSIGN:
+            return calls_function(node->assign.value, target);
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            return calls_function(node->index.index, target) ||
+                   calls_function(node->index.value, target);
+        case NODE_BINOP:
+            return calls_function(node->binop.left, target) ||
+                   calls_function(node->binop.right, target);
+        case NODE_PRINT:
+            return calls_function(node->print.value, target);
+        case NODE_IF:
+            return calls_function(node->ifstmt.cond, target) ||
+                   calls_function(node->ifstmt.then_branch, target) ||
+                   calls_function(node->ifstmt.else_branch, target);
+        case NODE_WHILE:
+            return calls_function(node->whilestmt.cond, target) ||
+                   calls_function(node->whilestmt.body, target);
+        case NODE_FOR:
+            return calls_function(node->forstmt.init, target) ||
+                   calls_function(node->forstmt.cond, target) ||
+                   calls_function(node->forstmt.update, target) ||
+                   calls_function(node->forstmt.body, target);
+        case NODE_FOR_IN:
+            return calls_function(node->forin.call, target) || calls_function(node->forin.body, target);
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                if (calls_function(node->block.stmts[i], target)) return 1;
+            return 0;
+        case NODE_RETURN:
+            return calls_function(node->returnstmt.value, target);
+        case NODE_YIELD:
+            return calls_function(node->yieldstmt.value, target);
+        case NODE_INLINED:
+            return calls_function(node->inlined.body, target) ||
+                   calls_function(node->inlined.result, target);
+        default:
+            return 0;
+    }
+}
+
+// spawn y sync pertenecen a la función que los contiene: expandida en otra, su sync
+// esperaría también las tareas de la que llama.
+static int spawns_tasks(ASTNode* node) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_SYNC:
+            return 1;
+        case NODE_FUNCCALL:
+            return node->funccall.spawn;
+        case NODE_ASSIGN:
+            return spawns_tasks(node->assign.value);
+        case NODE_IF:
+            return spawns_tasks(node->ifstmt.then_branch) || spawns_tasks(node->ifstmt.else_branch);
+        case NODE_WHILE:
+            return spawns_tasks(node->whilestmt.body);
+        case NODE_FOR:
+            return spawns_tasks(node->forstmt.body);
+        case NODE_FOR_IN:
+            return spawns_tasks(node->forin.body);
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                if (spawns_tasks(node->block.stmts[i])) return 1;
+            return 0;
+        case NODE_INLINED:
+            return spawns_tasks(node->inlined.body);
+        default:
+            return 0;
+    }
+}
+
+static int is_recursive(FunctionEntry* f) {
+    visited_count = 0;
+    return reaches(f->id, f->id);
+}
+
+static Rename* find_rename(RenameMap* map, const char* id) {
+    for (int i = 0; i < map->count; ++i)
+        if (strcmp(map->items[i].from, id) == 0)
+            return &map->items[i];
+    return NULL;
+}
+
+static const char* renamed(RenameMap* map, const char* id) {
+    Rename* r = find_rename(map, id);
+    return r ? r->to : id;
+}
+
+static void add_rename(RenameMap* map, const char* from, const char* callee, NodeType type, ASTNode* value) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "__inl%d_%s_%s", inline_counter, callee, from);
+    map->items = realloc(map->items, sizeof(Rename) * (map->count + 1));
+    map->items[map->count].from = from;
+    map->items[map->count].to = strdup(buf);
+    map->items[map->count].value = value;
+    map->count++;
+    add_symbol(buf, type);
+}
+
+// Las declaraciones locales se renombran antes de copiar: todas viven en symbol_table.
+static void collect_locals(ASTNode* node, RenameMap* map, const char* callee) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_DECL:
+            if (!find_rename(map, node->decl.id)) {
+                add_rename(map, node->decl.id, callee, node->decl.decl_type, NULL);
+                Symbol* local = get_symbol(map->items[map->count - 1].to);
+                local->array_size = node->decl.is_channel ? 0 : node->decl.array_size;
+                local->is_vector = node->decl.is_vector;
+                local->is_map = node->decl.is_map;
+                local->key_type = node->decl.key_type;
+                local->record = node->decl.record;
+                local->soa = node->decl.soa;
+                local->is_channel = node->decl.is_channel;
+            }
+            break;
+        case NODE_IF:
+            collect_locals(node->ifstmt.then_branch, map, callee);
+            collect_locals(node->ifstmt.else_branch, map, callee);
+            break;
+        case NODE_WHILE:
+            collect_locals(node->whilestmt.body, map, callee);
+            break;
+        case NODE_FOR:
+            collect_locals(node->forstmt.body, map, callee);
+            break;
+        case NODE_FOR_IN:
+            collect_locals(node->forin.body, map, callee);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                collect_locals(node->block.stmts[i], map, callee);
+            break;
+        default:
+            break;
+    }
+}
+
+static ASTNode* clone_node(ASTNode* node, RenameMap* map) {
+    if (!node) return NULL;
+    ASTNode* copy = malloc(sizeof(ASTNode));
+    *copy = *node;
+
+    switch (node->type) {
+        case NODE_STRING:
+            copy->sval = strdup(node->sval);
+            break;
+        case NODE_ID: {
+            Rename* r = find_rename(map, node->sval);
+            if (r && r->value) {
+                // El argumento pertenece al llamador: se copia sin renombrar.
+                RenameMap caller = { NULL, 0 };
+                free(copy);
+                return clone_node(r->value, &caller);
+            }
+            copy->sval = strdup(renamed(map, node->sval));
+            break;
+        }
+        case NODE_READ:
+            copy->read.ids = malloc(sizeof(char*) * node->read.id_count);
+            for (int i = 0; i < node->read.id_count; ++i)
+                copy->read.ids[i] = strdup(renamed(map, node->read.ids[i]));
+            break;
+        case NODE_DECL:
+            copy->decl.id = strdup(renamed(map, node->decl.id));
+            break;
+        case NODE_BINOP:
+            copy->binop.op = strdup(node->binop.op);
+            copy->binop.left = clone_node(node->binop.left, map);
+            copy->binop.right = clone_node(node->binop.right, map);
+            break;
+        case NODE_ASSIGN:
+            copy->assign.id = strdup(renamed(map, node->assign.id));
+            copy->assign.value = clone_node(node->assign.value, map);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            copy->index.id = strdup(renamed(map, node->index.id));
+            copy->index.index = clone_node(node->index.index, map);
+            copy->index.value = clone_node(node->index.value, map);
+            break;
+        case NODE_PRINT:
+            copy->print.value = clone_node(node->print.value, map);
+            break;
+        case NODE_IF:
+            copy->ifstmt.cond = clone_node(node->ifstmt.cond, map);
+            copy->ifstmt.then_branch = clone_node(node->ifstmt.then_branch, map);
+            copy->ifstmt.else_branch = clone_node(node->ifstmt.else_branch, map);
+            break;
+        case NODE_WHILE:
+            copy->whilestmt.cond = clone_node(node->whilestmt.cond, map);
+            copy->whilestmt.body = clone_node(node->whilestmt.body, map);
+            break;
+        case NODE_FOR:
+            copy->forstmt.init = clone_node(node->forstmt.init, map);
+            copy->forstmt.cond = clone_node(node->forstmt.cond, map);
+            copy->forstmt.update = clone_node(node->forstmt.update, map);
+            copy->forstmt.body = clone_node(node->forstmt.body, map);
+            break;
+        case NODE_FOR_IN:
+            copy->forin.key = strdup(renamed(map, node->forin.key));
+            copy->forin.map = node->forin.map ? strdup(renamed(map, node->forin.map)) : NULL;
+            copy->forin.call = clone_node(node->forin.call, map);
+            copy->forin.body = clone_node(node->forin.body, map);
+            break;
+        case NODE_BLOCK:
+            copy->block.stmts = malloc(sizeof(ASTNode*) * (node->block.stmt_count ? node->block.stmt_count : 1));
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                copy->block.stmts[i] = clone_node(node->block.stmts[i], map);
+            break;
+        case NODE_FUNCCALL:
+            copy->funccall.id = strdup(node->funccall.id);
+            copy->funccall.args = malloc(sizeof(ASTNode*) * (node->funccall.arg_count ? node->funccall.arg_count : 1));
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                copy->funccall.args[i] = clone_node(node->funccall.args[i], map);
+            break;
+        case NODE_RETURN:
+            copy->returnstmt.value = clone_node(node->returnstmt.value, map);
+            break;
+        case NODE_INLINED:
+            copy->inlined.body = clone_node(node->inlined.body, map);
+            copy->inlined.result = clone_node(node->inlined.result, map);
+            break;
+        default:
+            break;
+    }
+    return copy;
+}
+
+static int can_substitute(ASTNode* arg) {
+    return arg->type == NODE_INT || arg->type == NODE_FLOAT ||
+           arg->type == NODE_STRING || arg->type == NODE_ID;
+}
+
+static int is_expanding(const char* id) {
+    for (int i = 0; i < expanding_depth; ++i)
+        if (strcmp(expanding[i], id) == 0) return 1;
+    return 0;
+}
+
+// Reemplaza la llamada en el lugar por un NODE_INLINED con parámetros y locales renombrados.
+static void try_inline_call(ASTNode* call, const char* owner, int expr_context) {
+    FunctionEntry* f = get_function_entry(call->funccall.id);
+    if (!f || f->generator || f->param_count != call->funccall.arg_count || call->funccall.spawn) return;
+    if (spawns_tasks(f->body)) return;
+    if (expanding_depth >= MAX_INLINE_DEPTH || is_expanding(f->id) || is_recursive(f)) return;
+
+    int cost = node_cost(f->body) + node_cost(f->return_expr);
+    if (cost > inline_threshold) return;
+
+    NodeType ret = f->return_expr ? f->return_expr->data_type : NODE_INT;
+    if (expr_context && ret == NODE_STRING) return;   // la cadena local se liberaría al cerrar el bloque
+
+    for (int i = 0; i < f->param_count; ++i) {
+        ASTNode* arg = call->funccall.args[i];
+        NodeType param_type = f->params[i]->decl.decl_type;
+        if (f->params[i]->decl.is_channel) return;   // analyze_parallel sigue el channel por llamada
+        if (arg->data_type != param_type) return;   // la conversión implícita de C cambiaría la semántica
+        if (param_type == NODE_STRING && !can_substitute(arg)) return;
+    }
+
+    inline_counter++;
+    RenameMap map = { NULL, 0 };
+
+    int stmt_count = 0;
+    ASTNode** stmts = malloc(sizeof(ASTNode*) * (f->param_count * 2 + 1));
+    for (int i = 0; i < f->param_count; ++i) {
+        ASTNode* param = f->params[i];
+        ASTNode* arg = call->funccall.args[i];
+        if (can_substitute(arg) && !assigns_to(f->body, param->decl.id)) {
+            add_rename(&map, param->decl.id, f->id, param->decl.decl_type, arg);
+            continue;
+        }
+        add_rename(&map, param->decl.id, f->id, param->decl.decl_type, NULL);
+        stmts[stmt_count++] = make_decl_node(map.items[map.count - 1].to, param->decl.decl_type);
+        stmts[stmt_count++] = make_assign_node(map.items[map.count - 1].to, arg);
+    }
+    collect_locals(f->body, &map, f->id);
+
+    ASTNode* body = clone_node(f->body, &map);
+    stmts = realloc(stmts, sizeof(ASTNode*) * (stmt_count + 1));
+    stmts[stmt_count++] = body;
+
+    ASTNode* block = malloc(sizeof(ASTNode));
+    *block = *f->body;
+    block->block.stmts = stmts;
+    block->block.stmt_count = stmt_count;
+
+    int line = call->line;
+    char* callee = strdup(f->id);
+
+    call->type = NODE_INLINED;
+    call->data_type = ret;
+    call->inlined.id = callee;
+    call->inlined.body = block;
+    call->inlined.result = clone_node(f->return_expr ? f->return_expr->returnstmt.value : NULL, &map);
+
+    for (int i = 0; i < map.count; ++i) free(map.items[i].to);
+    free(map.items);
+
+    inlined_sites++;
+    printf("Inline: %s() en %s, línea %d (costo %d)\n", callee, owner, line, cost);
+
+    // Las llamadas dentro del cuerpo copiado también son candidatas.
+    expanding[expanding_depth++] = callee;
+    inline_in(call->inlined.body, owner);
+    inline_in(call->inlined.result, owner);
+    expanding_depth--;
+}
+
+static void inline_expr(ASTNode* node, const char* owner) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                inline_expr(node->funccall.args[i], owner);
+            try_inline_call(node, owner, 1);
+            break;
+        case NODE_BINOP:
+            inline_expr(node->binop.left, owner);
+            inline_expr(node->binop.right, owner);
+            break;
+        case NODE_ASSIGN:
+            inline_expr(node->assign.value, owner);
+            break;
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+            inline_expr(node->index.index, owner);
+            inline_expr(node->index.value, owner);
+            break;
+        default:
+            break;
+    }
+}
+
+static void inline_in(ASTNode* node, const char* owner) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_FUNCCALL:
+            for (int i = 0; i < node->funccall.arg_count; ++i)
+                inline_expr(node->funccall.args[i], owner);
+            try_inline_call(node, owner, 0);
+            break;
+        case NODE_ASSIGN:
+            inline_expr(node->assign.value, owner);
+            break;
+        case NODE_INDEX_ASSIGN:
+            inline_expr(node->index.index, owner);
+            inline_expr(node->index.value, owner);
+            break;
+        case NODE_PRINT:
+            inline_expr(node->print.value, owner);
+            break;
+        case NODE_RETURN:
+            inline_expr(node->returnstmt.value, owner);
+            break;
+        case NODE_IF:
+            inline_expr(node->ifstmt.cond, owner);
+            inline_in(node->ifstmt.then_branch, owner);
+            inline_in(node->ifstmt.else_branch, owner);
+            break;
+        case NODE_WHILE:
+            inline_expr(node->whilestmt.cond, owner);
+            inline_in(node->whilestmt.body, owner);
+            break;
+        case NODE_FOR:
+            inline_in(node->forstmt.init, owner);
+            inline_expr(node->forstmt.cond, owner);
+            inline_in(node->forstmt.update, owner);
+            inline_in(node->forstmt.body, owner);
+            break;
+        case NODE_FOR_IN:
+            if (node->forin.call)
+                for (int i = 0; i < node->forin.call->funccall.arg_count; ++i)
+                    inline_expr(node->forin.call->funccall.args[i], owner);
+            inline_in(node->forin.body, owner);
+            break;
+        case NODE_YIELD:
+            inline_expr(node->yieldstmt.value, owner);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                inline_in(node->block.stmts[i], owner);
+            break;
+        case NODE_INLINED:
+            inline_in(node->inlined.body, owner);
+            inline_expr(node->inlined.result, owner);
+            break;
+        default:
+            break;
+    }
+}
+
+void inline_functions(ASTNode* root) {
+    if (inline_threshold <= 0) return;
+
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        expanding[expanding_depth++] = f->id;
+        inline_in(f->body, f->id);
+        inline_expr(f->return_expr ? f->return_expr->returnstmt.value : NULL, f->id);
+        expanding_depth--;
+    }
+    inline_in(root, "main");
+
+    if (inlined_sites > 0)
+        printf("Inline: %d llamada(s) expandida(s) (umbral %d)\n", inlined_sites, inline_threshold);
+}
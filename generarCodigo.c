@@ -5,23 +5,1096 @@
 
 extern FunctionEntry* function_table;
 
+unsigned runtime_features = 0;
+int async_input = 0;
+
+// Profundidad de ciclos while/for alrededor del código que se está generando.
+static int loop_depth = 0;
+
+// Se emitió algún temporal en la región desde que se abrió el frame actual.
+static int region_used = 0;
+
+// Se está generando el cuerpo de una función o de una llamada expandida en línea.
+static int in_function = 0;
+static int inline_depth = 0;
+
+// Contextos, prototipos y cuerpos de los parallel for: cada cuerpo es una función aparte.
+static FILE* parallel_decls = NULL;
+static FILE* parallel_defs = NULL;
+static int parallel_count = 0;
+static int simd_count = 0;
+
+// Funciones lanzadas con spawn, que ya tienen su frame de tarea, y si la función de C que
+// se está generando lanzó o esperó alguna tarea (entonces declara su grupo __sg).
+static char** spawned = NULL;
+static int spawned_count = 0;
+static int spawn_used = 0;
+
+// Generador cuyo dpp_gen_<id>_next se está generando (NULL fuera de uno) y cuántos yield
+// lleva: cada uno es un estado donde se retoma la siguiente llamada.
+static FunctionEntry* current_generator = NULL;
+static int yield_count = 0;
+
+// Los arreglos locales que ocupan más que esto van al heap en vez de la pila.
+#define STACK_ARRAY_BYTES 16384
+
+static const char* c_type_name(NodeType type) {
+    switch (type) {
+        case NODE_FLOAT: return "float";
+        case NODE_STRING: return "dpp_chain";
+        default: return "int";
+    }
+}
+
+// Emite un nodo en posición de sentencia; las expresiones sueltas necesitan ';'.
+static void generate_stmt(FILE* out, ASTNode* node) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_FUNCCALL:
+            if (node->funccall.spawn) {
+                generate_code(out, node);
+                break;
+            }
+            if (node->data_type == NODE_STRING) {
+                // La cadena devuelta se descarta: hay que liberarla.
+                fprintf(out, "{ dpp_chain __unused DPP_CHAIN_CLEANUP = ");
+                generate_code(out, node);
+                fprintf(out, "; }\n");
+                break;
+            }
+            generate_code(out, node);
+            fprintf(out, ";\n");
+            break;
+
+        case NODE_INLINED:
+            fprintf(out, "{\n");
+            inline_depth++;
+            generate_stmt(out, node->inlined.body);
+            inline_depth--;
+            if (node->inlined.result && node->inlined.result->type == NODE_FUNCCALL)
+                generate_stmt(out, node->inlined.result);
+            fprintf(out, "}\n");
+            break;
+
+        default:
+            generate_code(out, node);
+            break;
+    }
+}
+
+static void copy_file(FILE* from, FILE* to) {
+    char buf[4096];
+    size_t n;
+    rewind(from);
+    while ((n = fread(buf, 1, sizeof(buf), from)) > 0)
+        fwrite(buf, 1, n, to);
+    fclose(from);
+}
+
+// Genera `first` y `second` aparte; si usaron la región, los precede con un frame que
+// se cierra al salir del bloque de C que los contiene (fin de la función o de la vuelta).
+static void generate_framed(FILE* out, ASTNode* first, ASTNode* second) {
+    FILE* code = tmpfile();
+    if (!code) {
+        fprintf(stderr, "Error: no se pudo crear el archivo temporal.\n");
+        exit(1);
+    }
+    int outer = region_used;
+    region_used = 0;
+    generate_stmt(code, first);
+    generate_stmt(code, second);
+    if (region_used) fprintf(out, "dpp_frame __frame DPP_FRAME_CLEANUP = dpp_frame_enter();\n");
+    copy_file(code, out);
+    region_used = outer;
+}
+
+static void generate_signature(FILE* out, FunctionEntry* f) {
+    NodeType ret = f->return_expr ? f->return_expr->data_type : NODE_INT;
+    fprintf(out, "%s %s(", c_type_name(ret), f->id);
+    for (int i = 0; i < f->param_count; ++i) {
+        ASTNode* param = f->params[i];
+        if (i > 0) fprintf(out, ", ");
+        if (param->decl.is_channel)
+            fprintf(out, "dpp_chan_%s* %s", c_type_name(param->decl.decl_type), param->decl.id);
+        else if (param->decl.decl_type == NODE_INT)
+            fprintf(out, "int %s", param->decl.id);
+        else if (param->decl.decl_type == NODE_FLOAT)
+            fprintf(out, "float %s", param->decl.id);
+        else if (param->decl.decl_type == NODE_STRING)
+            fprintf(out, "dpp_chain __arg_%s", param->decl.id);
+    }
+    fprintf(out, ")");
+}
+
+static FILE* open_tmpfile(void);
+
+// Lo que vive en el frame de un generador: sus locales (los parámetros van aparte) y los
+// frames de los generadores que recorre. Los ciclos y llamadas expandidas en línea y los
+// cuerpos de parallel for, que son funciones aparte, tienen sus propias locales de C.
+typedef struct {
+    ASTNode** decls;
+    int decl_count;
+    ASTNode** loops;
+    int loop_count;
+} GeneratorFrame;
+
+static void collect_frame(ASTNode* node, GeneratorFrame* frame) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_DECL:
+            for (int i = 0; i < frame->decl_count; ++i)
+                if (strcmp(frame->decls[i]->decl.id, node->decl.id) == 0) return;
+            frame->decls = realloc(frame->decls, sizeof(ASTNode*) * (frame->decl_count + 1));
+            frame->decls[frame->decl_count++] = node;
+            break;
+        case NODE_IF:
+            collect_frame(node->ifstmt.then_branch, frame);
+            collect_frame(node->ifstmt.else_branch, frame);
+            break;
+        case NODE_WHILE:
+            collect_frame(node->whilestmt.body, frame);
+            break;
+        case NODE_FOR:
+            if (node->forstmt.parallel) break;
+            collect_frame(node->forstmt.init, frame);
+            collect_frame(node->forstmt.body, frame);
+            break;
+        case NODE_FOR_IN:
+            if (node->forin.call) {
+                frame->loops = realloc(frame->loops, sizeof(ASTNode*) * (frame->loop_count + 1));
+                frame->loops[frame->loop_count++] = node;
+            }
+            collect_frame(node->forin.body, frame);
+            break;
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                collect_frame(node->block.stmts[i], frame);
+            break;
+        default:
+            break;
+    }
+}
+
+static int is_frame_scalar(ASTNode* decl) {
+    return decl->decl.array_size == 0;
+}
+
+// Si hay un yield en el cuerpo de un ciclo, el ciclo no abre su propio frame de región:
+// retomar en medio de la vuelta saltaría su inicialización. Los temporales van al frame
+// de dpp_gen_<id>_next, que se cierra en cada yield.
+static int contains_yield(ASTNode* node) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_YIELD:
+            return 1;
+        case NODE_IF:
+            return contains_yield(node->ifstmt.then_branch) || contains_yield(node->ifstmt.else_branch);
+        case NODE_WHILE:
+            return contains_yield(node->whilestmt.body);
+        case NODE_FOR:
+            return contains_yield(node->forstmt.body);
+        case NODE_FOR_IN:
+            return contains_yield(node->forin.body);
+        case NODE_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; ++i)
+                if (contains_yield(node->block.stmts[i])) return 1;
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+// La condición de un ciclo se evalúa fuera del frame de la vuelta: si usa la región, abre
+// su propio frame para que sus temporales no se acumulen mientras el ciclo corre.
+static void generate_loop_cond(FILE* out, ASTNode* cond) {
+    FILE* code = tmpfile();
+    if (!code) {
+        fprintf(stderr, "Error: no se pudo crear el archivo temporal.\n");
+        exit(1);
+    }
+    int outer = region_used;
+    region_used = 0;
+    generate_code(code, cond);
+    if (region_used) fprintf(out, "({ dpp_frame __cf DPP_FRAME_CLEANUP = dpp_frame_enter(); ");
+    copy_file(code, out);
+    if (region_used) fprintf(out, "; })");
+    region_used = outer;
+}
+
+static void generate_loop_body(FILE* out, ASTNode* body, ASTNode* update) {
+    if (current_generator && inline_depth == 0 && contains_yield(body)) {
+        generate_stmt(out, body);
+        generate_stmt(out, update);
+    } else {
+        generate_framed(out, body, update);
+    }
+}
+
+static void generate_generator_prototypes(FILE* out, FunctionEntry* f) {
+    fprintf(out, "typedef struct dpp_gen_%s dpp_gen_%s;\n", f->id, f->id);
+    fprintf(out, "void dpp_gen_%s_start(dpp_gen_%s* __g", f->id, f->id);
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, ", %s %s", c_type_name(f->params[i]->decl.decl_type), f->params[i]->decl.id);
+    fprintf(out, ");\n");
+    fprintf(out, "int dpp_gen_%s_next(dpp_gen_%s* __g);\n", f->id, f->id);
+}
+
+// El frame de un generador contiene los de los generadores que recorre, que se declaran
+// antes que él (make_for_generator_node lo exige): en orden de declaración cada frame
+// encuentra definidos los que contiene.
+static void generate_generator_frame(FILE* out, FunctionEntry* f) {
+    GeneratorFrame frame = { NULL, 0, NULL, 0 };
+    collect_frame(f->body, &frame);
+    fprintf(out, "struct dpp_gen_%s {\n", f->id);
+    fprintf(out, "int __state;\n");
+    fprintf(out, "%s __value;\n", c_type_name(f->yield_type));
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, "%s %s;\n", c_type_name(f->params[i]->decl.decl_type), f->params[i]->decl.id);
+    for (int i = 0; i < frame.decl_count; ++i) {
+        ASTNode* decl = frame.decls[i];
+        const char* type = c_type_name(decl->decl.decl_type);
+        if (is_frame_scalar(decl)) {
+            fprintf(out, "%s %s;\n", type, decl->decl.id);
+        } else {
+            runtime_features |= RT_ARRAY;
+            fprintf(out, "%s %s[%d] __attribute__((aligned(DPP_ARRAY_ALIGN)));\n", type, decl->decl.id,
+                    decl->decl.array_size);
+        }
+    }
+    for (int i = 0; i < frame.loop_count; ++i)
+        fprintf(out, "dpp_gen_%s %s[1];\n", frame.loops[i]->forin.call->funccall.id, frame.loops[i]->forin.iter);
+    fprintf(out, "};\n\n");
+    free(frame.decls);
+    free(frame.loops);
+}
+
+static void generate_generator_frames(FILE* out, FunctionEntry* f) {
+    if (!f) return;
+    generate_generator_frames(out, f->next);
+    if (f->generator) generate_generator_frame(out, f);
+}
+
+// Guarda en el frame los escalares que dpp_gen_<id>_next trabaja como locales de C.
+static void generate_frame_store(FILE* out, FunctionEntry* f) {
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, "__g->%s = %s;\n", f->params[i]->decl.id, f->params[i]->decl.id);
+    GeneratorFrame frame = { NULL, 0, NULL, 0 };
+    collect_frame(f->body, &frame);
+    for (int i = 0; i < frame.decl_count; ++i)
+        if (is_frame_scalar(frame.decls[i]))
+            fprintf(out, "__g->%s = %s;\n", frame.decls[i]->decl.id, frame.decls[i]->decl.id);
+    free(frame.decls);
+    free(frame.loops);
+}
+
+// Un generador es una máquina de estados sin cambio de pila: _start copia los argumentos
+// al frame y cada _next retoma en el estado guardado (un case del switch) hasta el
+// siguiente yield, que deja el valor en __value y devuelve 1; al terminar el cuerpo
+// devuelve 0. Durante la llamada los escalares son locales de C, que gcc puede tener en
+// registros; se cargan del frame al entrar y se guardan en cada yield. Los arreglos y los
+// frames anidados se usan directamente en el frame.
+static void generate_generator(FILE* out, FunctionEntry* f) {
+    fprintf(out, "void dpp_gen_%s_start(dpp_gen_%s* __g", f->id, f->id);
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, ", %s %s", c_type_name(f->params[i]->decl.decl_type), f->params[i]->decl.id);
+    fprintf(out, ") {\n");
+    fprintf(out, "memset(__g, 0, sizeof(*__g));\n");
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, "__g->%s = %s;\n", f->params[i]->decl.id, f->params[i]->decl.id);
+    fprintf(out, "}\n\n");
+
+    fprintf(out, "int dpp_gen_%s_next(dpp_gen_%s* __g) {\n", f->id, f->id);
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(out, "%s %s = __g->%s;\n", c_type_name(f->params[i]->decl.decl_type),
+                f->params[i]->decl.id, f->params[i]->decl.id);
+    GeneratorFrame frame = { NULL, 0, NULL, 0 };
+    collect_frame(f->body, &frame);
+    for (int i = 0; i < frame.decl_count; ++i) {
+        ASTNode* decl = frame.decls[i];
+        const char* type = c_type_name(decl->decl.decl_type);
+        if (is_frame_scalar(decl))
+            fprintf(out, "%s %s = __g->%s;\n", type, decl->decl.id, decl->decl.id);
+        else
+            fprintf(out, "%s* const %s = __g->%s;\n", type, decl->decl.id, decl->decl.id);
+    }
+    for (int i = 0; i < frame.loop_count; ++i) {
+        const char* id = frame.loops[i]->forin.call->funccall.id;
+        fprintf(out, "dpp_gen_%s* const %s = __g->%s;\n", id, frame.loops[i]->forin.iter,
+                frame.loops[i]->forin.iter);
+    }
+    free(frame.decls);
+    free(frame.loops);
+
+    FILE* code = open_tmpfile();
+    int outer = region_used;
+    region_used = 0;
+    current_generator = f;
+    yield_count = 0;
+    fprintf(code, "switch (__g->__state) {\n");
+    fprintf(code, "case 0:;\n");
+    generate_stmt(code, f->body);
+    // El valor del return no se entrega: solo se evalúa.
+    fprintf(code, "(void)(");
+    generate_code(code, f->return_expr->returnstmt.value);
+    fprintf(code, ");\n");
+    fprintf(code, "}\n");
+    fprintf(code, "__g->__state = -1;\n");
+    fprintf(code, "return 0;\n");
+    current_generator = NULL;
+    if (region_used) fprintf(out, "dpp_frame __frame DPP_FRAME_CLEANUP = dpp_frame_enter();\n");
+    region_used = outer;
+    copy_file(code, out);
+    fprintf(out, "}\n\n");
+}
+
 void generate_all_functions(FILE* out) {
+    // Prototipos primero: la tabla de funciones está en orden inverso.
+    for (FunctionEntry* f = function_table; f; f = f->next) {
+        if (f->generator) {
+            generate_generator_prototypes(out, f);
+            continue;
+        }
+        // El atributo deja que gcc junte o saque de los ciclos las llamadas repetidas.
+        const char* attribute = effect_attribute(f);
+        if (attribute) fprintf(out, "__attribute__((%s)) ", attribute);
+        generate_signature(out, f);
+        fprintf(out, ";\n");
+    }
+    generate_generator_frames(out, function_table);
+    in_function = 1;
     for (FunctionEntry* f = function_table; f; f = f->next) {
-        fprintf(out, "int %s(", f->id);
+        if (f->generator) {
+            generate_generator(out, f);
+            continue;
+        }
+        generate_signature(out, f);
+        fprintf(out, " {\n");
+        // La función recibe sus cadenas en propiedad y las libera al salir.
         for (int i = 0; i < f->param_count; ++i) {
-            ASTNode* param = f->params[i];
-            if (i > 0) fprintf(out, ", ");
-            if (param->decl.decl_type == NODE_INT)
-                fprintf(out, "int %s", param->decl.id);
-            else if (param->decl.decl_type == NODE_FLOAT)
-                fprintf(out, "float %s", param->decl.id);
-            else if (param->decl.decl_type == NODE_STRING)
-                fprintf(out, "char* %s", param->decl.id);
+            const char* id = f->params[i]->decl.id;
+            if (f->params[i]->decl.is_channel)
+                runtime_features |= RT_CHANNEL | RT_PARALLEL | RT_SYNC;
+            else if (f->params[i]->decl.decl_type == NODE_STRING)
+                fprintf(out, "dpp_chain %s DPP_CHAIN_CLEANUP = __arg_%s;\n", id, id);
         }
-        fprintf(out, ") {\n");
-        generate_code(out, f->body);
+        FILE* code = open_tmpfile();
+        spawn_used = 0;
+        generate_framed(code, f->body, f->return_expr);
+        if (spawn_used) fprintf(out, "dpp_spawn_group __sg = { 0 };\n");
+        copy_file(code, out);
         fprintf(out, "}\n\n");
     }
+    in_function = 0;
+}
+
+// Los arreglos del nivel superior de main son estáticos; el resto son locales de cada
+// llamada o vuelta. En ambos casos quedan contiguos, en cero y alineados a 64 bytes
+// para que gcc pueda vectorizar los ciclos que los recorren. attrs se agrega en los dos
+// primeros casos (la columna soa de un campo que nadie usa es unused).
+static void generate_array_decl(FILE* out, const char* type, const char* id, int size, int elem_bytes,
+                                const char* attrs) {
+    runtime_features |= RT_ARRAY;
+    if (!in_function && inline_depth == 0 && loop_depth == 0) {
+        fprintf(out, "static %s %s[%d] __attribute__((aligned(DPP_ARRAY_ALIGN)%s));\n", type, id, size, attrs);
+    } else if ((long long)size * elem_bytes <= STACK_ARRAY_BYTES) {
+        fprintf(out, "%s %s[%d] __attribute__((aligned(DPP_ARRAY_ALIGN)%s)) = {0};\n", type, id, size, attrs);
+    } else {
+        fprintf(out, "%s* const %s DPP_ARRAY_CLEANUP = __builtin_assume_aligned("
+                     "dpp_array_new(%d, sizeof(%s)), DPP_ARRAY_ALIGN);\n", type, id, size, type);
+    }
+}
+
+// Un arreglo del nivel superior llenado en compilación: static, con sus valores.
+static void generate_table_decl(FILE* out, ASTNode* node) {
+    runtime_features |= RT_ARRAY;
+    fprintf(out, "static %s %s[%d] __attribute__((aligned(DPP_ARRAY_ALIGN))) = {",
+            c_type_name(node->decl.decl_type), node->decl.id, node->decl.array_size);
+    for (int i = 0; i < node->decl.init_count; ++i) {
+        fprintf(out, i == 0 ? "\n" : i % 16 ? ", " : ",\n");
+        generate_code(out, node->decl.init[i]);
+    }
+    fprintf(out, " };\n");
+}
+
+// Una variable capturada por un parallel for, como miembro del contexto (part 0), como
+// local del cuerpo (part 1) o en el inicializador del contexto (part 2). Los arreglos y las
+// columnas soa viajan como puntero a sus datos, que comparten todos los hilos; lo demás
+// por valor, porque el cuerpo solo lo lee.
+static void generate_capture_part(FILE* out, int part, const char* type, int pointer, const char* id,
+                                  const char* attrs) {
+    if (part == 0) fprintf(out, "%s%s %s;\n", type, pointer ? "*" : "", id);
+    else if (part == 1) fprintf(out, "%s%s %s%s = __c->%s;\n", type, pointer ? "* const" : "", id, attrs, id);
+    else fprintf(out, ".%s = %s, ", id, id);
+}
+
+static void generate_capture(FILE* out, Symbol* s, int part) {
+    char type[256];
+    if (s->record && s->array_size && s->soa) {
+        for (int i = 0; i < s->record->field_count; ++i) {
+            ASTNode* field = s->record->fields[i];
+            char column[512];
+            snprintf(column, sizeof(column), "%s__%s", s->id, field->decl.id);
+            generate_capture_part(out, part, c_type_name(field->decl.decl_type), 1, column,
+                                  " __attribute__((unused))");
+        }
+        return;
+    }
+    if (s->record) snprintf(type, sizeof(type), "dpp_rec_%s", s->record->id);
+    else if (s->is_vector) snprintf(type, sizeof(type), "dpp_vec_%s", c_type_name(s->type));
+    else if (s->is_map) snprintf(type, sizeof(type), "dpp_map_%s", s->key_type == NODE_STRING ? "chain" : "int");
+    else snprintf(type, sizeof(type), "%s", c_type_name(s->type));
+    generate_capture_part(out, part, type, s->array_size != 0, s->id, "");
+}
+
+static FILE* open_tmpfile(void) {
+    FILE* f = tmpfile();
+    if (!f) {
+        fprintf(stderr, "Error: no se pudo crear el archivo temporal.\n");
+        exit(1);
+    }
+    return f;
+}
+
+static void open_parallel_files(void) {
+    if (!parallel_decls) {
+        parallel_decls = open_tmpfile();
+        parallel_defs = open_tmpfile();
+    }
+}
+
+// El frame de tarea de una función lanzada con spawn: los argumentos de la llamada y
+// dónde guardar el resultado (NULL si se descarta), más la función que hace la llamada.
+static void generate_spawn_frame(FunctionEntry* f) {
+    for (int i = 0; i < spawned_count; ++i)
+        if (strcmp(spawned[i], f->id) == 0) return;
+    spawned = realloc(spawned, sizeof(char*) * (spawned_count + 1));
+    spawned[spawned_count++] = f->id;
+    open_parallel_files();
+
+    const char* ret = c_type_name(f->return_expr ? f->return_expr->data_type : NODE_INT);
+    fprintf(parallel_decls, "struct dpp_spawn_%s {\n", f->id);
+    fprintf(parallel_decls, "dpp_task_frame hdr;\n");
+    fprintf(parallel_decls, "%s* result;\n", ret);
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(parallel_decls, f->params[i]->decl.is_channel ? "dpp_chan_%s* a%d;\n" : "%s a%d;\n",
+                c_type_name(f->params[i]->decl.decl_type), i);
+    fprintf(parallel_decls, "};\n");
+    fprintf(parallel_decls, "static void dpp_spawn_run_%s(dpp_task_frame* __f);\n", f->id);
+
+    fprintf(parallel_defs, "static void dpp_spawn_run_%s(dpp_task_frame* __f) {\n", f->id);
+    fprintf(parallel_defs, "struct dpp_spawn_%s* __t = (struct dpp_spawn_%s*)__f;\n", f->id, f->id);
+    fprintf(parallel_defs, "%s __r = %s(", ret, f->id);
+    for (int i = 0; i < f->param_count; ++i)
+        fprintf(parallel_defs, "%s__t->a%d", i > 0 ? ", " : "", i);
+    fprintf(parallel_defs, ");\n");
+    fprintf(parallel_defs, "if (__t->result) *__t->result = __r;\n");
+    fprintf(parallel_defs, "}\n\n");
+}
+
+// spawn f(...); o result = spawn f(...);: los argumentos se evalúan acá y la llamada queda
+// en la cola del hilo hasta que otro la robe o llegue el sync.
+static void generate_spawn(FILE* out, ASTNode* call, const char* result) {
+    FunctionEntry* f = get_function_entry(call->funccall.id);
+    runtime_features |= RT_PARALLEL | RT_SYNC;
+    spawn_used = 1;
+    generate_spawn_frame(f);
+    fprintf(out, "{\n");
+    fprintf(out, "struct dpp_spawn_%s* __t = (struct dpp_spawn_%s*)dpp_spawn_alloc(sizeof(struct dpp_spawn_%s));\n",
+            f->id, f->id, f->id);
+    fprintf(out, "__t->hdr.run = dpp_spawn_run_%s;\n", f->id);
+    if (result) fprintf(out, "__t->result = &%s;\n", result);
+    else fprintf(out, "__t->result = NULL;\n");
+    for (int i = 0; i < call->funccall.arg_count; ++i) {
+        fprintf(out, "__t->a%d = ", i);
+        generate_code(out, call->funccall.args[i]);
+        fprintf(out, ";\n");
+    }
+    fprintf(out, "dpp_spawn(&__sg, &__t->hdr);\n");
+    fprintf(out, "}\n");
+}
+
+// Valor inicial del acumulador de una reducción: el neutro de su operación.
+static const char* reduction_identity(char op) {
+    switch (op) {
+        case '+': return "0";
+        case '*': return "1";
+        case '<': return "2147483647";
+        default: return "(-2147483647 - 1)";
+    }
+}
+
+static const char* reduction_combine(char op) {
+    switch (op) {
+        case '+': return "add";
+        case '*': return "mul";
+        case '<': return "min";
+        default: return "max";
+    }
+}
+
+// parallel for (i = a; i < b; i = i + 1) cuerpo: el cuerpo va a una función
+// dpp_pfor_N(ctx, lo, hi) que recorre [lo, hi) y el runtime reparte [a, b) entre los hilos.
+// Los límites se evalúan una sola vez; al terminar, i queda como en el for secuencial.
+// Cada tramo acumula las reducciones en una local propia y al final la combina con la
+// variable del programa, que el contexto lleva por puntero.
+static void generate_parallel_for(FILE* out, ASTNode* node) {
+    int n = parallel_count++;
+    const char* var = node->forstmt.init->assign.id;
+    int inclusive = strcmp(node->forstmt.cond->binop.op, "<=") == 0;
+    int has_ctx = node->forstmt.capture_count > 0 || node->forstmt.reduction_count > 0;
+    Reduction* reductions = node->forstmt.reductions;
+    runtime_features |= RT_PARALLEL | RT_SYNC;
+    open_parallel_files();
+
+    if (has_ctx) {
+        fprintf(parallel_decls, "struct dpp_pfor_ctx_%d {\n", n);
+        for (int i = 0; i < node->forstmt.capture_count; ++i)
+            generate_capture(parallel_decls, node->forstmt.captures[i], 0);
+        for (int i = 0; i < node->forstmt.reduction_count; ++i)
+            fprintf(parallel_decls, "int* %s;\n", reductions[i].acc);
+        fprintf(parallel_decls, "};\n");
+    }
+    fprintf(parallel_decls, "static void dpp_pfor_%d(void* __arg, int __lo, int __hi);\n", n);
+
+    // El cuerpo se genera aparte: puede contener otros parallel for.
+    FILE* def = open_tmpfile();
+    fprintf(def, "static void dpp_pfor_%d(void* __arg, int __lo, int __hi) {\n", n);
+    if (has_ctx) fprintf(def, "struct dpp_pfor_ctx_%d* __c = __arg;\n", n);
+    else fprintf(def, "(void)__arg;\n");
+    for (int i = 0; i < node->forstmt.capture_count; ++i)
+        generate_capture(def, node->forstmt.captures[i], 1);
+    for (int i = 0; i < node->forstmt.reduction_count; ++i)
+        fprintf(def, "int %s = %s;\n", reductions[i].acc, reduction_identity(reductions[i].op));
+    fprintf(def, "int %s;\n", var);
+    fprintf(def, "for (%s = __lo; %s < __hi; %s++) {\n", var, var, var);
+    int outer_function = in_function, outer_inline = inline_depth, outer_loop = loop_depth;
+    FunctionEntry* outer_generator = current_generator;
+    in_function = 1;
+    inline_depth = 0;
+    loop_depth = 1;
+    current_generator = NULL;
+    generate_framed(def, node->forstmt.body, NULL);
+    in_function = outer_function;
+    inline_depth = outer_inline;
+    loop_depth = outer_loop;
+    current_generator = outer_generator;
+    fprintf(def, "}\n");
+    for (int i = 0; i < node->forstmt.reduction_count; ++i)
+        fprintf(def, "dpp_reduce_%s(__c->%s, %s);\n", reduction_combine(reductions[i].op),
+                reductions[i].acc, reductions[i].acc);
+    fprintf(def, "}\n\n");
+    copy_file(def, parallel_defs);
+
+    fprintf(out, "{\n");
+    fprintf(out, "int __lo%d = ", n);
+    generate_code(out, node->forstmt.init->assign.value);
+    fprintf(out, ";\nint __hi%d = ", n);
+    generate_code(out, node->forstmt.cond->binop.right);
+    fprintf(out, inclusive ? " + 1;\n" : ";\n");
+    if (has_ctx) {
+        fprintf(out, "struct dpp_pfor_ctx_%d __ctx%d = { ", n, n);
+        for (int i = 0; i < node->forstmt.capture_count; ++i)
+            generate_capture(out, node->forstmt.captures[i], 2);
+        for (int i = 0; i < node->forstmt.reduction_count; ++i)
+            fprintf(out, ".%s = &%s, ", reductions[i].acc, reductions[i].acc);
+        fprintf(out, "};\n");
+        fprintf(out, "dpp_parallel_for(dpp_pfor_%d, &__ctx%d, __lo%d, __hi%d);\n", n, n, n, n);
+    } else {
+        fprintf(out, "dpp_parallel_for(dpp_pfor_%d, NULL, __lo%d, __hi%d);\n", n, n, n);
+    }
+    fprintf(out, "%s = __hi%d > __lo%d ? __hi%d : __lo%d;\n", var, n, n, n, n);
+    fprintf(out, "(void)%s;\n", var);
+    fprintf(out, "}\n");
+}
+
+// Una expresión de simd_expr evaluada para las iteraciones __kN .. __kN + 3, como vector
+// sin signo: así el desborde da la vuelta en vez de ser indefinido. acc es el acumulador
+// de la reducción, que se reemplaza por su vector parcial.
+static void generate_simd_expr(FILE* out, ASTNode* node, const char* var, const char* acc, int n, int j) {
+    switch (node->type) {
+        case NODE_BINOP:
+            fprintf(out, "(");
+            generate_simd_expr(out, node->binop.left, var, acc, n, j);
+            fprintf(out, " %s ", node->binop.op);
+            generate_simd_expr(out, node->binop.right, var, acc, n, j);
+            fprintf(out, ")");
+            return;
+        case NODE_ID:
+            if (strcmp(node->sval, acc) == 0) {
+                fprintf(out, "__r%d_%d", n, j);
+                return;
+            }
+            if (strcmp(node->sval, var) == 0) {
+                fprintf(out, "((dpp_v4u){ __k%d, __k%d + 1u, __k%d + 2u, __k%d + 3u })", n, n, n, n);
+                return;
+            }
+            break;
+        case NODE_INDEX:
+            if (node->index.index) {
+                if (node->index.soa) fprintf(out, "(dpp_v4u)dpp_loadu4i(&%s__%s[__k%d])", node->index.id, node->index.field, n);
+                else fprintf(out, "(dpp_v4u)dpp_loadu4i(&%s[__k%d])", node->index.id, n);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    // Constante o escalar que el ciclo no modifica: el mismo valor en los 4 carriles.
+    fprintf(out, "((dpp_v4u){ ");
+    for (int lane = 0; lane < 4; ++lane) {
+        fprintf(out, lane ? ", (unsigned)" : "(unsigned)");
+        generate_code(out, node);
+    }
+    fprintf(out, " })");
+}
+
+// El menor tamaño de los arreglos que la expresión lee sin que el análisis de rangos haya
+// probado el índice; 0 si no hay ninguno.
+static int simd_unchecked_size(ASTNode* node) {
+    if (node->type == NODE_BINOP) {
+        int a = simd_unchecked_size(node->binop.left), b = simd_unchecked_size(node->binop.right);
+        return !a ? b : !b ? a : a < b ? a : b;
+    }
+    if (node->type == NODE_INDEX && node->index.index && !node->index.in_bounds) return node->index.size;
+    return 0;
+}
+
+// Un ciclo contado cuyo cuerpo son solo reducciones enteras (ver analyze_parallel): cada
+// acumulador tiene un vector de 4 parciales y el ciclo avanza de a 4 iteraciones; al final
+// los parciales se combinan en el acumulador y las iteraciones que sobran corren como en el
+// ciclo original. Si hay índices sin probar y el tramo se sale de algún arreglo, se ejecuta
+// el ciclo original, que reporta el error en la iteración que corresponde.
+static void generate_simd_reduction(FILE* out, ASTNode* node) {
+    int n = simd_count++;
+    const char* var = node->forstmt.init->assign.id;
+    int inclusive = strcmp(node->forstmt.cond->binop.op, "<=") == 0;
+    Reduction* reductions = node->forstmt.reductions;
+    int count = node->forstmt.reduction_count;
+    runtime_features |= RT_VECTOR | RT_ARRAY;
+
+    int size = 0;
+    for (int j = 0; j < count; ++j) {
+        int s = simd_unchecked_size(reductions[j].expr);
+        if (s && (!size || s < size)) size = s;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "int __lo%d = ", n);
+    generate_code(out, node->forstmt.init->assign.value);
+    fprintf(out, ";\nint __hi%d = ", n);
+    generate_code(out, node->forstmt.cond->binop.right);
+    fprintf(out, inclusive ? " + 1;\n" : ";\n");
+    if (size) fprintf(out, "if (__lo%d >= __hi%d || (__lo%d >= 0 && __hi%d <= %d)) {\n", n, n, n, n, size);
+    for (int j = 0; j < count; ++j) {
+        const char* id = reduction_identity(reductions[j].op);
+        fprintf(out, "dpp_v4u __r%d_%d = { (unsigned)%s, (unsigned)%s, (unsigned)%s, (unsigned)%s };\n",
+                n, j, id, id, id, id);
+    }
+    fprintf(out, "int __k%d = __lo%d;\n", n, n);
+    fprintf(out, "for (; (long long)__k%d + 4 <= __hi%d; __k%d += 4) {\n", n, n, n);
+    for (int j = 0; j < count; ++j) {
+        Reduction* r = &reductions[j];
+        if (r->op == '+' || r->op == '*') {
+            fprintf(out, "__r%d_%d = ", n, j);
+            generate_simd_expr(out, r->expr, var, r->acc, n, j);
+            fprintf(out, ";\n");
+        } else {
+            fprintf(out, "{ dpp_v4i __t = (dpp_v4i)");
+            generate_simd_expr(out, r->expr, var, r->acc, n, j);
+            fprintf(out, "; __r%d_%d = (dpp_v4u)DPP_VSEL(dpp_v4i, __t %c (dpp_v4i)__r%d_%d, __t, __r%d_%d); }\n",
+                    n, j, r->op, n, j, n, j);
+        }
+    }
+    fprintf(out, "}\n");
+    for (int j = 0; j < count; ++j) {
+        Reduction* r = &reductions[j];
+        if (r->op == '+' || r->op == '*')
+            fprintf(out, "%s = (int)((unsigned)%s %c __r%d_%d[0] %c __r%d_%d[1] %c __r%d_%d[2] %c __r%d_%d[3]);\n",
+                    r->acc, r->acc, r->op, n, j, r->op, n, j, r->op, n, j, r->op, n, j);
+        else
+            fprintf(out, "for (int __j = 0; __j < 4; ++__j) if ((int)__r%d_%d[__j] %c %s) %s = (int)__r%d_%d[__j];\n",
+                    n, j, r->op, r->acc, r->acc, n, j);
+    }
+    fprintf(out, "%s = __k%d;\n", var, n);
+    fprintf(out, "while (%s < __hi%d) {\n", var, n);
+    loop_depth++;
+    generate_framed(out, node->forstmt.body, node->forstmt.update);
+    loop_depth--;
+    fprintf(out, "}\n");
+    if (size) {
+        fprintf(out, "} else {\n");
+        node->forstmt.simd = 0;
+        generate_code(out, node);
+        node->forstmt.simd = 1;
+        fprintf(out, "}\n");
+    }
+    fprintf(out, "}\n");
+}
+
+// Un record es un struct de C. Un arreglo de records con layout aos es un arreglo de ese
+// struct; con soa cada campo es un arreglo propio (v__campo), así un ciclo que lee pocos
+// campos solo trae esas columnas a la caché y gcc las vectoriza como arreglos simples.
+static void generate_record_decl(FILE* out, ASTNode* node) {
+    RecordType* rec = node->decl.record;
+    const char* id = node->decl.id;
+    char name[256];
+    if (!node->decl.array_size) {
+        fprintf(out, "dpp_rec_%s %s = {0};\n", rec->id, id);
+    } else if (!node->decl.soa) {
+        snprintf(name, sizeof(name), "dpp_rec_%s", rec->id);
+        generate_array_decl(out, name, id, node->decl.array_size, 4 * rec->field_count, "");
+    } else {
+        for (int i = 0; i < rec->field_count; ++i) {
+            snprintf(name, sizeof(name), "%s__%s", id, rec->fields[i]->decl.id);
+            generate_array_decl(out, c_type_name(rec->fields[i]->decl.decl_type), name,
+                                node->decl.array_size, 4, ", unused");
+        }
+    }
+}
+
+static void generate_record_types(FILE* out) {
+    for (RecordType* rec = record_table; rec; rec = rec->next) {
+        fprintf(out, "typedef struct {");
+        for (int i = 0; i < rec->field_count; ++i)
+            fprintf(out, " %s %s;", c_type_name(rec->fields[i]->decl.decl_type), rec->fields[i]->decl.id);
+        fprintf(out, " } dpp_rec_%s;\n", rec->id);
+    }
+}
+
+// En un vector el límite es su largo actual.
+static void generate_index(FILE* out, ASTNode* node) {
+    int is_vector = node->index.size == 0;
+    if (node->index.field && !node->index.index) {
+        fprintf(out, "%s.%s", node->index.id, node->index.field);
+        return;
+    }
+    if (node->index.soa)
+        fprintf(out, "%s__%s[", node->index.id, node->index.field);
+    else
+        fprintf(out, is_vector ? "%s.data[" : "%s[", node->index.id);
+    if (node->index.in_bounds) {
+        generate_code(out, node->index.index);
+    } else {
+        fprintf(out, "dpp_index(");
+        generate_code(out, node->index.index);
+        if (is_vector) fprintf(out, ", %s.len, %d)", node->index.id, node->line);
+        else fprintf(out, ", %d, %d)", node->index.size, node->line);
+    }
+    fprintf(out, "]");
+    if (node->index.field && !node->index.soa) fprintf(out, ".%s", node->index.field);
+}
+
+static void generate_chain_owned(FILE* out, ASTNode* node);
+static void generate_chain_temp(FILE* out, ASTNode* node);
+
+static int is_simple_chain(ASTNode* node) {
+    return node->type == NODE_ID || node->type == NODE_STRING;
+}
+
+// Literales de cadena del programa, sin repetir: cada uno se emite una sola vez como
+// dpp_lit_N, de modo que dos literales iguales comparten puntero.
+static char** literals = NULL;
+static int literal_count = 0;
+
+static int literal_index(const char* text) {
+    runtime_features |= RT_CHAIN;
+    for (int i = 0; i < literal_count; ++i)
+        if (strcmp(literals[i], text) == 0) return i;
+    literals = realloc(literals, sizeof(char*) * (literal_count + 1));
+    literals[literal_count] = strdup(text);
+    return literal_count++;
+}
+
+static void generate_literal_pool(FILE* out) {
+    if (literal_count == 0) return;
+    for (int i = 0; i < literal_count; ++i)
+        fprintf(out, "static const dpp_chain dpp_lit_%d = DPP_CHAIN_LITERAL(\"%s\");\n", i, literals[i]);
+    fprintf(out, "static const dpp_chain* const dpp_lit_pool[] __attribute__((unused)) = {");
+    for (int i = 0; i < literal_count; ++i)
+        fprintf(out, "%s&dpp_lit_%d", i > 0 ? ", " : " ", i);
+    fprintf(out, " };\n#define DPP_LIT_COUNT %d\n\n", literal_count);
+}
+
+// Variable o literal, como const dpp_chain*.
+static void generate_chain_ref(FILE* out, ASTNode* node) {
+    if (node->type == NODE_STRING)
+        fprintf(out, "&dpp_lit_%d", literal_index(node->sval));
+    else
+        fprintf(out, "&%s", node->sval);
+}
+
+static void generate_chain_view(FILE* out, ASTNode* node) {
+    fprintf(out, "dpp_chain_view(");
+    generate_chain_ref(out, node);
+    fprintf(out, ")");
+}
+
+// Emite prefix(&izquierda, &derecha)suffix. Los operandos que no son variables ni
+// literales se materializan en temporales que se liberan al terminar la expresión.
+static void generate_chain_pair(FILE* out, const char* prefix, ASTNode* left, ASTNode* right,
+                                const char* suffix) {
+    int temps = !is_simple_chain(left) || !is_simple_chain(right);
+    if (temps) {
+        fprintf(out, "({ ");
+        if (!is_simple_chain(left)) {
+            fprintf(out, "dpp_chain __l DPP_CHAIN_CLEANUP = ");
+            generate_chain_temp(out, left);
+            fprintf(out, "; ");
+        }
+        if (!is_simple_chain(right)) {
+            fprintf(out, "dpp_chain __r DPP_CHAIN_CLEANUP = ");
+            generate_chain_temp(out, right);
+            fprintf(out, "; ");
+        }
+    }
+    fprintf(out, "%s", prefix);
+    if (is_simple_chain(left)) generate_chain_ref(out, left);
+    else fprintf(out, "&__l");
+    fprintf(out, ", ");
+    if (is_simple_chain(right)) generate_chain_ref(out, right);
+    else fprintf(out, "&__r");
+    fprintf(out, "%s", suffix);
+    if (temps) fprintf(out, "; })");
+}
+
+static int is_chain_concat(ASTNode* node) {
+    return node->type == NODE_BINOP && strcmp(node->binop.op, "+") == 0 &&
+           node->binop.left->data_type == NODE_STRING &&
+           node->binop.right->data_type == NODE_STRING;
+}
+
+// Aplana un árbol de '+' entre cadenas en la lista de sus operandos, de izquierda a derecha.
+static void collect_concat_parts(ASTNode* node, ASTNode*** parts, int* count, int* cap) {
+    if (is_chain_concat(node)) {
+        collect_concat_parts(node->binop.left, parts, count, cap);
+        collect_concat_parts(node->binop.right, parts, count, cap);
+        return;
+    }
+    if (*count == *cap) {
+        *cap = *cap ? *cap * 2 : 8;
+        *parts = realloc(*parts, sizeof(ASTNode*) * *cap);
+    }
+    (*parts)[(*count)++] = node;
+}
+
+// Emite call((dpp_view[]){ parts[first..count) }, n)); las partes compuestas van a temporales.
+static void generate_chain_parts(FILE* out, const char* call, ASTNode** parts, int first, int count) {
+    int temps = 0;
+    for (int i = first; i < count; ++i) {
+        if (is_simple_chain(parts[i])) continue;
+        if (!temps++) fprintf(out, "({ ");
+        fprintf(out, "dpp_chain __c%d DPP_CHAIN_CLEANUP = ", i);
+        generate_chain_owned(out, parts[i]);
+        fprintf(out, "; ");
+    }
+    fprintf(out, "%s(dpp_view[]){ ", call);
+    for (int i = first; i < count; ++i) {
+        if (i > first) fprintf(out, ", ");
+        if (is_simple_chain(parts[i])) generate_chain_view(out, parts[i]);
+        else fprintf(out, "dpp_chain_view(&__c%d)", i);
+    }
+    fprintf(out, " }, %d)", count - first);
+    if (temps) fprintf(out, "; })");
+}
+
+// a + b + ... + z se genera como una sola concatenación de n partes.
+static void generate_chain_concat(FILE* out, ASTNode* node) {
+    ASTNode** parts = NULL;
+    int count = 0, cap = 0;
+    collect_concat_parts(node, &parts, &count, &cap);
+    generate_chain_parts(out, "dpp_chain_concat_n(", parts, 0, count);
+    free(parts);
+}
+
+// Dentro de un ciclo, `s = s + ...` agrega al final de s en lugar de recopiarlo entero.
+// No aplica si s vuelve a aparecer como parte: el búfer podría moverse mientras se copia.
+static int generate_chain_accumulate(FILE* out, const char* id, ASTNode* value) {
+    if (loop_depth == 0 || !is_chain_concat(value)) return 0;
+    ASTNode** parts = NULL;
+    int count = 0, cap = 0;
+    collect_concat_parts(value, &parts, &count, &cap);
+
+    int ok = parts[0]->type == NODE_ID && strcmp(parts[0]->sval, id) == 0;
+    for (int i = 1; ok && i < count; ++i)
+        if (parts[i]->type == NODE_ID && strcmp(parts[i]->sval, id) == 0) ok = 0;
+    if (ok) {
+        char call[128];
+        snprintf(call, sizeof(call), "dpp_chain_append_n(&%s, ", id);
+        generate_chain_parts(out, call, parts, 1, count);
+        fprintf(out, ";\n");
+    }
+    free(parts);
+    return ok;
+}
+
+// Expresión de tipo dpp_chain cuyo valor pasa a ser de quien la recibe.
+static void generate_chain_owned(FILE* out, ASTNode* node) {
+    runtime_features |= RT_CHAIN;
+    switch (node->type) {
+        case NODE_STRING:
+            fprintf(out, "dpp_lit_%d", literal_index(node->sval));
+            break;
+        case NODE_ID:
+            fprintf(out, "dpp_chain_copy(&%s)", node->sval);
+            break;
+        case NODE_BINOP:
+            generate_chain_concat(out, node);
+            break;
+        default:
+            // Las llamadas ya devuelven una cadena propia.
+            generate_code(out, node);
+            break;
+    }
+}
+
+// Argumento de cadena de una función integrada, ya materializado si hacía falta.
+static void generate_builtin_chain(FILE* out, ASTNode* arg, int index, int as_view) {
+    if (as_view) fprintf(out, "dpp_chain_view(");
+    if (is_simple_chain(arg)) generate_chain_ref(out, arg);
+    else fprintf(out, "&__a%d", index);
+    if (as_view) fprintf(out, ")");
+}
+
+// Funciones integradas sobre vectores: dpp_vec_<tipo>_<nombre>(&v, ...). Las que pueden
+// fallar reciben además la línea para el mensaje de error.
+static void generate_vector_call(FILE* out, ASTNode* node) {
+    static const char* const with_line[] = { "pop", "fill", "min", "max" };
+    ASTNode** args = node->funccall.args;
+    runtime_features |= RT_VECTOR | RT_ARRAY;
+    fprintf(out, "dpp_vec_%s_%s(", c_type_name(get_symbol(args[0]->sval)->type), node->funccall.id);
+    for (int i = 0; i < node->funccall.arg_count; ++i) {
+        if (i > 0) fprintf(out, ", ");
+        if (args[i]->data_type == NODE_VECTOR) fprintf(out, "&%s", args[i]->sval);
+        else generate_code(out, args[i]);
+    }
+    for (size_t i = 0; i < sizeof(with_line) / sizeof(with_line[0]); ++i)
+        if (strcmp(node->funccall.id, with_line[i]) == 0) fprintf(out, ", %d", node->line);
+    fprintf(out, ")");
+}
+
+// send y recv: dpp_chan_<tipo>_<nombre>(c, ...).
+static void generate_channel_call(FILE* out, ASTNode* node) {
+    ASTNode** args = node->funccall.args;
+    fprintf(out, "dpp_chan_%s_%s(%s", c_type_name(get_symbol(args[0]->sval)->type), node->funccall.id,
+            args[0]->sval);
+    for (int i = 1; i < node->funccall.arg_count; ++i) {
+        fprintf(out, ", ");
+        generate_code(out, args[i]);
+    }
+    fprintf(out, ")");
+}
+
+// Funciones integradas sobre maps: dpp_map_<clave>_<nombre>(&m, ...). Los valores viajan
+// como dpp_value; una clave chain que no es una variable se arma antes en un temporal.
+static void generate_map_call(FILE* out, ASTNode* node) {
+    ASTNode** args = node->funccall.args;
+    Symbol* map = get_symbol(args[0]->sval);
+    int chain_key = map->key_type == NODE_STRING;
+    const char* field = map->type == NODE_FLOAT ? "f" : "i";
+    int put = strcmp(node->funccall.id, "put") == 0;
+    runtime_features |= RT_MAP;
+    if (chain_key) runtime_features |= RT_CHAIN;
+
+    int key_temp = node->funccall.arg_count > 1 && chain_key && !is_simple_chain(args[1]);
+    if (key_temp) {
+        // put guarda la clave: no puede vivir en la región.
+        fprintf(out, "({ dpp_chain __a1 DPP_CHAIN_CLEANUP = ");
+        if (put) generate_chain_owned(out, args[1]);
+        else generate_chain_temp(out, args[1]);
+        fprintf(out, "; ");
+    }
+    fprintf(out, "dpp_map_%s_%s(&%s", chain_key ? "chain" : "int", node->funccall.id, args[0]->sval);
+    if (node->funccall.arg_count > 1) {
+        fprintf(out, ", ");
+        if (key_temp) fprintf(out, "&__a1");
+        else if (chain_key) generate_chain_ref(out, args[1]);
+        else generate_code(out, args[1]);
+    }
+    if (put) {
+        fprintf(out, ", (dpp_value){ .%s = ", field);
+        generate_code(out, args[2]);
+        fprintf(out, " }");
+    }
+    fprintf(out, ")");
+    if (strcmp(node->funccall.id, "get") == 0) fprintf(out, ".%s", field);
+    if (key_temp) fprintf(out, "; })");
+}
+
+// Las funciones integradas trabajan sobre la cadena original, sin copiarla. Las que
+// devuelven una cadena (sub, split) reciben la primera como dpp_chain para compartir su
+// búfer; el resto de los argumentos de cadena van como vistas.
+static void generate_builtin_call(FILE* out, ASTNode* node, const Builtin* builtin) {
+    runtime_features |= RT_CHAIN;
+    ASTNode** args = node->funccall.args;
+    int shares_buffer = builtin->return_type == NODE_STRING;
+    int temps = 0;
+
+    for (int i = 0; i < builtin->arg_count; ++i) {
+        if (builtin->arg_types[i] != NODE_STRING || is_simple_chain(args[i])) continue;
+        if (!temps++) fprintf(out, "({ ");
+        fprintf(out, "dpp_chain __a%d DPP_CHAIN_CLEANUP = ", i);
+        // El resultado de sub/split comparte el búfer del primer argumento: no puede ser temporal.
+        if (shares_buffer && i == 0) generate_chain_owned(out, args[i]);
+        else generate_chain_temp(out, args[i]);
+        fprintf(out, "; ");
+    }
+
+    fprintf(out, "dpp_chain_%s(", builtin->id);
+    for (int i = 0; i < builtin->arg_count; ++i) {
+        if (i > 0) fprintf(out, ", ");
+        if (builtin->arg_types[i] == NODE_STRING)
+            generate_builtin_chain(out, args[i], i, !(shares_buffer && i == 0));
+        else generate_code(out, args[i]);
+    }
+    fprintf(out, ")");
+    if (temps) fprintf(out, "; })");
+}
+
+// Cadena que se consume dentro de la misma sentencia: una concatenación va a la región.
+static void generate_chain_temp(FILE* out, ASTNode* node) {
+    if (!is_chain_concat(node)) {
+        generate_chain_owned(out, node);
+        return;
+    }
+    ASTNode** parts = NULL;
+    int count = 0, cap = 0;
+    collect_concat_parts(node, &parts, &count, &cap);
+    generate_chain_parts(out, "dpp_chain_concat_tmp(", parts, 0, count);
+    free(parts);
+    region_used = 1;
+}
+
+// El cuerpo se genera primero para saber qué partes del runtime necesita.
+void generate_program(FILE* out, ASTNode* root) {
+    FILE* functions = tmpfile();
+    FILE* body = tmpfile();
+    if (!functions || !body) {
+        fprintf(stderr, "Error: no se pudo crear el archivo temporal.\n");
+        exit(1);
+    }
+
+    generate_all_functions(functions);
+    spawn_used = 0;
+    generate_code(body, root);
+    int main_spawns = spawn_used;
+
+    int start_reader = async_input && (runtime_features & RT_INPUT);
+    if (start_reader) runtime_features |= RT_SYNC | RT_ASYNC_INPUT;
+
+    // main siempre llama a dpp_runtime_init(), que vive en el runtime de salida.
+    emit_runtime(out, runtime_features | RT_OUTPUT);
+    generate_literal_pool(out);
+    generate_record_types(out);
+    if (parallel_decls) copy_file(parallel_decls, out);
+    copy_file(functions, out);
+    if (parallel_defs) copy_file(parallel_defs, out);
+
+    fprintf(out, "int main() {\n");
+    fprintf(out, "dpp_runtime_init();\n");
+    if (start_reader) fprintf(out, "dpp_async_input_start();\n");
+    if (main_spawns) fprintf(out, "dpp_spawn_group __sg = { 0 };\n");
+    copy_file(body, out);
+    fprintf(out, "return 0;\n}\n");
 }
 
 void generate_code(FILE* out, ASTNode* node) {
@@ -33,7 +1106,9 @@ void generate_code(FILE* out, ASTNode* node) {
             break;
 
         case NODE_FLOAT:
-            fprintf(out, "%f", node->fval);
+            // Un valor evaluado en compilación va exacto y como float, igual que la llamada.
+            if (node->folded) fprintf(out, "%af", node->fval);
+            else fprintf(out, "%f", node->fval);
             break;
 
         case NODE_STRING:
@@ -45,35 +1120,70 @@ void generate_code(FILE* out, ASTNode* node) {
             break;
 
         case NODE_DECL:
+            if (current_generator && inline_depth == 0) {
+                // Vive en el frame; un arreglo vuelve a quedar en cero en cada declaración.
+                if (node->decl.array_size)
+                    fprintf(out, "memset(%s, 0, sizeof(__g->%s));\n", node->decl.id, node->decl.id);
+                break;
+            }
+            if (node->decl.is_vector) {
+                const char* type = c_type_name(node->decl.decl_type);
+                runtime_features |= RT_VECTOR | RT_ARRAY;
+                fprintf(out, "dpp_vec_%s %s DPP_VEC_CLEANUP(%s) = DPP_VEC_INIT;\n", type, node->decl.id, type);
+                break;
+            }
+            if (node->decl.is_map) {
+                const char* key = node->decl.key_type == NODE_STRING ? "chain" : "int";
+                runtime_features |= RT_MAP;
+                if (node->decl.key_type == NODE_STRING) runtime_features |= RT_CHAIN;
+                fprintf(out, "dpp_map_%s %s DPP_MAP_CLEANUP(%s) = DPP_MAP_INIT;\n", key, node->decl.id, key);
+                break;
+            }
+            if (node->decl.record) {
+                generate_record_decl(out, node);
+                break;
+            }
+            if (node->decl.is_channel) {
+                // El channel se libera al salir del bloque; analyze_parallel garantiza que
+                // para entonces terminaron las tareas que lo recibieron.
+                const char* type = c_type_name(node->decl.decl_type);
+                runtime_features |= RT_CHANNEL | RT_PARALLEL | RT_SYNC;
+                fprintf(out, "dpp_chan_%s* %s DPP_CHAN_CLEANUP(%s) = dpp_chan_%s_new(%d, %d, %d);\n", type,
+                        node->decl.id, type, type, node->decl.array_size, node->decl.spsc, node->line);
+                break;
+            }
+            if (node->decl.init) {
+                generate_table_decl(out, node);
+                break;
+            }
+            if (node->decl.array_size) {
+                generate_array_decl(out, c_type_name(node->decl.decl_type), node->decl.id,
+                                    node->decl.array_size, 4, "");
+                break;
+            }
             switch (node->decl.decl_type) {
                 case NODE_INT: fprintf(out, "int %s;\n", node->decl.id); break;
                 case NODE_FLOAT: fprintf(out, "float %s;\n", node->decl.id); break;
-                case NODE_STRING: fprintf(out, "char %s[100];\n", node->decl.id); break;
+                case NODE_STRING:
+                    runtime_features |= RT_CHAIN;
+                    fprintf(out, "dpp_chain %s DPP_CHAIN_CLEANUP = DPP_CHAIN_INIT;\n", node->decl.id);
+                    break;
                 default: break;
             }
             break;
 
         case NODE_ASSIGN: {
+            if (node->assign.value->type == NODE_FUNCCALL && node->assign.value->funccall.spawn) {
+                generate_spawn(out, node->assign.value, node->assign.id);
+                break;
+            }
             Symbol* symbol = get_symbol(node->assign.id);
             if (symbol && symbol->type == NODE_STRING) {
-                if (node->assign.value->type == NODE_BINOP &&
-                    strcmp(node->assign.value->binop.op, "+") == 0 &&
-                    node->assign.value->binop.left->data_type == NODE_STRING &&
-                    node->assign.value->binop.right->data_type == NODE_STRING) {
-
-                    fprintf(out, "char __temp_concat[200];\n");
-                    fprintf(out, "strcpy(__temp_concat, ");
-                    generate_code(out, node->assign.value->binop.left);
-                    fprintf(out, ");\n");
-                    fprintf(out, "strcat(__temp_concat, ");
-                    generate_code(out, node->assign.value->binop.right);
-                    fprintf(out, ");\n");
-                    fprintf(out, "strcpy(%s, __temp_concat);\n", node->assign.id);
-                } else {
-                    fprintf(out, "strcpy(%s, ", node->assign.id);
-                    generate_code(out, node->assign.value);
-                    fprintf(out, ");\n");
-                }
+                if (generate_chain_accumulate(out, node->assign.id, node->assign.value)) break;
+                // Asignar solo comparte el búfer: O(1) sin importar la longitud.
+                fprintf(out, "dpp_chain_move(&%s, ", node->assign.id);
+                generate_chain_owned(out, node->assign.value);
+                fprintf(out, ");\n");
             } else {
                 fprintf(out, "%s = ", node->assign.id);
                 generate_code(out, node->assign.value);
@@ -82,12 +1192,47 @@ void generate_code(FILE* out, ASTNode* node) {
             break;
         }
 
+        case NODE_INDEX:
+            generate_index(out, node);
+            break;
+
+        case NODE_INDEX_ASSIGN:
+            if (node->index.size == 0 && node->index.index) {
+                // En un vector el valor va primero: si hace push o pop sobre el mismo vector,
+                // data y len cambian, y la dirección y el límite se toman después.
+                fprintf(out, "{ %s __v = ", c_type_name(node->data_type));
+                generate_code(out, node->index.value);
+                fprintf(out, "; ");
+                generate_index(out, node);
+                fprintf(out, " = __v; }\n");
+                break;
+            }
+            generate_index(out, node);
+            fprintf(out, " = ");
+            generate_code(out, node->index.value);
+            fprintf(out, ";\n");
+            break;
+
         case NODE_PRINT:
             if (!node->print.value) break;
+            runtime_features |= RT_OUTPUT;
+            if (node->print.value->type == NODE_STRING) {
+                fprintf(out, "DPP_PRINT_LIT(\"%s\");\n", node->print.value->sval);
+                break;
+            }
+            if (node->print.value->data_type == NODE_STRING) {
+                if (node->print.value->type == NODE_ID) {
+                    fprintf(out, "dpp_print_chain(&%s);\n", node->print.value->sval);
+                } else {
+                    fprintf(out, "dpp_print_chain_owned(");
+                    generate_chain_temp(out, node->print.value);
+                    fprintf(out, ");\n");
+                }
+                break;
+            }
             switch (node->print.value->data_type) {
-                case NODE_INT: fprintf(out, "printf(\"%%d\\n\", "); break;
-                case NODE_FLOAT: fprintf(out, "printf(\"%%f\\n\", "); break;
-                case NODE_STRING: fprintf(out, "printf(\"%%s\\n\", "); break;
+                case NODE_INT: fprintf(out, "dpp_print_int("); break;
+                case NODE_FLOAT: fprintf(out, "dpp_print_float("); break;
                 default: break;
             }
             generate_code(out, node->print.value);
@@ -95,39 +1240,70 @@ void generate_code(FILE* out, ASTNode* node) {
             break;
 
         case NODE_READ: {
-            Symbol* sym = get_symbol(node->sval);
-            if (!sym) {
-                fprintf(stderr, "Error: variable '%s' no declarada para lectura.\n", node->sval);
-                exit(1);
+            runtime_features |= RT_INPUT;
+            // Como expresión devuelve 0 en EOF o si un campo no se puede leer.
+            if (node->read.returns_status) {
+                fprintf(out, "(dpp_fields_begin()");
+                for (int i = 0; i < node->read.id_count; ++i) {
+                    const char* id = node->read.ids[i];
+                    switch (get_symbol_type(id)) {
+                        case NODE_INT: fprintf(out, " && dpp_field_int(&%s)", id); break;
+                        case NODE_FLOAT: fprintf(out, " && dpp_field_float(&%s)", id); break;
+                        default: fprintf(out, " && dpp_field_chain(&%s)", id); break;
+                    }
+                }
+                fprintf(out, ")");
+                break;
             }
 
-            fprintf(out, "{\n");
-            fprintf(out, "  char __input_buf[100];\n");
-            fprintf(out, "  fgets(__input_buf, sizeof(__input_buf), stdin);\n");
-
-            if (sym->type == NODE_INT) {
-                fprintf(out, "  if (sscanf(__input_buf, \"%%d\", &%s) != 1) {\n", node->sval);
-                fprintf(out, "    fprintf(stderr, \"Error: se esperaba un número entero para '%s'.\\n\");\n", node->sval);
-                fprintf(out, "    exit(1);\n");
-                fprintf(out, "  }\n");
-            } else if (sym->type == NODE_FLOAT) {
-                fprintf(out, "  if (sscanf(__input_buf, \"%%f\", &%s) != 1) {\n", node->sval);
-                fprintf(out, "    fprintf(stderr, \"Error: se esperaba un número decimal para '%s'.\\n\");\n", node->sval);
-                fprintf(out, "    exit(1);\n");
-                fprintf(out, "  }\n");
-            } else if (sym->type == NODE_STRING) {
-                fprintf(out, "  sscanf(__input_buf, \"%%s\", %s);\n", node->sval);
-            } else {
-                fprintf(out, "  fprintf(stderr, \"Error: tipo no soportado para lectura.\\n\");\n");
-                fprintf(out, "  exit(1);\n");
+            fprintf(out, "dpp_fields_begin();\n");
+            for (int i = 0; i < node->read.id_count; ++i) {
+                const char* id = node->read.ids[i];
+                NodeType type = get_symbol_type(id);
+                if (type == NODE_INT) {
+                    fprintf(out, "if (!dpp_field_int(&%s)) {\n", id);
+                    fprintf(out, "  fprintf(stderr, \"Error: se esperaba un número entero para '%s'.\\n\");\n", id);
+                    fprintf(out, "  exit(1);\n");
+                    fprintf(out, "}\n");
+                } else if (type == NODE_FLOAT) {
+                    fprintf(out, "if (!dpp_field_float(&%s)) {\n", id);
+                    fprintf(out, "  fprintf(stderr, \"Error: se esperaba un número decimal para '%s'.\\n\");\n", id);
+                    fprintf(out, "  exit(1);\n");
+                    fprintf(out, "}\n");
+                } else {
+                    fprintf(out, "dpp_field_chain(&%s);\n", id);
+                }
             }
-
-            fprintf(out, "}\n");
             break;
         }
 
         case NODE_BINOP:
-            if ((strcmp(node->binop.op, "/") == 0 || strcmp(node->binop.op, "%") == 0)) {
+            if (node->binop.left->data_type == NODE_STRING &&
+                node->binop.right->data_type == NODE_STRING) {
+                const char* op = node->binop.op;
+                ASTNode* left = node->binop.left;
+                ASTNode* right = node->binop.right;
+                int equality = strcmp(op, "==") == 0 || strcmp(op, "!=") == 0;
+                if (strcmp(op, "+") == 0) {
+                    generate_chain_owned(out, node);
+                } else if (equality && (left->type == NODE_STRING) != (right->type == NODE_STRING) &&
+                           (left->type == NODE_ID || right->type == NODE_ID)) {
+                    // variable == literal: la variable se interna y se compara por puntero.
+                    ASTNode* var = left->type == NODE_ID ? left : right;
+                    ASTNode* lit = left->type == NODE_ID ? right : left;
+                    fprintf(out, "%sdpp_chain_equal_lit(&%s, &dpp_lit_%d, dpp_lit_pool, DPP_LIT_COUNT)",
+                            op[0] == '!' ? "!" : "", var->sval, literal_index(lit->sval));
+                } else if (equality) {
+                    generate_chain_pair(out, op[0] == '!' ? "!dpp_chain_equal(" : "dpp_chain_equal(",
+                                        left, right, ")");
+                } else {
+                    char suffix[16];
+                    snprintf(suffix, sizeof(suffix), ") %s 0)", node->binop.op);
+                    generate_chain_pair(out, "(dpp_chain_compare(", node->binop.left,
+                                        node->binop.right, suffix);
+                }
+            } else if ((strcmp(node->binop.op, "/") == 0 || strcmp(node->binop.op, "%") == 0) &&
+                !node->binop.nonzero_divisor) {
                 
                 fprintf(out, "({ ");
                 fprintf(out, "int __right; ");
@@ -151,53 +1327,161 @@ void generate_code(FILE* out, ASTNode* node) {
             fprintf(out, "if (");
             generate_code(out, node->ifstmt.cond);
             fprintf(out, ") {\n");
-            generate_code(out, node->ifstmt.then_branch);
+            generate_stmt(out, node->ifstmt.then_branch);
             fprintf(out, "}\n");
             if (node->ifstmt.else_branch) {
                 fprintf(out, "else {\n");
-                generate_code(out, node->ifstmt.else_branch);
+                generate_stmt(out, node->ifstmt.else_branch);
                 fprintf(out, "}\n");
             }
             break;
 
         case NODE_WHILE:
             fprintf(out, "while (");
-            generate_code(out, node->whilestmt.cond);
+            generate_loop_cond(out, node->whilestmt.cond);
             fprintf(out, ") {\n");
-            generate_code(out, node->whilestmt.body);
+            loop_depth++;
+            generate_loop_body(out, node->whilestmt.body, NULL);
+            loop_depth--;
             fprintf(out, "}\n");
             break;
 
         case NODE_FOR:
+            if (node->forstmt.parallel) {
+                generate_parallel_for(out, node);
+                break;
+            }
+            if (node->forstmt.simd) {
+                generate_simd_reduction(out, node);
+                break;
+            }
             fprintf(out, "{\n");
-            generate_code(out, node->forstmt.init);
+            generate_stmt(out, node->forstmt.init);
             fprintf(out, "while (");
-            generate_code(out, node->forstmt.cond);
+            generate_loop_cond(out, node->forstmt.cond);
             fprintf(out, ") {\n");
-            generate_code(out, node->forstmt.body);
-            generate_code(out, node->forstmt.update);
+            loop_depth++;
+            generate_loop_body(out, node->forstmt.body, node->forstmt.update);
+            loop_depth--;
+            fprintf(out, "}\n");
+            fprintf(out, "}\n");
+            break;
+
+        case NODE_FOR_IN: {
+            if (node->forin.call) {
+                // El frame del generador recorrido; dentro de otro generador es parte del suyo.
+                ASTNode* call = node->forin.call;
+                const char* iter = node->forin.iter;
+                fprintf(out, "{\n");
+                if (!current_generator || inline_depth > 0)
+                    fprintf(out, "dpp_gen_%s %s[1];\n", call->funccall.id, iter);
+                fprintf(out, "dpp_gen_%s_start(%s", call->funccall.id, iter);
+                for (int i = 0; i < call->funccall.arg_count; ++i) {
+                    fprintf(out, ", ");
+                    generate_code(out, call->funccall.args[i]);
+                }
+                fprintf(out, ");\n");
+                fprintf(out, "while (dpp_gen_%s_next(%s)) {\n", call->funccall.id, iter);
+                fprintf(out, "%s = %s->__value;\n", node->forin.key, iter);
+                loop_depth++;
+                generate_loop_body(out, node->forin.body, NULL);
+                loop_depth--;
+                fprintf(out, "}\n");
+                fprintf(out, "}\n");
+                break;
+            }
+            // Cada recorrido tiene su propio cursor: se pueden anidar.
+            static int cursor_count = 0;
+            int cursor = cursor_count++;
+            const char* key = get_symbol(node->forin.map)->key_type == NODE_STRING ? "chain" : "int";
+            fprintf(out, "{\n");
+            fprintf(out, "size_t __pos%d = 0;\n", cursor);
+            fprintf(out, "while (dpp_map_%s_next(&%s, &__pos%d, &%s)) {\n",
+                    key, node->forin.map, cursor, node->forin.key);
+            loop_depth++;
+            generate_framed(out, node->forin.body, NULL);
+            loop_depth--;
             fprintf(out, "}\n");
             fprintf(out, "}\n");
             break;
+        }
 
         case NODE_BLOCK:
             for (int i = 0; i < node->block.stmt_count; ++i) {
-                generate_code(out, node->block.stmts[i]);
+                generate_stmt(out, node->block.stmts[i]);
             }
             break;
 
-        case NODE_FUNCCALL:
+        case NODE_FUNCCALL: {
+            if (node->funccall.spawn) {
+                generate_spawn(out, node, NULL);
+                break;
+            }
+            const Builtin* builtin = get_builtin(node->funccall.id);
+            if (builtin && node->funccall.args[0]->data_type == NODE_MAP) {
+                generate_map_call(out, node);
+                break;
+            }
+            if (builtin && node->funccall.args[0]->data_type == NODE_VECTOR) {
+                generate_vector_call(out, node);
+                break;
+            }
+            if (builtin && node->funccall.args[0]->data_type == NODE_CHANNEL) {
+                generate_channel_call(out, node);
+                break;
+            }
+            if (builtin) {
+                generate_builtin_call(out, node, builtin);
+                break;
+            }
             fprintf(out, "%s(", node->funccall.id);
             for (int i = 0; i < node->funccall.arg_count; ++i) {
                 if (i > 0) fprintf(out, ", ");
-                generate_code(out, node->funccall.args[i]);
+                if (node->funccall.args[i]->data_type == NODE_STRING)
+                    generate_chain_owned(out, node->funccall.args[i]);
+                else
+                    generate_code(out, node->funccall.args[i]);
             }
-            fprintf(out, ");\n");
+            fprintf(out, ")");
+            break;
+        }
+
+        case NODE_INLINED:
+            fprintf(out, "({\n");
+            inline_depth++;
+            generate_stmt(out, node->inlined.body);
+            inline_depth--;
+            generate_code(out, node->inlined.result);
+            fprintf(out, ";\n})");
+            break;
+
+        case NODE_YIELD:
+            if (!current_generator) {
+                fprintf(stderr, "Error en la línea %d: yield solo se puede usar dentro de una función.\n",
+                        node->line);
+                exit(1);
+            }
+            fprintf(out, "__g->__value = ");
+            generate_code(out, node->yieldstmt.value);
+            fprintf(out, ";\n");
+            generate_frame_store(out, current_generator);
+            fprintf(out, "__g->__state = %d;\n", ++yield_count);
+            fprintf(out, "return 1;\n");
+            fprintf(out, "case %d:;\n", yield_count);
+            break;
+
+        case NODE_SYNC:
+            runtime_features |= RT_PARALLEL | RT_SYNC;
+            spawn_used = 1;
+            fprintf(out, "dpp_sync(&__sg);\n");
             break;
 
         case NODE_RETURN:
             fprintf(out, "return ");
-            generate_code(out, node->returnstmt.value);
+            if (node->returnstmt.value->data_type == NODE_STRING)
+                generate_chain_owned(out, node->returnstmt.value);
+            else
+                generate_code(out, node->returnstmt.value);
             fprintf(out, ";\n");
             break;
 
@@ -506,8 +506,28 @@ char *yytext;
 #include <string.h>
 
 extern YYSTYPE yylval;
-#line 510 "lex.yy.c"
-#line 511 "lex.yy.c"
+
+// Palabras reservadas que se reconocen a partir de la regla de identificadores.
+static const struct { const char* word; int token; } keywords[] = {
+    { "vector", VECTOR },
+    { "map", MAP },
+    { "in", IN },
+    { "record", RECORD },
+    { "layout", LAYOUT },
+    { "parallel", PARALLEL },
+    { "spawn", SPAWN },
+    { "sync", SYNC },
+    { "channel", CHANNEL },
+    { "yield", YIELD },
+};
+
+static int keyword_token(const char* text) {
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i)
+        if (strcmp(keywords[i].word, text) == 0) return keywords[i].token;
+    return 0;
+}
+#line 530 "lex.yy.c"
+#line 531 "lex.yy.c"
 
 #define INITIAL 0
 
@@ -724,10 +744,10 @@ YY_DECL
 		}
 
 	{
-#line 15 "scanner.l"
+#line 35 "scanner.l"
 
 
-#line 731 "lex.yy.c"
+#line 751 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -786,163 +806,163 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 17 "scanner.l"
+#line 37 "scanner.l"
 { return STRING; }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 18 "scanner.l"
+#line 38 "scanner.l"
 { return INT; }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 19 "scanner.l"
+#line 39 "scanner.l"
 { return FLOAT; }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 21 "scanner.l"
+#line 41 "scanner.l"
 { return IF; }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 22 "scanner.l"
+#line 42 "scanner.l"
 { return ELSE; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 23 "scanner.l"
+#line 43 "scanner.l"
 { return WHILE; }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 24 "scanner.l"
+#line 44 "scanner.l"
 { return FOR; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 25 "scanner.l"
+#line 45 "scanner.l"
 { return FUNCTION; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 26 "scanner.l"
+#line 46 "scanner.l"
 { return RETURN; }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 28 "scanner.l"
+#line 48 "scanner.l"
 { return PRINT; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 29 "scanner.l"
+#line 49 "scanner.l"
 { return WRITE; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 31 "scanner.l"
+#line 51 "scanner.l"
 { return EQ; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 32 "scanner.l"
+#line 52 "scanner.l"
 { return NEQ; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 33 "scanner.l"
+#line 53 "scanner.l"
 { return LEQ; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 34 "scanner.l"
+#line 54 "scanner.l"
 { return GEQ; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 35 "scanner.l"
+#line 55 "scanner.l"
 { return LT; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 36 "scanner.l"
+#line 56 "scanner.l"
 { return GT; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 37 "scanner.l"
+#line 57 "scanner.l"
 { return '%'; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 38 "scanner.l"
+#line 58 "scanner.l"
 { return '+'; }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 39 "scanner.l"
+#line 59 "scanner.l"
 { return '-'; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 40 "scanner.l"
+#line 60 "scanner.l"
 { return '*'; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 41 "scanner.l"
+#line 61 "scanner.l"
 { return '/'; }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 42 "scanner.l"
+#line 62 "scanner.l"
 { return '='; }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 43 "scanner.l"
+#line 63 "scanner.l"
 { return ';'; }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 44 "scanner.l"
+#line 64 "scanner.l"
 { return '('; }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 45 "scanner.l"
+#line 65 "scanner.l"
 { return ')'; }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 46 "scanner.l"
+#line 66 "scanner.l"
 { return '{'; }
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 47 "scanner.l"
+#line 67 "scanner.l"
 { return '}'; }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 49 "scanner.l"
+#line 69 "scanner.l"
 { yylval.fval = atof(yytext); return FLOATNUM; }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 50 "scanner.l"
+#line 70 "scanner.l"
 { yylval.ival = atoi(yytext); return NUMBER; }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 51 "scanner.l"
-{ yylval.id = strdup(yytext); return ID; }
+#line 71 "scanner.l"
+{ int token = keyword_token(yytext); if (token) return token; yylval.id = strdup(yytext); return ID; }
 	YY_BREAK
 case 32:
 /* rule 32 can match eol */
 YY_RULE_SETUP
-#line 53 "scanner.l"
+#line 73 "scanner.l"
 {
     yylval.id = (char*)malloc(yyleng - 1);
     strncpy(yylval.id, yytext + 1, yyleng - 2);
@@ -953,20 +973,20 @@ YY_RULE_SETUP
 case 33:
 /* rule 33 can match eol */
 YY_RULE_SETUP
-#line 60 "scanner.l"
-{ /* Ignorar espacios */ }
+#line 80 "scanner.l"
+{ for (int i = 0; i < yyleng; ++i) if (yytext[i] == '\n') yylineno++; }
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 62 "scanner.l"
+#line 82 "scanner.l"
 { return *yytext; }
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 64 "scanner.l"
+#line 84 "scanner.l"
 ECHO;
 	YY_BREAK
-#line 970 "lex.yy.c"
+#line 990 "lex.yy.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1971,7 +1991,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 64 "scanner.l"
+#line 84 "scanner.l"
 
 
 int yywrap() {
@@ -127,38 +127,54 @@ enum yysymbol_kind_t
   YYSYMBOL_WRITE = 15,                     /* WRITE  */
   YYSYMBOL_FUNCTION = 16,                  /* FUNCTION  */
   YYSYMBOL_RETURN = 17,                    /* RETURN  */
-  YYSYMBOL_EQ = 18,                        /* EQ  */
-  YYSYMBOL_NEQ = 19,                       /* NEQ  */
-  YYSYMBOL_LEQ = 20,                       /* LEQ  */
-  YYSYMBOL_GEQ = 21,                       /* GEQ  */
-  YYSYMBOL_LT = 22,                        /* LT  */
-  YYSYMBOL_GT = 23,                        /* GT  */
-  YYSYMBOL_24_ = 24,                       /* '+'  */
-  YYSYMBOL_25_ = 25,                       /* '-'  */
-  YYSYMBOL_26_ = 26,                       /* '*'  */
-  YYSYMBOL_27_ = 27,                       /* '/'  */
-  YYSYMBOL_28_ = 28,                       /* '%'  */
-  YYSYMBOL_LOWER_THAN_ELSE = 29,           /* LOWER_THAN_ELSE  */
-  YYSYMBOL_30_ = 30,                       /* ';'  */
-  YYSYMBOL_31_ = 31,                       /* '='  */
-  YYSYMBOL_32_ = 32,                       /* '('  */
-  YYSYMBOL_33_ = 33,                       /* ')'  */
-  YYSYMBOL_34_ = 34,                       /* '{'  */
-  YYSYMBOL_35_ = 35,                       /* '}'  */
-  YYSYMBOL_36_ = 36,                       /* ','  */
-  YYSYMBOL_YYACCEPT = 37,                  /* $accept  */
-  YYSYMBOL_program = 38,                   /* program  */
-  YYSYMBOL_stmt_list = 39,                 /* stmt_list  */
-  YYSYMBOL_stmt = 40,                      /* stmt  */
-  YYSYMBOL_func_def = 41,                  /* func_def  */
-  YYSYMBOL_param_list_opt = 42,            /* param_list_opt  */
-  YYSYMBOL_param_list = 43,                /* param_list  */
-  YYSYMBOL_param_decl = 44,                /* param_decl  */
-  YYSYMBOL_return_stmt = 45,               /* return_stmt  */
-  YYSYMBOL_func_call = 46,                 /* func_call  */
-  YYSYMBOL_arg_list_opt = 47,              /* arg_list_opt  */
-  YYSYMBOL_arg_list = 48,                  /* arg_list  */
-  YYSYMBOL_expr = 49                       /* expr  */
+  YYSYMBOL_VECTOR = 18,                    /* VECTOR  */
+  YYSYMBOL_MAP = 19,                       /* MAP  */
+  YYSYMBOL_IN = 20,                        /* IN  */
+  YYSYMBOL_RECORD = 21,                    /* RECORD  */
+  YYSYMBOL_LAYOUT = 22,                    /* LAYOUT  */
+  YYSYMBOL_PARALLEL = 23,                  /* PARALLEL  */
+  YYSYMBOL_SPAWN = 24,                     /* SPAWN  */
+  YYSYMBOL_SYNC = 25,                      /* SYNC  */
+  YYSYMBOL_CHANNEL = 26,                   /* CHANNEL  */
+  YYSYMBOL_YIELD = 27,                     /* YIELD  */
+  YYSYMBOL_EQ = 28,                        /* EQ  */
+  YYSYMBOL_NEQ = 29,                       /* NEQ  */
+  YYSYMBOL_LEQ = 30,                       /* LEQ  */
+  YYSYMBOL_GEQ = 31,                       /* GEQ  */
+  YYSYMBOL_LT = 32,                        /* LT  */
+  YYSYMBOL_GT = 33,                        /* GT  */
+  YYSYMBOL_34_ = 34,                       /* '+'  */
+  YYSYMBOL_35_ = 35,                       /* '-'  */
+  YYSYMBOL_36_ = 36,                       /* '*'  */
+  YYSYMBOL_37_ = 37,                       /* '/'  */
+  YYSYMBOL_38_ = 38,                       /* '%'  */
+  YYSYMBOL_LOWER_THAN_ELSE = 39,           /* LOWER_THAN_ELSE  */
+  YYSYMBOL_40_ = 40,                       /* ';'  */
+  YYSYMBOL_41_ = 41,                       /* '['  */
+  YYSYMBOL_42_ = 42,                       /* ']'  */
+  YYSYMBOL_43_ = 43,                       /* '{'  */
+  YYSYMBOL_44_ = 44,                       /* '}'  */
+  YYSYMBOL_45_ = 45,                       /* '='  */
+  YYSYMBOL_46_ = 46,                       /* '.'  */
+  YYSYMBOL_47_ = 47,                       /* '('  */
+  YYSYMBOL_48_ = 48,                       /* ')'  */
+  YYSYMBOL_49_ = 49,                       /* ','  */
+  YYSYMBOL_YYACCEPT = 50,                  /* $accept  */
+  YYSYMBOL_program = 51,                   /* program  */
+  YYSYMBOL_stmt_list = 52,                 /* stmt_list  */
+  YYSYMBOL_stmt = 53,                      /* stmt  */
+  YYSYMBOL_value_type = 54,                /* value_type  */
+  YYSYMBOL_field_list = 55,                /* field_list  */
+  YYSYMBOL_func_def = 56,                  /* func_def  */
+  YYSYMBOL_param_list_opt = 57,            /* param_list_opt  */
+  YYSYMBOL_param_list = 58,                /* param_list  */
+  YYSYMBOL_param_decl = 59,                /* param_decl  */
+  YYSYMBOL_read_list = 60,                 /* read_list  */
+  YYSYMBOL_return_stmt = 61,               /* return_stmt  */
+  YYSYMBOL_func_call = 62,                 /* func_call  */
+  YYSYMBOL_arg_list_opt = 63,              /* arg_list_opt  */
+  YYSYMBOL_arg_list = 64,                  /* arg_list  */
+  YYSYMBOL_expr = 65                       /* expr  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -275,7 +291,7 @@ typedef int yytype_uint16;
 
 
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_uint8 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -484,21 +500,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  33
+#define YYFINAL  60
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   242
+#define YYLAST   488
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  37
+#define YYNTOKENS  50
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  13
+#define YYNNTS  16
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  48
+#define YYNRULES  82
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  112
+#define YYNSTATES  231
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   279
+#define YYMAXUTOK   289
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -515,16 +531,16 @@ static const yytype_int8 yytranslate[] =
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,    28,     2,     2,
-      32,    33,    26,    24,    36,    25,     2,    27,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    30,
-       2,    31,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,    38,     2,     2,
+      47,    48,    36,    34,    49,    35,    46,    37,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    40,
+       2,    45,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    41,     2,    42,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,    34,     2,    35,     2,     2,     2,     2,
+       2,     2,     2,    43,     2,    44,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -539,18 +555,23 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
-      15,    16,    17,    18,    19,    20,    21,    22,    23,    29
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    39
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    45,    45,    49,    58,    69,    70,    71,    72,    73,
-      74,    75,    77,    79,    80,    81,    83,    84,    88,    96,
-      97,   101,   106,   114,   115,   116,   120,   124,   130,   131,
-     135,   140,   148,   149,   150,   151,   152,   153,   154,   155,
-     156,   157,   158,   159,   160,   161,   162,   163,   164
+       0,    51,    51,    55,    64,    75,    76,    77,    78,    80,
+      82,    84,    85,    86,    87,    90,    93,    95,    96,    98,
+     100,   102,   103,   105,   106,   107,   108,   110,   112,   113,
+     114,   116,   118,   120,   122,   123,   124,   126,   127,   128,
+     132,   133,   134,   138,   143,   151,   159,   160,   164,   169,
+     177,   178,   179,   180,   185,   190,   198,   202,   208,   209,
+     213,   218,   226,   227,   228,   229,   230,   231,   232,   233,
+     234,   235,   236,   237,   238,   239,   240,   241,   242,   243,
+     245,   246,   247
 };
 #endif
 
@@ -568,12 +589,14 @@ static const char *const yytname[] =
 {
   "\"end of file\"", "error", "\"invalid token\"", "NUMBER", "FLOATNUM",
   "ID", "STRING_LITERAL", "INT", "FLOAT", "STRING", "IF", "ELSE", "WHILE",
-  "FOR", "PRINT", "WRITE", "FUNCTION", "RETURN", "EQ", "NEQ", "LEQ", "GEQ",
-  "LT", "GT", "'+'", "'-'", "'*'", "'/'", "'%'", "LOWER_THAN_ELSE", "';'",
-  "'='", "'('", "')'", "'{'", "'}'", "','", "$accept", "program",
-  "stmt_list", "stmt", "func_def", "param_list_opt", "param_list",
-  "param_decl", "return_stmt", "func_call", "arg_list_opt", "arg_list",
-  "expr", YY_NULLPTR
+  "FOR", "PRINT", "WRITE", "FUNCTION", "RETURN", "VECTOR", "MAP", "IN",
+  "RECORD", "LAYOUT", "PARALLEL", "SPAWN", "SYNC", "CHANNEL", "YIELD",
+  "EQ", "NEQ", "LEQ", "GEQ", "LT", "GT", "'+'", "'-'", "'*'", "'/'", "'%'",
+  "LOWER_THAN_ELSE", "';'", "'['", "']'", "'{'", "'}'", "'='", "'.'",
+  "'('", "')'", "','", "$accept", "program", "stmt_list", "stmt",
+  "value_type", "field_list", "func_def", "param_list_opt", "param_list",
+  "param_decl", "read_list", "return_stmt", "func_call", "arg_list_opt",
+  "arg_list", "expr", YY_NULLPTR
 };
 
 static const char *
@@ -583,7 +606,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-26)
+#define YYPACT_NINF (-82)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -597,18 +620,30 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      67,   -25,     3,    14,    16,    -9,    -4,     2,     7,    30,
-      31,    67,    37,    67,   -26,   -26,     9,     7,     7,    23,
-      26,    28,     7,     7,     7,   -26,   -26,   -14,   -26,   132,
-      35,    41,    17,   -26,   -26,   -26,   145,    45,    48,   197,
-     -26,   -26,   -26,    84,   100,   158,     7,     7,     7,     7,
-       7,     7,     7,     7,     7,     7,     7,     7,     7,   -26,
-     -26,    -5,   -26,   -26,   -26,     7,    67,    67,     7,   197,
-      52,   -26,   -26,   -26,   -26,   -26,   -26,   208,   208,   219,
-     219,   219,    82,    85,    90,    56,    60,   -26,   197,    86,
-     -26,   171,   -26,   -26,   -26,   -26,    65,    -5,    67,     7,
-      67,   -26,   -26,   116,    54,    67,     7,    78,   -26,   184,
-     -26,   -26
+     228,     1,    19,    26,    36,    -4,     8,    59,    90,    68,
+     102,    43,    93,   104,    99,   113,    -1,    93,    90,   228,
+     120,   228,   -82,   -82,    79,   -25,    90,    30,   116,    90,
+     -12,    20,    37,    90,    90,   110,   -82,   -82,   -24,   -82,
+      68,   307,   -82,     9,    75,   118,   131,   142,   -82,   -82,
+     -82,    93,    98,   101,   114,   135,   -82,   166,   320,   119,
+     -82,   -82,   -82,   -82,   173,    34,   113,   333,   132,   130,
+     138,   450,   -82,   188,   -82,   190,   -82,   191,   122,   229,
+      12,   346,    90,    90,   193,    90,   195,    90,    90,    90,
+      90,    90,    90,    90,    90,    90,    90,    90,   -82,   -82,
+     -82,     4,   155,   156,   161,   197,    93,    90,   -82,   162,
+     -82,   -82,   164,    45,   167,   -82,    90,   -82,    90,   174,
+     183,   185,   228,   228,   204,    90,   292,   450,   -82,   186,
+     -82,   -82,   -82,   -82,   -82,   -82,   152,   152,   136,   136,
+     136,   234,   240,   245,    93,   208,   219,   -82,   -82,   -82,
+     -82,   230,   264,     0,   359,   269,    -2,    90,   268,   -82,
+     372,   450,   235,   236,   249,   263,   -82,    50,   385,   244,
+     -82,   -82,   -82,   -82,   286,   251,     4,   -82,   252,   -82,
+     288,    90,   253,   291,   -82,   398,   265,   -82,   -82,   -82,
+     -82,   228,    90,   228,    90,   306,   -82,   228,   -82,   -82,
+     257,   411,   272,   273,   -82,    90,   -82,   266,   -82,   250,
+     -82,   205,   -82,    90,   -82,   -82,   424,   267,   228,    90,
+     274,   271,   -82,   228,   -82,   437,   -82,   228,   -82,   -82,
+     -82
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -617,92 +652,152 @@ static const yytype_int16 yypact[] =
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     2,     3,    17,     0,     0,    28,     0,
-       0,     0,     0,     0,     0,    45,    47,    46,    48,     0,
-       0,     0,     0,     1,     4,    16,     0,     0,    29,    30,
-       5,     6,     7,     0,     0,     0,     0,    28,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     9,
-      10,    19,    14,     8,    27,     0,     0,     0,     0,    43,
-       0,    37,    38,    39,    40,    41,    42,    32,    33,    34,
-      35,    36,     0,     0,     0,     0,    20,    21,    31,    11,
-      13,     0,    44,    23,    24,    25,     0,     0,     0,     0,
-       0,    22,    12,     0,     0,     0,     0,     0,    15,     0,
-      18,    26
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     2,     3,    39,     0,     0,     0,     0,     0,    58,
+       0,     0,     0,     0,     0,     0,    76,    81,    80,    82,
+       0,     0,    54,     0,     0,     0,     0,     0,    40,    41,
+      42,     0,     0,     0,     0,     0,    37,     0,     0,     0,
+       1,     4,    34,    17,     0,     0,     0,     0,     0,     0,
+      59,    60,     5,     0,     6,     0,     7,     0,     0,     0,
+      80,     0,     0,     0,     0,    58,    75,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    24,    55,
+      25,    46,     0,     0,     0,     0,     0,     0,    35,     0,
+      38,    29,     0,     0,     0,    23,     0,    57,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    73,    78,     0,
+      67,    68,    69,    70,    71,    72,    62,    63,    64,    65,
+      66,     0,     0,     0,     0,     0,    47,    48,    11,    12,
+      13,     0,     0,     0,     0,     0,     0,     0,     0,    36,
+       0,    61,     0,     0,     0,    26,    28,     0,     0,    77,
+      74,    50,    51,    52,     0,     0,     0,    14,     0,    16,
+       0,     0,     0,     0,    18,     0,     0,    21,     8,     9,
+      10,     0,    58,     0,     0,     0,    53,     0,    49,    43,
+       0,     0,     0,     0,    20,     0,    27,     0,    32,     0,
+      79,     0,    44,     0,    15,    19,     0,     0,     0,     0,
+       0,     0,    22,     0,    30,     0,    45,     0,    33,    56,
+      31
 };
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int16 yypgoto[] =
 {
-     -26,   -26,    -6,   -12,   -26,   -26,   -26,    18,   -26,   -26,
-      53,   -26,    -8
+     -82,   -82,   -18,   -19,   -14,   -82,   -82,   -82,   -82,   140,
+     277,   -82,   -10,   -81,   -82,    -8
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+static const yytype_uint8 yydefgoto[] =
 {
-       0,    12,    13,    14,    15,    85,    86,    87,   107,    16,
-      37,    38,    39
+       0,    20,    21,    22,    51,   153,    23,   145,   146,   147,
+      43,   220,    24,    69,    70,    71
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+static const yytype_uint8 yytable[] =
 {
-      29,    34,    82,    83,    84,    32,    17,    18,    19,    36,
-      25,    26,    27,    28,    43,    44,    45,    46,    47,    20,
-      34,    21,     1,    22,     2,     3,     4,     5,    23,     6,
-       7,     8,     9,    10,    24,    30,    31,    33,    69,    35,
-      71,    72,    73,    74,    75,    76,    77,    78,    79,    80,
-      81,    11,    62,    40,    89,    90,    41,    88,    42,     1,
-      91,     2,     3,     4,     5,    60,     6,     7,     8,     9,
-      10,   106,     1,    61,     2,     3,     4,     5,    64,     6,
-       7,     8,     9,    10,    65,    92,   102,    93,    11,    96,
-      94,   103,    34,   108,   104,    95,    97,    98,   109,   100,
-      70,    11,    48,    49,    50,    51,    52,    53,    54,    55,
-      56,    57,    58,   110,     0,   101,     0,    66,    48,    49,
-      50,    51,    52,    53,    54,    55,    56,    57,    58,     0,
-       0,     0,     0,    67,    48,    49,    50,    51,    52,    53,
-      54,    55,    56,    57,    58,     0,     0,     0,     0,   105,
-      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
-      58,     0,    59,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,     0,    63,    48,    49,    50,    51,
-      52,    53,    54,    55,    56,    57,    58,     0,    68,    48,
-      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
-       0,    99,    48,    49,    50,    51,    52,    53,    54,    55,
-      56,    57,    58,     0,   111,    48,    49,    50,    51,    52,
-      53,    54,    55,    56,    57,    58,    48,    49,    50,    51,
-      52,    53,     0,     0,    56,    57,    58,    48,    49,    50,
-      51,    52,    53
+      41,    59,    61,    57,   129,    55,    25,    48,    49,    50,
+      58,   141,   142,   143,    99,    63,    64,    82,    65,    67,
+     183,    83,    84,    85,    30,    78,    79,    81,    72,    73,
+     144,    31,   124,    36,    37,    38,    39,   105,   184,    56,
+      61,    32,    26,    33,   179,    40,    27,    28,    29,   100,
+      45,    46,    47,    82,    66,    34,   114,    83,    84,    85,
+      74,    75,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    42,   126,   127,   113,    76,    77,   130,
+     131,   132,   133,   134,   135,   136,   137,   138,   139,   140,
+     157,   158,   152,    36,    37,    38,    39,   192,   193,   154,
+      48,    49,    50,   165,   166,    40,    35,    44,   160,    52,
+     161,   207,    53,    36,    37,    80,    39,   168,    54,    62,
+      60,    68,   101,   102,     1,    40,     2,     3,     4,     5,
+     174,     6,     7,     8,     9,    10,   103,    11,    12,   180,
+      13,   106,    14,    15,    16,    17,    18,   104,   107,   185,
+      87,    88,    89,    90,    91,    92,    93,    94,    95,    96,
+      97,    29,    19,   111,    87,    88,    89,    90,    91,    92,
+     122,   109,   206,   201,   208,   108,   112,   116,   117,   211,
+      87,    88,    89,    90,    91,    92,   209,   118,    95,    96,
+      97,   119,    61,   120,   121,   148,   149,   216,   128,   224,
+      99,   150,   151,   155,   228,   221,   156,   159,   230,   167,
+       1,   225,     2,     3,     4,     5,   162,     6,     7,     8,
+       9,    10,   219,    11,    12,   163,    13,   164,    14,    15,
+      16,    17,    18,     1,   170,     2,     3,     4,     5,   171,
+       6,     7,     8,     9,    10,   172,    11,    12,    19,    13,
+     173,    14,    15,    16,    17,    18,   175,    87,    88,    89,
+      90,    91,    92,    93,    94,    95,    96,    97,   176,   178,
+     177,    19,   182,   186,   191,   188,   189,   123,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,   190,
+     195,   196,   199,   200,   197,   202,   203,   212,   218,    87,
+      88,    89,    90,    91,    92,    93,    94,    95,    96,    97,
+     205,   210,   214,   215,   217,   223,   198,    86,   226,   227,
+      87,    88,    89,    90,    91,    92,    93,    94,    95,    96,
+      97,     0,     0,     0,   169,    87,    88,    89,    90,    91,
+      92,    93,    94,    95,    96,    97,     0,    98,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,     0,
+     110,    87,    88,    89,    90,    91,    92,    93,    94,    95,
+      96,    97,     0,   115,    87,    88,    89,    90,    91,    92,
+      93,    94,    95,    96,    97,     0,   125,    87,    88,    89,
+      90,    91,    92,    93,    94,    95,    96,    97,     0,   181,
+      87,    88,    89,    90,    91,    92,    93,    94,    95,    96,
+      97,     0,   187,    87,    88,    89,    90,    91,    92,    93,
+      94,    95,    96,    97,     0,   194,    87,    88,    89,    90,
+      91,    92,    93,    94,    95,    96,    97,     0,   204,    87,
+      88,    89,    90,    91,    92,    93,    94,    95,    96,    97,
+       0,   213,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,     0,   222,    87,    88,    89,    90,    91,
+      92,    93,    94,    95,    96,    97,     0,   229,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       8,    13,     7,     8,     9,    11,    31,    32,     5,    17,
-       3,     4,     5,     6,    22,    23,    24,    31,    32,     5,
-      32,     5,     5,    32,     7,     8,     9,    10,    32,    12,
-      13,    14,    15,    16,    32,     5,     5,     0,    46,    30,
-      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
-      58,    34,    35,    30,    66,    67,    30,    65,    30,     5,
-      68,     7,     8,     9,    10,    30,    12,    13,    14,    15,
-      16,    17,     5,    32,     7,     8,     9,    10,    33,    12,
-      13,    14,    15,    16,    36,    33,    98,     5,    34,    33,
-       5,    99,   104,   105,   100,     5,    36,    11,   106,    34,
-      47,    34,    18,    19,    20,    21,    22,    23,    24,    25,
-      26,    27,    28,    35,    -1,    97,    -1,    33,    18,    19,
-      20,    21,    22,    23,    24,    25,    26,    27,    28,    -1,
-      -1,    -1,    -1,    33,    18,    19,    20,    21,    22,    23,
-      24,    25,    26,    27,    28,    -1,    -1,    -1,    -1,    33,
-      18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    -1,    30,    18,    19,    20,    21,    22,    23,    24,
-      25,    26,    27,    28,    -1,    30,    18,    19,    20,    21,
-      22,    23,    24,    25,    26,    27,    28,    -1,    30,    18,
-      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
-      -1,    30,    18,    19,    20,    21,    22,    23,    24,    25,
-      26,    27,    28,    -1,    30,    18,    19,    20,    21,    22,
-      23,    24,    25,    26,    27,    28,    18,    19,    20,    21,
-      22,    23,    -1,    -1,    26,    27,    28,    18,    19,    20,
-      21,    22,    23
+       8,    19,    21,    17,    85,    15,     5,     7,     8,     9,
+      18,     7,     8,     9,     5,    40,    41,    41,    26,    27,
+      22,    45,    46,    47,     5,    33,    34,    35,    40,    41,
+      26,     5,    20,     3,     4,     5,     6,    51,    40,    40,
+      59,     5,    41,    47,    44,    15,    45,    46,    47,    40,
+       7,     8,     9,    41,    24,    47,    66,    45,    46,    47,
+      40,    41,    28,    29,    30,    31,    32,    33,    34,    35,
+      36,    37,    38,     5,    82,    83,    42,    40,    41,    87,
+      88,    89,    90,    91,    92,    93,    94,    95,    96,    97,
+      45,    46,   106,     3,     4,     5,     6,    47,    48,   107,
+       7,     8,     9,   122,   123,    15,    47,     5,   116,     5,
+     118,   192,    13,     3,     4,     5,     6,   125,     5,    40,
+       0,     5,    47,     5,     5,    15,     7,     8,     9,    10,
+     144,    12,    13,    14,    15,    16,     5,    18,    19,   153,
+      21,    43,    23,    24,    25,    26,    27,     5,    47,   157,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    47,    43,    44,    28,    29,    30,    31,    32,    33,
+      48,     5,   191,   181,   193,    40,     3,    45,    48,   197,
+      28,    29,    30,    31,    32,    33,   194,    49,    36,    37,
+      38,     3,   211,     3,     3,    40,    40,   205,     5,   218,
+       5,    40,     5,    41,   223,   213,    42,    40,   227,     5,
+       5,   219,     7,     8,     9,    10,    42,    12,    13,    14,
+      15,    16,    17,    18,    19,    42,    21,    42,    23,    24,
+      25,    26,    27,     5,    48,     7,     8,     9,    10,     5,
+      12,    13,    14,    15,    16,     5,    18,    19,    43,    21,
+       5,    23,    24,    25,    26,    27,    48,    28,    29,    30,
+      31,    32,    33,    34,    35,    36,    37,    38,    49,     5,
+      40,    43,     3,     5,    11,    40,    40,    48,    28,    29,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    40,
+      46,     5,    40,     5,    43,    42,     5,    40,    48,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      45,     5,    40,    40,    48,    48,   176,    40,    44,    48,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    -1,    -1,    -1,    42,    28,    29,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    -1,    40,    28,    29,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    -1,
+      40,    28,    29,    30,    31,    32,    33,    34,    35,    36,
+      37,    38,    -1,    40,    28,    29,    30,    31,    32,    33,
+      34,    35,    36,    37,    38,    -1,    40,    28,    29,    30,
+      31,    32,    33,    34,    35,    36,    37,    38,    -1,    40,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    -1,    40,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    -1,    40,    28,    29,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    -1,    40,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      -1,    40,    28,    29,    30,    31,    32,    33,    34,    35,
+      36,    37,    38,    -1,    40,    28,    29,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    -1,    40,    28,    29,
+      30,    31,    32,    33,    34,    35,    36,    37,    38
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -710,37 +805,57 @@ static const yytype_int8 yycheck[] =
 static const yytype_int8 yystos[] =
 {
        0,     5,     7,     8,     9,    10,    12,    13,    14,    15,
-      16,    34,    38,    39,    40,    41,    46,    31,    32,     5,
-       5,     5,    32,    32,    32,     3,     4,     5,     6,    49,
-       5,     5,    39,     0,    40,    30,    49,    47,    48,    49,
-      30,    30,    30,    49,    49,    49,    31,    32,    18,    19,
-      20,    21,    22,    23,    24,    25,    26,    27,    28,    30,
-      30,    32,    35,    30,    33,    36,    33,    33,    30,    49,
-      47,    49,    49,    49,    49,    49,    49,    49,    49,    49,
-      49,    49,     7,     8,     9,    42,    43,    44,    49,    40,
-      40,    49,    33,     5,     5,     5,    33,    36,    11,    30,
-      34,    44,    40,    49,    39,    33,    17,    45,    40,    49,
-      35,    30
+      16,    18,    19,    21,    23,    24,    25,    26,    27,    43,
+      51,    52,    53,    56,    62,     5,    41,    45,    46,    47,
+       5,     5,     5,    47,    47,    47,     3,     4,     5,     6,
+      15,    65,     5,    60,     5,     7,     8,     9,     7,     8,
+       9,    54,     5,    13,     5,    62,    40,    54,    65,    52,
+       0,    53,    40,    40,    41,    65,    24,    65,     5,    63,
+      64,    65,    40,    41,    40,    41,    40,    41,    65,    65,
+       5,    65,    41,    45,    46,    47,    60,    28,    29,    30,
+      31,    32,    33,    34,    35,    36,    37,    38,    40,     5,
+      40,    47,     5,     5,     5,    54,    43,    47,    40,     5,
+      40,    44,     3,    42,    62,    40,    45,    48,    49,     3,
+       3,     3,    48,    48,    20,    40,    65,    65,     5,    63,
+      65,    65,    65,    65,    65,    65,    65,    65,    65,    65,
+      65,     7,     8,     9,    26,    57,    58,    59,    40,    40,
+      40,     5,    54,    55,    65,    41,    42,    45,    46,    40,
+      65,    65,    42,    42,    42,    53,    53,     5,    65,    42,
+      48,     5,     5,     5,    54,    48,    49,    40,     5,    44,
+      54,    40,     3,    22,    40,    65,     5,    40,    40,    40,
+      40,    11,    47,    48,    40,    46,     5,    43,    59,    40,
+       5,    65,    42,     5,    40,    45,    53,    63,    53,    65,
+       5,    52,    40,    40,    40,    40,    65,    48,    48,    17,
+      61,    65,    40,    48,    53,    65,    44,    48,    53,    40,
+      53
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    37,    38,    39,    39,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    41,    42,
-      42,    43,    43,    44,    44,    44,    45,    46,    47,    47,
-      48,    48,    49,    49,    49,    49,    49,    49,    49,    49,
-      49,    49,    49,    49,    49,    49,    49,    49,    49
+       0,    50,    51,    52,    52,    53,    53,    53,    53,    53,
+      53,    53,    53,    53,    53,    53,    53,    53,    53,    53,
+      53,    53,    53,    53,    53,    53,    53,    53,    53,    53,
+      53,    53,    53,    53,    53,    53,    53,    53,    53,    53,
+      54,    54,    54,    55,    55,    56,    57,    57,    58,    58,
+      59,    59,    59,    59,    60,    60,    61,    62,    63,    63,
+      64,    64,    65,    65,    65,    65,    65,    65,    65,    65,
+      65,    65,    65,    65,    65,    65,    65,    65,    65,    65,
+      65,    65,    65
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
-       0,     2,     1,     1,     2,     3,     3,     3,     4,     3,
-       3,     5,     7,     5,     3,     9,     2,     1,     9,     0,
-       1,     1,     3,     2,     2,     2,     3,     4,     0,     1,
+       0,     2,     1,     1,     2,     3,     3,     3,     6,     6,
+       6,     4,     4,     4,     5,     7,     5,     3,     6,     8,
+       7,     6,     9,     4,     3,     3,     5,     7,     5,     3,
+       9,    10,     7,    10,     2,     3,     5,     2,     3,     1,
+       1,     1,     1,     3,     4,     9,     0,     1,     1,     3,
+       2,     2,     2,     3,     1,     2,     3,     4,     0,     1,
        1,     3,     3,     3,     3,     3,     3,     3,     3,     3,
-       3,     3,     3,     3,     4,     1,     1,     1,     1
+       3,     3,     3,     3,     4,     2,     1,     4,     3,     6,
+       1,     1,     1
 };
 
 
@@ -1204,13 +1319,13 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* program: stmt_list  */
-#line 45 "parser.y"
+#line 51 "parser.y"
                             { root = (ASTNode*)(yyvsp[0].node); }
-#line 1210 "parser.tab.c"
+#line 1325 "parser.tab.c"
     break;
 
   case 3: /* stmt_list: stmt  */
-#line 49 "parser.y"
+#line 55 "parser.y"
                            {
                             ASTNode** stmts = malloc(sizeof(ASTNode*));
                             stmts[0] = (ASTNode*)(yyvsp[0].node);
@@ -1220,11 +1335,11 @@ yyreduce:
                             block->block.stmt_count = 1;
                             (yyval.node) = block;
                           }
-#line 1224 "parser.tab.c"
+#line 1339 "parser.tab.c"
     break;
 
   case 4: /* stmt_list: stmt_list stmt  */
-#line 58 "parser.y"
+#line 64 "parser.y"
                            {
                             ASTNode* block = (ASTNode*)(yyvsp[-1].node);
                             int n = block->block.stmt_count + 1;
@@ -1233,296 +1348,518 @@ yyreduce:
                             block->block.stmt_count = n;
                             (yyval.node) = block;
                           }
-#line 1237 "parser.tab.c"
+#line 1352 "parser.tab.c"
     break;
 
   case 5: /* stmt: INT ID ';'  */
-#line 69 "parser.y"
+#line 75 "parser.y"
                                { add_symbol((yyvsp[-1].id), NODE_INT); (yyval.node) = make_decl_node((yyvsp[-1].id), NODE_INT); }
-#line 1243 "parser.tab.c"
+#line 1358 "parser.tab.c"
     break;
 
   case 6: /* stmt: FLOAT ID ';'  */
-#line 70 "parser.y"
+#line 76 "parser.y"
                                { add_symbol((yyvsp[-1].id), NODE_FLOAT); (yyval.node) = make_decl_node((yyvsp[-1].id), NODE_FLOAT); }
-#line 1249 "parser.tab.c"
+#line 1364 "parser.tab.c"
     break;
 
   case 7: /* stmt: STRING ID ';'  */
-#line 71 "parser.y"
+#line 77 "parser.y"
                                { add_symbol((yyvsp[-1].id), NODE_STRING); (yyval.node) = make_decl_node((yyvsp[-1].id), NODE_STRING); }
-#line 1255 "parser.tab.c"
+#line 1370 "parser.tab.c"
+    break;
+
+  case 8: /* stmt: INT ID '[' NUMBER ']' ';'  */
+#line 79 "parser.y"
+                                { add_array_symbol((yyvsp[-4].id), NODE_INT, (yyvsp[-2].ival)); (yyval.node) = make_array_decl_node((yyvsp[-4].id), NODE_INT, (yyvsp[-2].ival)); }
+#line 1376 "parser.tab.c"
+    break;
+
+  case 9: /* stmt: FLOAT ID '[' NUMBER ']' ';'  */
+#line 81 "parser.y"
+                                { add_array_symbol((yyvsp[-4].id), NODE_FLOAT, (yyvsp[-2].ival)); (yyval.node) = make_array_decl_node((yyvsp[-4].id), NODE_FLOAT, (yyvsp[-2].ival)); }
+#line 1382 "parser.tab.c"
+    break;
+
+  case 10: /* stmt: STRING ID '[' NUMBER ']' ';'  */
+#line 83 "parser.y"
+                                { add_array_symbol((yyvsp[-4].id), NODE_STRING, (yyvsp[-2].ival)); (yyval.node) = NULL; }
+#line 1388 "parser.tab.c"
+    break;
+
+  case 11: /* stmt: VECTOR INT ID ';'  */
+#line 84 "parser.y"
+                               { add_vector_symbol((yyvsp[-1].id), NODE_INT); (yyval.node) = make_vector_decl_node((yyvsp[-1].id), NODE_INT); }
+#line 1394 "parser.tab.c"
+    break;
+
+  case 12: /* stmt: VECTOR FLOAT ID ';'  */
+#line 85 "parser.y"
+                               { add_vector_symbol((yyvsp[-1].id), NODE_FLOAT); (yyval.node) = make_vector_decl_node((yyvsp[-1].id), NODE_FLOAT); }
+#line 1400 "parser.tab.c"
     break;
 
-  case 8: /* stmt: ID '=' expr ';'  */
-#line 72 "parser.y"
+  case 13: /* stmt: VECTOR STRING ID ';'  */
+#line 86 "parser.y"
+                               { add_vector_symbol((yyvsp[-1].id), NODE_STRING); (yyval.node) = NULL; }
+#line 1406 "parser.tab.c"
+    break;
+
+  case 14: /* stmt: MAP value_type value_type ID ';'  */
+#line 88 "parser.y"
+                                { add_map_symbol((yyvsp[-1].id), (NodeType)(yyvsp[-3].ival), (NodeType)(yyvsp[-2].ival));
+                                  (yyval.node) = make_map_decl_node((yyvsp[-1].id), (NodeType)(yyvsp[-3].ival), (NodeType)(yyvsp[-2].ival)); }
+#line 1413 "parser.tab.c"
+    break;
+
+  case 15: /* stmt: CHANNEL value_type ID '[' NUMBER ']' ';'  */
+#line 91 "parser.y"
+                                { add_channel_symbol((yyvsp[-4].id), (NodeType)(yyvsp[-5].ival));
+                                  (yyval.node) = make_channel_decl_node((yyvsp[-4].id), (NodeType)(yyvsp[-5].ival), (yyvsp[-2].ival)); }
+#line 1420 "parser.tab.c"
+    break;
+
+  case 16: /* stmt: RECORD ID '{' field_list '}'  */
+#line 94 "parser.y"
+                                { add_record((yyvsp[-3].id), (yyvsp[-1].node_list).list, (yyvsp[-1].node_list).count); (yyval.node) = NULL; }
+#line 1426 "parser.tab.c"
+    break;
+
+  case 17: /* stmt: ID ID ';'  */
+#line 95 "parser.y"
+                               { add_record_symbol((yyvsp[-1].id), (yyvsp[-2].id), 0, NULL); (yyval.node) = make_record_decl_node((yyvsp[-1].id)); }
+#line 1432 "parser.tab.c"
+    break;
+
+  case 18: /* stmt: ID ID '[' NUMBER ']' ';'  */
+#line 97 "parser.y"
+                                { add_record_symbol((yyvsp[-4].id), (yyvsp[-5].id), (yyvsp[-2].ival), "aos"); (yyval.node) = make_record_decl_node((yyvsp[-4].id)); }
+#line 1438 "parser.tab.c"
+    break;
+
+  case 19: /* stmt: ID ID '[' NUMBER ']' LAYOUT ID ';'  */
+#line 99 "parser.y"
+                                { add_record_symbol((yyvsp[-6].id), (yyvsp[-7].id), (yyvsp[-4].ival), (yyvsp[-1].id)); (yyval.node) = make_record_decl_node((yyvsp[-6].id)); }
+#line 1444 "parser.tab.c"
+    break;
+
+  case 20: /* stmt: ID '[' expr ']' '=' expr ';'  */
+#line 101 "parser.y"
+                                { (yyval.node) = make_index_assign_node((yyvsp[-6].id), (ASTNode*)(yyvsp[-4].node), (ASTNode*)(yyvsp[-1].node)); }
+#line 1450 "parser.tab.c"
+    break;
+
+  case 21: /* stmt: ID '.' ID '=' expr ';'  */
+#line 102 "parser.y"
+                               { (yyval.node) = make_field_assign_node((yyvsp[-5].id), NULL, (yyvsp[-3].id), (ASTNode*)(yyvsp[-1].node)); }
+#line 1456 "parser.tab.c"
+    break;
+
+  case 22: /* stmt: ID '[' expr ']' '.' ID '=' expr ';'  */
+#line 104 "parser.y"
+                                { (yyval.node) = make_field_assign_node((yyvsp[-8].id), (ASTNode*)(yyvsp[-6].node), (yyvsp[-3].id), (ASTNode*)(yyvsp[-1].node)); }
+#line 1462 "parser.tab.c"
+    break;
+
+  case 23: /* stmt: ID '=' expr ';'  */
+#line 105 "parser.y"
                                { (yyval.node) = make_assign_node((yyvsp[-3].id), (ASTNode*)(yyvsp[-1].node)); }
-#line 1261 "parser.tab.c"
+#line 1468 "parser.tab.c"
     break;
 
-  case 9: /* stmt: PRINT expr ';'  */
-#line 73 "parser.y"
+  case 24: /* stmt: PRINT expr ';'  */
+#line 106 "parser.y"
                                { (yyval.node) = make_print_node((ASTNode*)(yyvsp[-1].node)); }
-#line 1267 "parser.tab.c"
+#line 1474 "parser.tab.c"
     break;
 
-  case 10: /* stmt: WRITE ID ';'  */
-#line 74 "parser.y"
-                               { (yyval.node) = make_read_node((yyvsp[-1].id), -1); }
-#line 1273 "parser.tab.c"
+  case 25: /* stmt: WRITE read_list ';'  */
+#line 107 "parser.y"
+                               { (yyval.node) = make_read_node((yyvsp[-1].id_list).ids, (yyvsp[-1].id_list).count, 0); }
+#line 1480 "parser.tab.c"
     break;
 
-  case 11: /* stmt: IF '(' expr ')' stmt  */
-#line 76 "parser.y"
+  case 26: /* stmt: IF '(' expr ')' stmt  */
+#line 109 "parser.y"
                                 { (yyval.node) = make_if_node((ASTNode*)(yyvsp[-2].node), (ASTNode*)(yyvsp[0].node), NULL); }
-#line 1279 "parser.tab.c"
+#line 1486 "parser.tab.c"
     break;
 
-  case 12: /* stmt: IF '(' expr ')' stmt ELSE stmt  */
-#line 78 "parser.y"
+  case 27: /* stmt: IF '(' expr ')' stmt ELSE stmt  */
+#line 111 "parser.y"
                                 { (yyval.node) = make_if_node((ASTNode*)(yyvsp[-4].node), (ASTNode*)(yyvsp[-2].node), (ASTNode*)(yyvsp[0].node)); }
-#line 1285 "parser.tab.c"
+#line 1492 "parser.tab.c"
     break;
 
-  case 13: /* stmt: WHILE '(' expr ')' stmt  */
-#line 79 "parser.y"
+  case 28: /* stmt: WHILE '(' expr ')' stmt  */
+#line 112 "parser.y"
                                { (yyval.node) = make_while_node((ASTNode*)(yyvsp[-2].node), (ASTNode*)(yyvsp[0].node)); }
-#line 1291 "parser.tab.c"
+#line 1498 "parser.tab.c"
     break;
 
-  case 14: /* stmt: '{' stmt_list '}'  */
-#line 80 "parser.y"
+  case 29: /* stmt: '{' stmt_list '}'  */
+#line 113 "parser.y"
                                { (yyval.node) = (yyvsp[-1].node); }
-#line 1297 "parser.tab.c"
+#line 1504 "parser.tab.c"
     break;
 
-  case 15: /* stmt: FOR '(' expr ';' expr ';' expr ')' stmt  */
-#line 82 "parser.y"
+  case 30: /* stmt: FOR '(' expr ';' expr ';' expr ')' stmt  */
+#line 115 "parser.y"
                                 { (yyval.node) = make_for_node((ASTNode*)(yyvsp[-6].node), (ASTNode*)(yyvsp[-4].node), (ASTNode*)(yyvsp[-2].node), (ASTNode*)(yyvsp[0].node)); }
-#line 1303 "parser.tab.c"
+#line 1510 "parser.tab.c"
     break;
 
-  case 16: /* stmt: func_call ';'  */
-#line 83 "parser.y"
+  case 31: /* stmt: PARALLEL FOR '(' expr ';' expr ';' expr ')' stmt  */
+#line 117 "parser.y"
+                                { (yyval.node) = make_parallel_for_node((ASTNode*)(yyvsp[-6].node), (ASTNode*)(yyvsp[-4].node), (ASTNode*)(yyvsp[-2].node), (ASTNode*)(yyvsp[0].node)); }
+#line 1516 "parser.tab.c"
+    break;
+
+  case 32: /* stmt: FOR '(' ID IN ID ')' stmt  */
+#line 119 "parser.y"
+                                { (yyval.node) = make_for_in_node((yyvsp[-4].id), (yyvsp[-2].id), (ASTNode*)(yyvsp[0].node)); }
+#line 1522 "parser.tab.c"
+    break;
+
+  case 33: /* stmt: FOR '(' ID IN ID '(' arg_list_opt ')' ')' stmt  */
+#line 121 "parser.y"
+                                { (yyval.node) = make_for_generator_node((yyvsp[-7].id), (yyvsp[-5].id), (yyvsp[-3].node_list).list, (yyvsp[-3].node_list).count, (ASTNode*)(yyvsp[0].node)); }
+#line 1528 "parser.tab.c"
+    break;
+
+  case 34: /* stmt: func_call ';'  */
+#line 122 "parser.y"
                                { (yyval.node) = (yyvsp[-1].node); }
-#line 1309 "parser.tab.c"
+#line 1534 "parser.tab.c"
     break;
 
-  case 17: /* stmt: func_def  */
-#line 84 "parser.y"
+  case 35: /* stmt: SPAWN func_call ';'  */
+#line 123 "parser.y"
+                               { (yyval.node) = make_spawn_node(NULL, (ASTNode*)(yyvsp[-1].node)); }
+#line 1540 "parser.tab.c"
+    break;
+
+  case 36: /* stmt: ID '=' SPAWN func_call ';'  */
+#line 125 "parser.y"
+                                { (yyval.node) = make_spawn_node((yyvsp[-4].id), (ASTNode*)(yyvsp[-1].node)); }
+#line 1546 "parser.tab.c"
+    break;
+
+  case 37: /* stmt: SYNC ';'  */
+#line 126 "parser.y"
+                               { (yyval.node) = make_sync_node(); }
+#line 1552 "parser.tab.c"
+    break;
+
+  case 38: /* stmt: YIELD expr ';'  */
+#line 127 "parser.y"
+                               { (yyval.node) = make_yield_node((ASTNode*)(yyvsp[-1].node)); }
+#line 1558 "parser.tab.c"
+    break;
+
+  case 39: /* stmt: func_def  */
+#line 128 "parser.y"
                                { (yyval.node) = NULL; }
-#line 1315 "parser.tab.c"
+#line 1564 "parser.tab.c"
+    break;
+
+  case 40: /* value_type: INT  */
+#line 132 "parser.y"
+                               { (yyval.ival) = NODE_INT; }
+#line 1570 "parser.tab.c"
+    break;
+
+  case 41: /* value_type: FLOAT  */
+#line 133 "parser.y"
+                               { (yyval.ival) = NODE_FLOAT; }
+#line 1576 "parser.tab.c"
+    break;
+
+  case 42: /* value_type: STRING  */
+#line 134 "parser.y"
+                               { (yyval.ival) = NODE_STRING; }
+#line 1582 "parser.tab.c"
+    break;
+
+  case 43: /* field_list: value_type ID ';'  */
+#line 138 "parser.y"
+                        {
+        (yyval.node_list).list = malloc(sizeof(ASTNode*) * 1);
+        (yyval.node_list).list[0] = make_decl_node((yyvsp[-1].id), (NodeType)(yyvsp[-2].ival));
+        (yyval.node_list).count = 1;
+    }
+#line 1592 "parser.tab.c"
+    break;
+
+  case 44: /* field_list: field_list value_type ID ';'  */
+#line 143 "parser.y"
+                                   {
+        (yyvsp[-3].node_list).list = realloc((yyvsp[-3].node_list).list, sizeof(ASTNode*) * ((yyvsp[-3].node_list).count + 1));
+        (yyvsp[-3].node_list).list[(yyvsp[-3].node_list).count++] = make_decl_node((yyvsp[-1].id), (NodeType)(yyvsp[-2].ival));
+        (yyval.node_list) = (yyvsp[-3].node_list);
+    }
+#line 1602 "parser.tab.c"
     break;
 
-  case 18: /* func_def: FUNCTION ID '(' param_list_opt ')' '{' stmt_list return_stmt '}'  */
-#line 89 "parser.y"
+  case 45: /* func_def: FUNCTION ID '(' param_list_opt ')' '{' stmt_list return_stmt '}'  */
+#line 152 "parser.y"
     {
         (yyval.node) = make_funcdef_node((yyvsp[-7].id), (yyvsp[-5].node_list).list, (yyvsp[-5].node_list).count, (yyvsp[-2].node), (yyvsp[-1].node));
         add_function((yyvsp[-7].id), (yyvsp[-5].node_list).list, (yyvsp[-5].node_list).count, (yyvsp[-2].node), (yyvsp[-1].node));
     }
-#line 1324 "parser.tab.c"
+#line 1611 "parser.tab.c"
     break;
 
-  case 19: /* param_list_opt: %empty  */
-#line 96 "parser.y"
+  case 46: /* param_list_opt: %empty  */
+#line 159 "parser.y"
                    { (yyval.node_list).list = NULL; (yyval.node_list).count = 0; }
-#line 1330 "parser.tab.c"
+#line 1617 "parser.tab.c"
     break;
 
-  case 20: /* param_list_opt: param_list  */
-#line 97 "parser.y"
+  case 47: /* param_list_opt: param_list  */
+#line 160 "parser.y"
                  { (yyval.node_list) = (yyvsp[0].node_list); }
-#line 1336 "parser.tab.c"
+#line 1623 "parser.tab.c"
     break;
 
-  case 21: /* param_list: param_decl  */
-#line 101 "parser.y"
+  case 48: /* param_list: param_decl  */
+#line 164 "parser.y"
                  {
         (yyval.node_list).list = malloc(sizeof(ASTNode*) * 1);
         (yyval.node_list).list[0] = (ASTNode*)(yyvsp[0].node);
         (yyval.node_list).count = 1;
     }
-#line 1346 "parser.tab.c"
+#line 1633 "parser.tab.c"
     break;
 
-  case 22: /* param_list: param_list ',' param_decl  */
-#line 106 "parser.y"
+  case 49: /* param_list: param_list ',' param_decl  */
+#line 169 "parser.y"
                                 {
         (yyvsp[-2].node_list).list = realloc((yyvsp[-2].node_list).list, sizeof(ASTNode*) * ((yyvsp[-2].node_list).count + 1));
         (yyvsp[-2].node_list).list[(yyvsp[-2].node_list).count++] = (ASTNode*)(yyvsp[0].node);
         (yyval.node_list) = (yyvsp[-2].node_list);
     }
-#line 1356 "parser.tab.c"
+#line 1643 "parser.tab.c"
     break;
 
-  case 23: /* param_decl: INT ID  */
-#line 114 "parser.y"
+  case 50: /* param_decl: INT ID  */
+#line 177 "parser.y"
                 { (yyval.node) = make_decl_node((yyvsp[0].id), NODE_INT); add_symbol((yyvsp[0].id), NODE_INT); }
-#line 1362 "parser.tab.c"
+#line 1649 "parser.tab.c"
     break;
 
-  case 24: /* param_decl: FLOAT ID  */
-#line 115 "parser.y"
+  case 51: /* param_decl: FLOAT ID  */
+#line 178 "parser.y"
                 { (yyval.node) = make_decl_node((yyvsp[0].id), NODE_FLOAT); add_symbol((yyvsp[0].id), NODE_FLOAT); }
-#line 1368 "parser.tab.c"
+#line 1655 "parser.tab.c"
     break;
 
-  case 25: /* param_decl: STRING ID  */
-#line 116 "parser.y"
+  case 52: /* param_decl: STRING ID  */
+#line 179 "parser.y"
                 { (yyval.node) = make_decl_node((yyvsp[0].id), NODE_STRING); add_symbol((yyvsp[0].id), NODE_STRING); }
-#line 1374 "parser.tab.c"
+#line 1661 "parser.tab.c"
+    break;
+
+  case 53: /* param_decl: CHANNEL value_type ID  */
+#line 181 "parser.y"
+                { (yyval.node) = make_channel_param_node((yyvsp[0].id), (NodeType)(yyvsp[-1].ival)); }
+#line 1667 "parser.tab.c"
     break;
 
-  case 26: /* return_stmt: RETURN expr ';'  */
-#line 120 "parser.y"
+  case 54: /* read_list: ID  */
+#line 185 "parser.y"
+         {
+        (yyval.id_list).ids = malloc(sizeof(char*) * 1);
+        (yyval.id_list).ids[0] = (yyvsp[0].id);
+        (yyval.id_list).count = 1;
+    }
+#line 1677 "parser.tab.c"
+    break;
+
+  case 55: /* read_list: read_list ID  */
+#line 190 "parser.y"
+                   {
+        (yyvsp[-1].id_list).ids = realloc((yyvsp[-1].id_list).ids, sizeof(char*) * ((yyvsp[-1].id_list).count + 1));
+        (yyvsp[-1].id_list).ids[(yyvsp[-1].id_list).count++] = (yyvsp[0].id);
+        (yyval.id_list) = (yyvsp[-1].id_list);
+    }
+#line 1687 "parser.tab.c"
+    break;
+
+  case 56: /* return_stmt: RETURN expr ';'  */
+#line 198 "parser.y"
                     { (yyval.node) = make_return_node((yyvsp[-1].node)); }
-#line 1380 "parser.tab.c"
+#line 1693 "parser.tab.c"
     break;
 
-  case 27: /* func_call: ID '(' arg_list_opt ')'  */
-#line 124 "parser.y"
+  case 57: /* func_call: ID '(' arg_list_opt ')'  */
+#line 202 "parser.y"
                             {
         (yyval.node) = make_funccall_node_with_args((yyvsp[-3].id), (yyvsp[-1].node_list).list, (yyvsp[-1].node_list).count);
     }
-#line 1388 "parser.tab.c"
+#line 1701 "parser.tab.c"
     break;
 
-  case 28: /* arg_list_opt: %empty  */
-#line 130 "parser.y"
+  case 58: /* arg_list_opt: %empty  */
+#line 208 "parser.y"
                    { (yyval.node_list).list = NULL; (yyval.node_list).count = 0; }
-#line 1394 "parser.tab.c"
+#line 1707 "parser.tab.c"
     break;
 
-  case 29: /* arg_list_opt: arg_list  */
-#line 131 "parser.y"
+  case 59: /* arg_list_opt: arg_list  */
+#line 209 "parser.y"
                { (yyval.node_list) = (yyvsp[0].node_list); }
-#line 1400 "parser.tab.c"
+#line 1713 "parser.tab.c"
     break;
 
-  case 30: /* arg_list: expr  */
-#line 135 "parser.y"
+  case 60: /* arg_list: expr  */
+#line 213 "parser.y"
            {
         (yyval.node_list).list = malloc(sizeof(ASTNode*) * 1);
         (yyval.node_list).list[0] = (ASTNode*)(yyvsp[0].node);
         (yyval.node_list).count = 1;
     }
-#line 1410 "parser.tab.c"
+#line 1723 "parser.tab.c"
     break;
 
-  case 31: /* arg_list: arg_list ',' expr  */
-#line 140 "parser.y"
+  case 61: /* arg_list: arg_list ',' expr  */
+#line 218 "parser.y"
                         {
         (yyvsp[-2].node_list).list = realloc((yyvsp[-2].node_list).list, sizeof(ASTNode*) * ((yyvsp[-2].node_list).count + 1));
         (yyvsp[-2].node_list).list[(yyvsp[-2].node_list).count++] = (ASTNode*)(yyvsp[0].node);
         (yyval.node_list) = (yyvsp[-2].node_list);
     }
-#line 1420 "parser.tab.c"
+#line 1733 "parser.tab.c"
     break;
 
-  case 32: /* expr: expr '+' expr  */
-#line 148 "parser.y"
+  case 62: /* expr: expr '+' expr  */
+#line 226 "parser.y"
                          { (yyval.node) = make_binop_node("+", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1426 "parser.tab.c"
+#line 1739 "parser.tab.c"
     break;
 
-  case 33: /* expr: expr '-' expr  */
-#line 149 "parser.y"
+  case 63: /* expr: expr '-' expr  */
+#line 227 "parser.y"
                          { (yyval.node) = make_binop_node("-", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1432 "parser.tab.c"
+#line 1745 "parser.tab.c"
     break;
 
-  case 34: /* expr: expr '*' expr  */
-#line 150 "parser.y"
+  case 64: /* expr: expr '*' expr  */
+#line 228 "parser.y"
                          { (yyval.node) = make_binop_node("*", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1438 "parser.tab.c"
+#line 1751 "parser.tab.c"
     break;
 
-  case 35: /* expr: expr '/' expr  */
-#line 151 "parser.y"
+  case 65: /* expr: expr '/' expr  */
+#line 229 "parser.y"
                          { (yyval.node) = make_binop_node("/", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1444 "parser.tab.c"
+#line 1757 "parser.tab.c"
     break;
 
-  case 36: /* expr: expr '%' expr  */
-#line 152 "parser.y"
+  case 66: /* expr: expr '%' expr  */
+#line 230 "parser.y"
                          { (yyval.node) = make_binop_node("%", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1450 "parser.tab.c"
+#line 1763 "parser.tab.c"
     break;
 
-  case 37: /* expr: expr EQ expr  */
-#line 153 "parser.y"
+  case 67: /* expr: expr EQ expr  */
+#line 231 "parser.y"
                          { (yyval.node) = make_binop_node("==", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1456 "parser.tab.c"
+#line 1769 "parser.tab.c"
     break;
 
-  case 38: /* expr: expr NEQ expr  */
-#line 154 "parser.y"
+  case 68: /* expr: expr NEQ expr  */
+#line 232 "parser.y"
                          { (yyval.node) = make_binop_node("!=", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1462 "parser.tab.c"
+#line 1775 "parser.tab.c"
     break;
 
-  case 39: /* expr: expr LEQ expr  */
-#line 155 "parser.y"
+  case 69: /* expr: expr LEQ expr  */
+#line 233 "parser.y"
                          { (yyval.node) = make_binop_node("<=", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1468 "parser.tab.c"
+#line 1781 "parser.tab.c"
     break;
 
-  case 40: /* expr: expr GEQ expr  */
-#line 156 "parser.y"
+  case 70: /* expr: expr GEQ expr  */
+#line 234 "parser.y"
                          { (yyval.node) = make_binop_node(">=", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1474 "parser.tab.c"
+#line 1787 "parser.tab.c"
     break;
 
-  case 41: /* expr: expr LT expr  */
-#line 157 "parser.y"
+  case 71: /* expr: expr LT expr  */
+#line 235 "parser.y"
                          { (yyval.node) = make_binop_node("<", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1480 "parser.tab.c"
+#line 1793 "parser.tab.c"
     break;
 
-  case 42: /* expr: expr GT expr  */
-#line 158 "parser.y"
+  case 72: /* expr: expr GT expr  */
+#line 236 "parser.y"
                          { (yyval.node) = make_binop_node(">", (yyvsp[-2].node), (yyvsp[0].node)); }
-#line 1486 "parser.tab.c"
+#line 1799 "parser.tab.c"
     break;
 
-  case 43: /* expr: ID '=' expr  */
-#line 159 "parser.y"
+  case 73: /* expr: ID '=' expr  */
+#line 237 "parser.y"
                          { (yyval.node) = make_assign_node((yyvsp[-2].id), (ASTNode*)(yyvsp[0].node)); }
-#line 1492 "parser.tab.c"
+#line 1805 "parser.tab.c"
     break;
 
-  case 44: /* expr: ID '(' arg_list_opt ')'  */
-#line 160 "parser.y"
+  case 74: /* expr: ID '(' arg_list_opt ')'  */
+#line 238 "parser.y"
                               { (yyval.node) = make_funccall_node_with_args((yyvsp[-3].id), (yyvsp[-1].node_list).list, (yyvsp[-1].node_list).count); }
-#line 1498 "parser.tab.c"
+#line 1811 "parser.tab.c"
     break;
 
-  case 45: /* expr: NUMBER  */
-#line 161 "parser.y"
+  case 75: /* expr: WRITE read_list  */
+#line 239 "parser.y"
+                         { (yyval.node) = make_read_node((yyvsp[0].id_list).ids, (yyvsp[0].id_list).count, 1); }
+#line 1817 "parser.tab.c"
+    break;
+
+  case 76: /* expr: NUMBER  */
+#line 240 "parser.y"
                          { (yyval.node) = make_int_node((yyvsp[0].ival)); }
-#line 1504 "parser.tab.c"
+#line 1823 "parser.tab.c"
     break;
 
-  case 46: /* expr: ID  */
-#line 162 "parser.y"
+  case 77: /* expr: ID '[' expr ']'  */
+#line 241 "parser.y"
+                         { (yyval.node) = make_index_node((yyvsp[-3].id), (ASTNode*)(yyvsp[-1].node)); }
+#line 1829 "parser.tab.c"
+    break;
+
+  case 78: /* expr: ID '.' ID  */
+#line 242 "parser.y"
+                         { (yyval.node) = make_field_node((yyvsp[-2].id), NULL, (yyvsp[0].id)); }
+#line 1835 "parser.tab.c"
+    break;
+
+  case 79: /* expr: ID '[' expr ']' '.' ID  */
+#line 244 "parser.y"
+                         { (yyval.node) = make_field_node((yyvsp[-5].id), (ASTNode*)(yyvsp[-3].node), (yyvsp[0].id)); }
+#line 1841 "parser.tab.c"
+    break;
+
+  case 80: /* expr: ID  */
+#line 245 "parser.y"
                          { (yyval.node) = make_id_node((yyvsp[0].id)); }
-#line 1510 "parser.tab.c"
+#line 1847 "parser.tab.c"
     break;
 
-  case 47: /* expr: FLOATNUM  */
-#line 163 "parser.y"
+  case 81: /* expr: FLOATNUM  */
+#line 246 "parser.y"
                          { (yyval.node) = make_float_node((yyvsp[0].fval)); }
-#line 1516 "parser.tab.c"
+#line 1853 "parser.tab.c"
     break;
 
-  case 48: /* expr: STRING_LITERAL  */
-#line 164 "parser.y"
+  case 82: /* expr: STRING_LITERAL  */
+#line 247 "parser.y"
                          { (yyval.node) = make_string_node((yyvsp[0].id)); }
-#line 1522 "parser.tab.c"
+#line 1859 "parser.tab.c"
     break;
 
 
-#line 1526 "parser.tab.c"
+#line 1863 "parser.tab.c"
 
       default: break;
     }
@@ -1715,21 +2052,38 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 167 "parser.y"
-
+#line 250 "parser.y"
+
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--inline-threshold") == 0 && i + 1 < argc) {
+            inline_threshold = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--inline-threshold=", 19) == 0) {
+            inline_threshold = atoi(argv[i] + 19);
+        } else if (strcmp(argv[i], "--async-input") == 0) {
+            async_input = 1;
+        } else if (strcmp(argv[i], "--eval-budget") == 0 && i + 1 < argc) {
+            eval_budget = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--eval-budget=", 14) == 0) {
+            eval_budget = atoi(argv[i] + 14);
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else {
+            fprintf(stderr, "Error: opción desconocida '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
 
-int main() {
     if (yyparse() == 0) {
-        FILE* out = fopen("output.c", "w");
-        fprintf(out, "#include <stdio.h>\n");
-        fprintf(out, "#include <string.h>\n");
-        fprintf(out, "#include <stdlib.h>\n");
+        inline_functions(root);
+        analyze_ranges(root);
+        analyze_parallel(root);
+        analyze_effects();
+        evaluate_calls(root);
 
-        generate_all_functions(out);
-
-        fprintf(out, "int main() {\n");
-        generate_code(out, root);
-        fprintf(out, "return 0;\n}\n");
+        FILE* out = fopen("output.c", "w");
+        generate_program(out, root);
         fclose(out);
         printf("Código C generado en output.c\n");
     }
@@ -69,13 +69,23 @@ extern int yydebug;
     WRITE = 270,                   /* WRITE  */
     FUNCTION = 271,                /* FUNCTION  */
     RETURN = 272,                  /* RETURN  */
-    EQ = 273,                      /* EQ  */
-    NEQ = 274,                     /* NEQ  */
-    LEQ = 275,                     /* LEQ  */
-    GEQ = 276,                     /* GEQ  */
-    LT = 277,                      /* LT  */
-    GT = 278,                      /* GT  */
-    LOWER_THAN_ELSE = 279          /* LOWER_THAN_ELSE  */
+    VECTOR = 273,                  /* VECTOR  */
+    MAP = 274,                     /* MAP  */
+    IN = 275,                      /* IN  */
+    RECORD = 276,                  /* RECORD  */
+    LAYOUT = 277,                  /* LAYOUT  */
+    PARALLEL = 278,                /* PARALLEL  */
+    SPAWN = 279,                   /* SPAWN  */
+    SYNC = 280,                    /* SYNC  */
+    CHANNEL = 281,                 /* CHANNEL  */
+    YIELD = 282,                   /* YIELD  */
+    EQ = 283,                      /* EQ  */
+    NEQ = 284,                     /* NEQ  */
+    LEQ = 285,                     /* LEQ  */
+    GEQ = 286,                     /* GEQ  */
+    LT = 287,                      /* LT  */
+    GT = 288,                      /* GT  */
+    LOWER_THAN_ELSE = 289          /* LOWER_THAN_ELSE  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -94,8 +104,12 @@ union YYSTYPE
         struct ASTNode** list;
         int count;
     } node_list;
+    struct {
+        char** ids;
+        int count;
+    } id_list;
 
-#line 99 "parser.tab.h"
+#line 113 "parser.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -21,13 +21,17 @@ void yyerror(const char *s) {
         struct ASTNode** list;
         int count;
     } node_list;
+    struct {
+        char** ids;
+        int count;
+    } id_list;
 }
 
 %token <ival> NUMBER
 %token <fval> FLOATNUM
 %token <id> ID STRING_LITERAL
 
-%token INT FLOAT STRING IF ELSE WHILE FOR PRINT WRITE FUNCTION RETURN
+%token INT FLOAT STRING IF ELSE WHILE FOR PRINT WRITE FUNCTION RETURN VECTOR MAP IN RECORD LAYOUT PARALLEL SPAWN SYNC CHANNEL YIELD
 %token EQ NEQ LEQ GEQ LT GT
 
 %left '+' '-'
@@ -37,7 +41,9 @@ void yyerror(const char *s) {
 %nonassoc ELSE
 
 %type <node> program stmt stmt_list expr func_def func_call return_stmt param_decl
-%type <node_list> param_list param_list_opt arg_list arg_list_opt
+%type <node_list> param_list param_list_opt arg_list arg_list_opt field_list
+%type <id_list> read_list
+%type <ival> value_type
 
 %%
 
@@ -69,9 +75,36 @@ stmt:
       INT ID ';'               { add_symbol($2, NODE_INT); $$ = make_decl_node($2, NODE_INT); }
     | FLOAT ID ';'             { add_symbol($2, NODE_FLOAT); $$ = make_decl_node($2, NODE_FLOAT); }
     | STRING ID ';'            { add_symbol($2, NODE_STRING); $$ = make_decl_node($2, NODE_STRING); }
+    | INT ID '[' NUMBER ']' ';'
+                                { add_array_symbol($2, NODE_INT, $4); $$ = make_array_decl_node($2, NODE_INT, $4); }
+    | FLOAT ID '[' NUMBER ']' ';'
+                                { add_array_symbol($2, NODE_FLOAT, $4); $$ = make_array_decl_node($2, NODE_FLOAT, $4); }
+    | STRING ID '[' NUMBER ']' ';'
+                                { add_array_symbol($2, NODE_STRING, $4); $$ = NULL; }
+    | VECTOR INT ID ';'        { add_vector_symbol($3, NODE_INT); $$ = make_vector_decl_node($3, NODE_INT); }
+    | VECTOR FLOAT ID ';'      { add_vector_symbol($3, NODE_FLOAT); $$ = make_vector_decl_node($3, NODE_FLOAT); }
+    | VECTOR STRING ID ';'     { add_vector_symbol($3, NODE_STRING); $$ = NULL; }
+    | MAP value_type value_type ID ';'
+                                { add_map_symbol($4, (NodeType)$2, (NodeType)$3);
+                                  $$ = make_map_decl_node($4, (NodeType)$2, (NodeType)$3); }
+    | CHANNEL value_type ID '[' NUMBER ']' ';'
+                                { add_channel_symbol($3, (NodeType)$2);
+                                  $$ = make_channel_decl_node($3, (NodeType)$2, $5); }
+    | RECORD ID '{' field_list '}'
+                                { add_record($2, $4.list, $4.count); $$ = NULL; }
+    | ID ID ';'                { add_record_symbol($2, $1, 0, NULL); $$ = make_record_decl_node($2); }
+    | ID ID '[' NUMBER ']' ';'
+                                { add_record_symbol($2, $1, $4, "aos"); $$ = make_record_decl_node($2); }
+    | ID ID '[' NUMBER ']' LAYOUT ID ';'
+                                { add_record_symbol($2, $1, $4, $7); $$ = make_record_decl_node($2); }
+    | ID '[' expr ']' '=' expr ';'
+                                { $$ = make_index_assign_node($1, (ASTNode*)$3, (ASTNode*)$6); }
+    | ID '.' ID '=' expr ';'   { $$ = make_field_assign_node($1, NULL, $3, (ASTNode*)$5); }
+    | ID '[' expr ']' '.' ID '=' expr ';'
+                                { $$ = make_field_assign_node($1, (ASTNode*)$3, $6, (ASTNode*)$8); }
     | ID '=' expr ';'          { $$ = make_assign_node($1, (ASTNode*)$3); }
     | PRINT expr ';'           { $$ = make_print_node((ASTNode*)$2); }
-    | WRITE ID ';'             { $$ = make_read_node($2, -1); }
+    | WRITE read_list ';'      { $$ = make_read_node($2.ids, $2.count, 0); }
     | IF '(' expr ')' stmt %prec LOWER_THAN_ELSE
                                 { $$ = make_if_node((ASTNode*)$3, (ASTNode*)$5, NULL); }
     | IF '(' expr ')' stmt ELSE stmt
@@ -80,10 +113,40 @@ stmt:
     | '{' stmt_list '}'        { $$ = $2; }
     | FOR '(' expr ';' expr ';' expr ')' stmt
                                 { $$ = make_for_node((ASTNode*)$3, (ASTNode*)$5, (ASTNode*)$7, (ASTNode*)$9); }
+    | PARALLEL FOR '(' expr ';' expr ';' expr ')' stmt
+                                { $$ = make_parallel_for_node((ASTNode*)$4, (ASTNode*)$6, (ASTNode*)$8, (ASTNode*)$10); }
+    | FOR '(' ID IN ID ')' stmt
+                                { $$ = make_for_in_node($3, $5, (ASTNode*)$7); }
+    | FOR '(' ID IN ID '(' arg_list_opt ')' ')' stmt
+                                { $$ = make_for_generator_node($3, $5, $7.list, $7.count, (ASTNode*)$10); }
     | func_call ';'            { $$ = $1; }
+    | SPAWN func_call ';'      { $$ = make_spawn_node(NULL, (ASTNode*)$2); }
+    | ID '=' SPAWN func_call ';'
+                                { $$ = make_spawn_node($1, (ASTNode*)$4); }
+    | SYNC ';'                 { $$ = make_sync_node(); }
+    | YIELD expr ';'           { $$ = make_yield_node((ASTNode*)$2); }
     | func_def                 { $$ = NULL; }
     ;
 
+value_type:
+      INT                      { $$ = NODE_INT; }
+    | FLOAT                    { $$ = NODE_FLOAT; }
+    | STRING                   { $$ = NODE_STRING; }
+    ;
+
+field_list
+    : value_type ID ';' {
+        $$.list = malloc(sizeof(ASTNode*) * 1);
+        $$.list[0] = make_decl_node($2, (NodeType)$1);
+        $$.count = 1;
+    }
+    | field_list value_type ID ';' {
+        $1.list = realloc($1.list, sizeof(ASTNode*) * ($1.count + 1));
+        $1.list[$1.count++] = make_decl_node($3, (NodeType)$2);
+        $$ = $1;
+    }
+    ;
+
 func_def:
     FUNCTION ID '(' param_list_opt ')' '{' stmt_list return_stmt '}'
     {
@@ -114,6 +177,21 @@ param_decl
     : INT ID    { $$ = make_decl_node($2, NODE_INT); add_symbol($2, NODE_INT); }
     | FLOAT ID  { $$ = make_decl_node($2, NODE_FLOAT); add_symbol($2, NODE_FLOAT); }
     | STRING ID { $$ = make_decl_node($2, NODE_STRING); add_symbol($2, NODE_STRING); }
+    | CHANNEL value_type ID
+                { $$ = make_channel_param_node($3, (NodeType)$2); }
+    ;
+
+read_list
+    : ID {
+        $$.ids = malloc(sizeof(char*) * 1);
+        $$.ids[0] = $1;
+        $$.count = 1;
+    }
+    | read_list ID {
+        $1.ids = realloc($1.ids, sizeof(char*) * ($1.count + 1));
+        $1.ids[$1.count++] = $2;
+        $$ = $1;
+    }
     ;
 
 return_stmt:
@@ -158,7 +236,12 @@ expr:
     | expr GT expr       { $$ = make_binop_node(">", $1, $3); }
     | ID '=' expr        { $$ = make_assign_node($1, (ASTNode*)$3); }
     | ID '(' arg_list_opt ')' { $$ = make_funccall_node_with_args($1, $3.list, $3.count); }
+    | WRITE read_list    { $$ = make_read_node($2.ids, $2.count, 1); }
     | NUMBER             { $$ = make_int_node($1); }
+    | ID '[' expr ']'    { $$ = make_index_node($1, (ASTNode*)$3); }
+    | ID '.' ID          { $$ = make_field_node($1, NULL, $3); }
+    | ID '[' expr ']' '.' ID
+                         { $$ = make_field_node($1, (ASTNode*)$3, $6); }
     | ID                 { $$ = make_id_node($1); }
     | FLOATNUM           { $$ = make_float_node($1); }
     | STRING_LITERAL     { $$ = make_string_node($1); }
@@ -166,18 +249,35 @@ expr:
 
 %%
 
-int main() {
-    if (yyparse() == 0) {
-        FILE* out = fopen("output.c", "w");
-        fprintf(out, "#include <stdio.h>\n");
-        fprintf(out, "#include <string.h>\n");
-        fprintf(out, "#include <stdlib.h>\n");
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--inline-threshold") == 0 && i + 1 < argc) {
+            inline_threshold = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--inline-threshold=", 19) == 0) {
+            inline_threshold = atoi(argv[i] + 19);
+        } else if (strcmp(argv[i], "--async-input") == 0) {
+            async_input = 1;
+        } else if (strcmp(argv[i], "--eval-budget") == 0 && i + 1 < argc) {
+            eval_budget = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--eval-budget=", 14) == 0) {
+            eval_budget = atoi(argv[i] + 14);
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else {
+            fprintf(stderr, "Error: opción desconocida '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
 
-        generate_all_functions(out);
+    if (yyparse() == 0) {
+        inline_functions(root);
+        analyze_ranges(root);
+        analyze_parallel(root);
+        analyze_effects();
+        evaluate_calls(root);
 
-        fprintf(out, "int main() {\n");
-        generate_code(out, root);
-        fprintf(out, "return 0;\n}\n");
+        FILE* out = fopen("output.c", "w");
+        generate_program(out, root);
         fclose(out);
         printf("Código C generado en output.c\n");
     }
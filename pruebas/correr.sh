@@ -0,0 +1,59 @@
+#!/bin/sh
+# Programas de regresión del compilador.
+# Uso: sh pruebas/correr.sh [nombre]
+# NOMBRE.error: el compilador debe rechazar el programa con un mensaje que contenga ese texto.
+# Si no: el código generado debe compilar sin advertencias con -Wall y, si existe
+# NOMBRE.salida, imprimir exactamente eso (con NOMBRE.entrada como stdin, si existe).
+# NOMBRE.region: pico máximo de la región de temporales en KB (según DPP_REGION_STATS).
+cd "$(dirname "$0")/.."
+ROOT=$(pwd)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+gcc parser.tab.c lex.yy.c ast_c.c generarCodigo.c expandirLlamadas.c analizarRangos.c analizarParalelo.c analizarEfectos.c evaluarLlamadas.c emitirRuntime.c \
+    -o "$TMP/dpp_compiler" -lm || exit 1
+
+failed=0
+for src in pruebas/${1:-*}.dpp; do
+    name=$(basename "$src" .dpp)
+    rm -f "$TMP/output.c"
+    if (cd "$TMP" && ./dpp_compiler < "$ROOT/$src" > /dev/null 2> "$TMP/errores.txt"); then
+        compiled=1
+    else
+        compiled=0
+    fi
+    if [ -f "pruebas/$name.error" ]; then
+        if [ $compiled = 1 ] || ! grep -qF "$(cat "pruebas/$name.error")" "$TMP/errores.txt"; then
+            echo "$name: FALLA (se esperaba el error: $(cat "pruebas/$name.error"))"
+            cat "$TMP/errores.txt"
+            failed=1
+            continue
+        fi
+    else
+        if [ $compiled = 0 ] || ! gcc -Wall -Werror -O2 "$TMP/output.c" -o "$TMP/$name" -lm -pthread; then
+            echo "$name: FALLA (no compila)"
+            cat "$TMP/errores.txt"
+            failed=1
+            continue
+        fi
+        input=/dev/null
+        if [ -f "pruebas/$name.entrada" ]; then input="pruebas/$name.entrada"; fi
+        if [ -f "pruebas/$name.salida" ] && ! "$TMP/$name" < "$input" | cmp -s - "pruebas/$name.salida"; then
+            echo "$name: FALLA (salida distinta de pruebas/$name.salida)"
+            failed=1
+            continue
+        fi
+        if [ -f "pruebas/$name.region" ]; then
+            limit=$(cat "pruebas/$name.region")
+            peak=$(DPP_REGION_STATS=1 "$TMP/$name" < "$input" 2>&1 > /dev/null | sed -n 's/.*pico \([0-9]*\) KB.*/\1/p')
+            if [ "${peak:-0}" -gt "$limit" ]; then
+                echo "$name: FALLA (pico de la región ${peak} KB, máximo $limit KB)"
+                failed=1
+                continue
+            fi
+        fi
+    fi
+    echo "$name: ok"
+done
+exit $failed